@@ -21,13 +21,17 @@
 
 #include <QDir>
 #include <QIcon>
-#include <QMessageBox>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTextStream>
 
+#include "enumerations.h"
 #include "include_var.h"
 
 #include "MacawDebug.h"
 #include "MainWindow.h"
 #include "ServicesManager.h"
+#include "Dialogs/OrphansDialog.h"
 #include "Entities/People.h"
 #include "Entities/Tag.h"
 #include "FetchMetadata/FetchMetadata.h"
@@ -44,6 +48,13 @@ Application::Application(int &argc, char **argv) :
     this->setApplicationVersion(APP_VERSION);
     this->setWindowIcon(QIcon(":/img/logov0_1.png"));
     this->definePaths();
+    m_tmdbUrl = "http://api.themoviedb.org/3";
+    m_benchmarkSize = 0;
+    m_benchmarkDir = NULL;
+
+    // Movies and People are sent from the threads parsing the TMDb replies
+    qRegisterMetaType<Movie>("Movie");
+    qRegisterMetaType<People>("People");
 
     Macaw::DEBUG_OUT("[Application] Initialization done");
 }
@@ -58,16 +69,29 @@ int Application::exec()
     m_mainWindow = new MainWindow;
     m_fetchMetadata = NULL;
 
-    connect(databaseManager, SIGNAL(orphanTagDetected(Tag)),
-            this, SLOT(askForOrphanTagDeletion(Tag)));
-    connect(databaseManager, SIGNAL(orphanPeopleDetected(People)),
-            this, SLOT(askForOrphanPeopleDeletion(People)));
-    connect(m_mainWindow, SIGNAL(startFetchingMetadata(QList<Movie>)),
-            this, SLOT(on_startFetchingMetadata(QList<Movie>)));
+    m_orphansDialog = NULL;
+
+    connect(databaseManager, SIGNAL(orphansDetected(QList<People>,QList<Tag>)),
+            this, SLOT(on_orphansDetected(QList<People>,QList<Tag>)));
+    connect(m_mainWindow, SIGNAL(startFetchingMetadata(QList<Movie>,int)),
+            this, SLOT(on_startFetchingMetadata(QList<Movie>,int)));
+    connect(m_mainWindow, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)),
+            this, SLOT(on_prioritizeFetchingMetadata(QList<int>,int)));
+    connect(m_mainWindow, SIGNAL(reviewFetchingMetadata()),
+            this, SLOT(on_reviewFetchingMetadata()));
     connect(this, SIGNAL(updateMainWindow()),
-            m_mainWindow, SLOT(selfUpdate()));
+            ServicesManager::instance(), SLOT(pannelsUpdate()));
+
+    if (m_benchmarkSize > 0) {
+        this->startBenchmark();
+    } else {
+        m_mainWindow->show();
+    }
 
-    m_mainWindow->show();
+    // Resumes the metadata fetching interrupted during a previous session
+    if (m_benchmarkSize == 0 && databaseManager->existFetchJobs(FETCH_MAX_ATTEMPTS)) {
+        this->on_startFetchingMetadata(QList<Movie>(), Macaw::FetchBackground);
+    }
 
     int l_execVal = QApplication::exec();
 
@@ -81,59 +105,133 @@ int Application::exec()
  */
 Application::~Application()
 {
+    delete m_benchmarkDir;
     Macaw::DEBUG("[Application] Destructed");
 }
 
 /**
- * @brief Slot triggered when DatabaseManager finds an orphan tag.
- * A QMessageBox asks the user if the tag should be delete or not.
+ * @brief Turns the session into a benchmark of the metadata fetching:
+ * `benchmarkSize` movies are fetched in a new database, in a temporary
+ * folder, then the throughput is printed and the application quits.
+ * Must be called before exec(), with a local server (see tools/fetch-bench).
  *
- * @param orphanTag concerned by the choice
+ * @param benchmarkSize: number of movies to fetch
  */
-void Application::askForOrphanTagDeletion(const Tag &orphanTag)
+void Application::setBenchmarkSize(const int benchmarkSize)
 {
-    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+    m_benchmarkSize = benchmarkSize;
+    m_benchmarkDir = new QTemporaryDir;
+    QDir l_benchmarkDir(m_benchmarkDir->path());
+    l_benchmarkDir.mkdir("posters");
+
+    this->setProperty("filesPath", QDir::toNativeSeparators(m_benchmarkDir->path()
+                                                            + QDir::separator()));
+    this->setProperty("postersPath", QDir::toNativeSeparators(l_benchmarkDir.filePath("posters")
+                                                              + QDir::separator()));
+}
 
-    QMessageBox msgBox;
-    msgBox.setIcon(QMessageBox::Question);
-    msgBox.setText(QApplication::tr("The tag <b>%1</b> is not used in any movie now.").arg(orphanTag.name()));
-    msgBox.setInformativeText(tr("Do you want to delete this tag?"));
-    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    msgBox.setDefaultButton(QMessageBox::No);
+/**
+ * @brief Inserts the movies of the benchmark and starts fetching them
+ */
+void Application::startBenchmark()
+{
+    Macaw::DEBUG("[Application] Start the benchmark");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
-    if(msgBox.exec() == QMessageBox::Yes) {
-        databaseManager->deleteTag(orphanTag);
+    QList<Movie> l_movieList;
+    databaseManager->beginTransaction();
+    for (int i = 1 ; i <= m_benchmarkSize ; i++) {
+        Movie l_movie;
+        l_movie.setTitle("Benchmark movie " + QString::number(i));
+        l_movie.setFileRelativePath("benchmark-" + QString::number(i) + ".mkv");
+        l_movie.setSuffix("mkv");
+        if (databaseManager->insertNewMovie(l_movie, 0)) {
+            l_movieList.append(l_movie);
+        }
     }
+    databaseManager->commitTransaction();
+
+    this->on_startFetchingMetadata(QList<Movie>(), Macaw::FetchBackground);
+    connect(m_fetchMetadata, SIGNAL(runFinished(int,qint64)),
+            this, SLOT(on_benchmarkRunFinished(int,qint64)));
+    m_fetchMetadata->addMoviesToQueue(l_movieList, Macaw::FetchBackground);
 }
 
 /**
- * @brief Slot triggered when DatabaseManager finds an orphan person.
- * A QMessageBox asks the user if the person should be delete or not.
+ * @brief Slot triggered at the end of the run of the benchmark.
+ * Prints the throughput and quits.
  *
- * @param orphanPeople concerned by the choice
+ * @param movieCount: number of movies fetched and saved
+ * @param elapsed: duration of the run, in ms
  */
-void Application::askForOrphanPeopleDeletion(const People &orphanPeople)
+void Application::on_benchmarkRunFinished(int movieCount, qint64 elapsed)
 {
-    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+    double l_minutes = elapsed / 60000.0;
+    QTextStream(stdout) << movieCount << " movies in "
+                        << QString::number(elapsed / 1000.0, 'f', 1) << " s: "
+                        << QString::number(l_minutes > 0 ? movieCount / l_minutes : 0, 'f', 1)
+                        << " movies/min" << endl;
+    this->quit();
+}
 
-    QString l_name = orphanPeople.name();
+/**
+ * @brief Slot triggered when DatabaseManager finds orphans at the end of a transaction.
+ * They are deleted at once if the user chose so, else they are listed in
+ * one OrphansDialog, which gathers the orphans found while it is open.
+ *
+ * @param orphanPeopleList: people not linked to any movie anymore
+ * @param orphanTagList: tags not used in any movie anymore
+ */
+void Application::on_orphansDetected(const QList<People> &orphanPeopleList, const QList<Tag> &orphanTagList)
+{
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    if (l_settings.value("orphans/autoCleanup", false).toBool()) {
+        this->deleteOrphans(orphanPeopleList, orphanTagList);
 
-    QMessageBox msgBox;
-    msgBox.setIcon(QMessageBox::Question);
-    msgBox.setText(QApplication::tr("The person <b>%1</b> is not linked to any movie now.").arg(l_name));
-    msgBox.setInformativeText(tr("Do you want to delete it?"));
-    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-    msgBox.setDefaultButton(QMessageBox::No);
+        return;
+    }
 
-    if(msgBox.exec() == QMessageBox::Yes) {
-        databaseManager->deletePeople(orphanPeople);
+    if (m_orphansDialog == NULL) {
+        m_orphansDialog = new OrphansDialog(m_mainWindow);
+        connect(m_orphansDialog, SIGNAL(orphansAccepted(QList<People>,QList<Tag>)),
+                this, SLOT(deleteOrphans(QList<People>,QList<Tag>)));
+        connect(m_orphansDialog, SIGNAL(destroyed()),
+                this, SLOT(on_orphansDialogDestroyed()));
     }
+    m_orphansDialog->addOrphans(orphanPeopleList, orphanTagList);
+    m_orphansDialog->show();
+}
+
+/**
+ * @brief Deletes people and tags in one transaction,
+ * unless they have been linked to a movie since they were found orphan
+ *
+ * @param orphanPeopleList: people to delete
+ * @param orphanTagList: tags to delete
+ */
+void Application::deleteOrphans(const QList<People> &orphanPeopleList, const QList<Tag> &orphanTagList)
+{
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    Macaw::DEBUG("[Application] Delete orphans");
+    databaseManager->deleteOrphans(orphanPeopleList, orphanTagList);
+}
+
+/**
+ * @brief Slot triggered when the OrphansDialog is closed
+ */
+void Application::on_orphansDialogDestroyed()
+{
+    m_orphansDialog = NULL;
 }
 
 /**
  * @brief Slot triggered when the user wants to fetch metadata on the internet
+ *
+ * @param movieList
+ * @param priority of the movies (Macaw::fetchPriority)
  */
-void Application::on_startFetchingMetadata(const QList<Movie> &movieList)
+void Application::on_startFetchingMetadata(const QList<Movie> &movieList, int priority)
 {
     Macaw::DEBUG("[Application] startFetchingMetadata called");
     if(m_fetchMetadata == NULL) {
@@ -141,9 +239,35 @@ void Application::on_startFetchingMetadata(const QList<Movie> &movieList)
         m_fetchMetadata = new FetchMetadata();
         connect(m_fetchMetadata, SIGNAL(jobDone()),
                 this, SLOT(on_fethMetadataJobDone()));
+        connect(m_fetchMetadata, SIGNAL(updatedMovies(QList<int>)),
+                this, SLOT(on_fethMetadataUpdatedMovie()));
+    }
+
+    m_fetchMetadata->addMoviesToQueue(movieList, priority);
+}
+
+/**
+ * @brief Slot triggered when some movies are shown or selected.
+ * If metadata are being fetched, they are fetched first.
+ *
+ * @param idList of the movies
+ * @param priority of the movies (Macaw::fetchPriority)
+ */
+void Application::on_prioritizeFetchingMetadata(const QList<int> &idList, int priority)
+{
+    if (m_fetchMetadata != NULL) {
+        m_fetchMetadata->prioritizeMovies(idList, priority);
     }
+}
 
-    m_fetchMetadata->addMoviesToQueue(movieList);
+/**
+ * @brief Slot triggered when the user wants to review the movies
+ * that could not be matched automatically
+ */
+void Application::on_reviewFetchingMetadata()
+{
+    this->on_startFetchingMetadata(QList<Movie>(), Macaw::FetchBackground);
+    m_fetchMetadata->reviewMovies();
 }
 
 /**
@@ -157,7 +281,7 @@ void Application::on_fethMetadataJobDone()
 }
 
 /**
- * @brief Slot triggered when m_fetchMetadata finished to update a Movie
+ * @brief Slot triggered when m_fetchMetadata saved a batch of movies
  * Updates MainWindow
  */
 void Application::on_fethMetadataUpdatedMovie()
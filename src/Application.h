@@ -24,6 +24,8 @@
 
 class FetchMetadata;
 class MainWindow;
+class OrphansDialog;
+class QTemporaryDir;
 class Movie;
 class People;
 class Tag;
@@ -42,16 +44,23 @@ public:
     ~Application();
     int exec();
     QString tmdbkey() { return m_tmdbkey; }
+    QString tmdbUrl() { return m_tmdbUrl; }
+    void setTmdbUrl(const QString tmdbUrl) { m_tmdbUrl = tmdbUrl; }
+    void setBenchmarkSize(const int benchmarkSize);
 
 signals:
     void updateMainWindow();
 
 private slots:
-    void askForOrphanTagDeletion(const Tag &orphanTag);
-    void askForOrphanPeopleDeletion(const People &orphanPeople);
-    void on_startFetchingMetadata(const QList<Movie> &movieList);
+    void on_orphansDetected(const QList<People> &orphanPeopleList, const QList<Tag> &orphanTagList);
+    void deleteOrphans(const QList<People> &orphanPeopleList, const QList<Tag> &orphanTagList);
+    void on_orphansDialogDestroyed();
+    void on_startFetchingMetadata(const QList<Movie> &movieList, int priority);
+    void on_prioritizeFetchingMetadata(const QList<int> &idList, int priority);
+    void on_reviewFetchingMetadata();
     void on_fethMetadataJobDone();
     void on_fethMetadataUpdatedMovie();
+    void on_benchmarkRunFinished(int movieCount, qint64 elapsed);
 
 private:
 
@@ -62,6 +71,12 @@ private:
      */
     QString m_tmdbkey;
 
+    /**
+     * @brief Base URL of the TMDb API, without trailing slash.
+     * Can be changed with `--tmdb-url` to use a local server.
+     */
+    QString m_tmdbUrl;
+
     /**
      * @brief MainWindow: the widget where everything happens
      */
@@ -72,6 +87,19 @@ private:
      */
     FetchMetadata *m_fetchMetadata;
 
+    /**
+     * @brief Dialog listing the orphans, while it is open
+     */
+    OrphansDialog *m_orphansDialog;
+
+    /**
+     * @brief Number of movies fetched by the benchmark (`--benchmark`),
+     * 0 for a normal session. The benchmark uses a temporary folder.
+     */
+    int m_benchmarkSize;
+    QTemporaryDir *m_benchmarkDir;
+    void startBenchmark();
+
     /**
      * @brief Define the paths used in the app
      */
@@ -0,0 +1,890 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Catalog.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QtAlgorithms>
+
+#include "enumerations.h"
+
+#include "DatabaseManager.h"
+#include "MacawDebug.h"
+#include "Entities/Movie.h"
+
+/**
+ * @brief Returns the condition selecting some ids, or nothing to select all of them.
+ * The ids are integers, so they can be written in the query.
+ *
+ * @param QString column of the ids
+ * @param QList<int> ids to select
+ * @return QString
+ */
+static QString idCondition(const QString column, const QList<int> &idList)
+{
+    if (idList.isEmpty()) {
+
+        return QString();
+    }
+
+    QStringList l_idList;
+    foreach (int l_id, idList) {
+        l_idList.append(QString::number(l_id));
+    }
+
+    return "WHERE " + column + " IN (" + l_idList.join(",") + ") ";
+}
+
+/**
+ * @brief Tells if the offsets of compressed rows are valid: they start at 0,
+ * never decrease and end at the number of links
+ *
+ * @param QVector<int> offsets, one more than the rows
+ * @param int number of links
+ * @return bool
+ */
+static bool validOffsets(const QVector<int> &offsets, const int linkCount)
+{
+    if (offsets.isEmpty() || offsets.first() != 0 || offsets.last() != linkCount) {
+
+        return false;
+    }
+    for (int i = 1 ; i < offsets.size() ; i++) {
+        if (offsets.at(i) < offsets.at(i - 1)) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Catalog::RecordLessThan::operator()(const int left, const int right) const
+{
+    int l_compare = QString::compare(m_records->find(left).value().titleSort,
+                                     m_records->find(right).value().titleSort);
+    if (l_compare != 0) {
+
+        return l_compare < 0;
+    }
+
+    return left < right;
+}
+
+/**
+ * @brief Constructor of an empty catalog
+ */
+Catalog::Catalog()
+{
+    m_peopleOffsets.append(0);
+    m_tagOffsets.append(0);
+}
+
+/**
+ * @brief Loads the whole catalog from the database.
+ * It is meant to run once, in another thread, on its own connection.
+ *
+ * @param QSqlDatabase connection to read
+ * @return bool
+ */
+bool Catalog::load(QSqlDatabase db)
+{
+    QHash<int, Record> l_records;
+    if (!this->reloadPaths(db)
+            || !this->loadNames(db, "people", QList<int>(), m_peopleNames)
+            || !this->loadNames(db, "tags", QList<int>(), m_tagNames)
+            || !this->loadRecords(db, QList<int>(), l_records)) {
+
+        return false;
+    }
+    this->build(l_records);
+
+    return true;
+}
+
+/**
+ * @brief Reads again some movies, with their people and tags.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the movies
+ * @return bool
+ */
+bool Catalog::reloadMovies(QSqlDatabase db, const QList<int> &movieIdList)
+{
+    if (movieIdList.isEmpty()) {
+
+        return true;
+    }
+
+    QHash<int, Record> l_changedRecords;
+    if (!this->loadRecords(db, movieIdList, l_changedRecords)) {
+
+        return false;
+    }
+
+    if (movieIdList.size() <= CATALOG_PATCH_MAX_SIZE) {
+        this->removeRows(movieIdList.toSet());
+        foreach (const Record &l_record, l_changedRecords) {
+            this->insertRow(l_record);
+        }
+
+        return true;
+    }
+
+    QHash<int, Record> l_records = this->records();
+    foreach (int l_id, movieIdList) {
+        l_records.remove(l_id);
+    }
+    l_records.unite(l_changedRecords);
+    this->build(l_records);
+
+    return true;
+}
+
+/**
+ * @brief Reads again the folders of the movies
+ *
+ * @param QSqlDatabase connection to read
+ * @return bool
+ */
+bool Catalog::reloadPaths(QSqlDatabase db)
+{
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    if (!l_query.exec("SELECT id, movies_path FROM path_list")) {
+        Macaw::DEBUG("In Catalog::reloadPaths():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return false;
+    }
+
+    m_moviesPaths.clear();
+    while (l_query.next()) {
+        m_moviesPaths.insert(l_query.value(0).toInt(), l_query.value(1).toString());
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads again the names of some people.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the people
+ * @return bool
+ */
+bool Catalog::reloadPeople(QSqlDatabase db, const QList<int> &peopleIdList)
+{
+    if (peopleIdList.isEmpty()) {
+
+        return true;
+    }
+
+    foreach (int l_id, peopleIdList) {
+        m_peopleNames.remove(l_id);
+    }
+
+    return this->loadNames(db, "people", peopleIdList, m_peopleNames);
+}
+
+/**
+ * @brief Reads again the names of some tags.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the tags
+ * @return bool
+ */
+bool Catalog::reloadTags(QSqlDatabase db, const QList<int> &tagIdList)
+{
+    if (tagIdList.isEmpty()) {
+
+        return true;
+    }
+
+    foreach (int l_id, tagIdList) {
+        m_tagNames.remove(l_id);
+    }
+
+    return this->loadNames(db, "tags", tagIdList, m_tagNames);
+}
+
+/**
+ * @brief Removes a person from the links of the movies
+ *
+ * @param int id of the person
+ */
+void Catalog::removePeople(const int peopleId)
+{
+    m_peopleNames.remove(peopleId);
+    int l_kept = 0;
+    int l_first = 0;
+    for (int l_row = 0 ; l_row < m_ids.size() ; l_row++) {
+        int l_last = m_peopleOffsets.at(l_row + 1);
+        for (int i = l_first ; i < l_last ; i++) {
+            if (m_peopleIds.at(i) != peopleId) {
+                m_peopleIds[l_kept] = m_peopleIds.at(i);
+                m_peopleTypes[l_kept] = m_peopleTypes.at(i);
+                l_kept++;
+            }
+        }
+        l_first = l_last;
+        m_peopleOffsets[l_row + 1] = l_kept;
+    }
+    m_peopleIds.resize(l_kept);
+    m_peopleTypes.resize(l_kept);
+}
+
+/**
+ * @brief Removes a tag from the links of the movies
+ *
+ * @param int id of the tag
+ */
+void Catalog::removeTag(const int tagId)
+{
+    m_tagNames.remove(tagId);
+    int l_kept = 0;
+    int l_first = 0;
+    for (int l_row = 0 ; l_row < m_ids.size() ; l_row++) {
+        int l_last = m_tagOffsets.at(l_row + 1);
+        for (int i = l_first ; i < l_last ; i++) {
+            if (m_tagIds.at(i) != tagId) {
+                m_tagIds[l_kept] = m_tagIds.at(i);
+                l_kept++;
+            }
+        }
+        l_first = l_last;
+        m_tagOffsets[l_row + 1] = l_kept;
+    }
+    m_tagIds.resize(l_kept);
+}
+
+/**
+ * @brief Writes the catalog in a file, read at the next start by loadSnapshot().
+ * The file is replaced at once, so that it is never half written.
+ *
+ * @param QString path of the file
+ * @param int version of the data of the database (config.data_version)
+ * @return bool
+ */
+bool Catalog::saveSnapshot(const QString path, const int dataVersion) const
+{
+    QSaveFile l_file(path);
+    if (!l_file.open(QIODevice::WriteOnly)) {
+        Macaw::DEBUG("In Catalog::saveSnapshot():");
+        Macaw::DEBUG(l_file.errorString());
+
+        return false;
+    }
+
+    QDataStream l_stream(&l_file);
+    l_stream.setVersion(QDataStream::Qt_5_0);
+    l_stream << (quint32)CATALOG_SNAPSHOT_MAGIC
+             << (qint32)CATALOG_SNAPSHOT_FORMAT
+             << (qint32)dataVersion;
+    l_stream << m_moviesPaths << m_peopleNames << m_tagNames;
+    l_stream << m_ids << m_titles << m_titleSorts << m_originalTitles << m_releaseDates
+             << m_pathIds << m_filePaths << m_posterPaths << m_flags;
+    l_stream << m_peopleOffsets << m_peopleIds << m_peopleTypes
+             << m_tagOffsets << m_tagIds;
+
+    if (l_stream.status() != QDataStream::Ok || !l_file.commit()) {
+        Macaw::DEBUG("In Catalog::saveSnapshot():");
+        Macaw::DEBUG(l_file.errorString());
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads the catalog from a file written by saveSnapshot().
+ * The file is mapped in memory rather than read. A file whose columns
+ * or offsets are not consistent is rejected, so that the catalog is
+ * loaded from the database instead. On failure, the catalog is left unchanged.
+ *
+ * @param QString path of the file
+ * @param int version of the data the snapshot was made from, set on success
+ * @return bool
+ */
+bool Catalog::loadSnapshot(const QString path, int &dataVersion)
+{
+    QFile l_file(path);
+    if (!l_file.open(QIODevice::ReadOnly)) {
+
+        return false;
+    }
+    uchar *l_data = l_file.map(0, l_file.size());
+    if (l_data == 0) {
+        Macaw::DEBUG("In Catalog::loadSnapshot():");
+        Macaw::DEBUG(l_file.errorString());
+
+        return false;
+    }
+
+    QByteArray l_bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(l_data),
+                                                 l_file.size());
+    QDataStream l_stream(l_bytes);
+    l_stream.setVersion(QDataStream::Qt_5_0);
+    quint32 l_magic = 0;
+    qint32 l_format = 0;
+    qint32 l_dataVersion = -1;
+    l_stream >> l_magic >> l_format >> l_dataVersion;
+    if (l_magic != CATALOG_SNAPSHOT_MAGIC || l_format != CATALOG_SNAPSHOT_FORMAT) {
+        Macaw::DEBUG("[Catalog] Unknown snapshot format, ignored");
+
+        return false;
+    }
+
+    Catalog l_catalog;
+    l_stream >> l_catalog.m_moviesPaths >> l_catalog.m_peopleNames >> l_catalog.m_tagNames;
+    l_stream >> l_catalog.m_ids >> l_catalog.m_titles
+             >> l_catalog.m_titleSorts >> l_catalog.m_originalTitles
+             >> l_catalog.m_releaseDates >> l_catalog.m_pathIds >> l_catalog.m_filePaths
+             >> l_catalog.m_posterPaths >> l_catalog.m_flags;
+    l_stream >> l_catalog.m_peopleOffsets >> l_catalog.m_peopleIds >> l_catalog.m_peopleTypes
+             >> l_catalog.m_tagOffsets >> l_catalog.m_tagIds;
+
+    int l_size = l_catalog.m_ids.size();
+    if (l_stream.status() != QDataStream::Ok
+            || l_catalog.m_titles.size() != l_size
+            || l_catalog.m_titleSorts.size() != l_size
+            || l_catalog.m_originalTitles.size() != l_size
+            || l_catalog.m_releaseDates.size() != l_size
+            || l_catalog.m_pathIds.size() != l_size
+            || l_catalog.m_filePaths.size() != l_size
+            || l_catalog.m_posterPaths.size() != l_size
+            || l_catalog.m_flags.size() != l_size
+            || l_catalog.m_peopleOffsets.size() != l_size + 1
+            || !validOffsets(l_catalog.m_peopleOffsets, l_catalog.m_peopleIds.size())
+            || l_catalog.m_peopleTypes.size() != l_catalog.m_peopleIds.size()
+            || l_catalog.m_tagOffsets.size() != l_size + 1
+            || !validOffsets(l_catalog.m_tagOffsets, l_catalog.m_tagIds.size())) {
+        Macaw::DEBUG("[Catalog] Corrupted snapshot, ignored");
+
+        return false;
+    }
+
+    for (int i = 0 ; i < l_size ; i++) {
+        l_catalog.m_titles[i] = l_catalog.m_stringPool.intern(l_catalog.m_titles.at(i));
+        l_catalog.m_titleSorts[i] = l_catalog.m_stringPool.intern(l_catalog.m_titleSorts.at(i));
+        l_catalog.m_originalTitles[i] = l_catalog.m_stringPool.intern(l_catalog.m_originalTitles.at(i));
+    }
+
+    *this = l_catalog;
+    dataVersion = l_dataVersion;
+
+    return true;
+}
+
+/**
+ * @brief Returns the rows passing a filter, ordered by the sort key of the title
+ *
+ * @param Filter
+ * @return QVector<int> rows
+ */
+QVector<int> Catalog::select(const Filter &filter) const
+{
+    QVector<int> l_rowVector;
+    for (int l_row = 0 ; l_row < m_ids.size() ; l_row++) {
+        if (this->rowMatches(l_row, filter)) {
+            l_rowVector.append(l_row);
+        }
+    }
+
+    return l_rowVector;
+}
+
+/**
+ * @brief Returns the ids of the movies of some rows
+ *
+ * @param QVector<int> rows
+ * @return QList<int>
+ */
+QList<int> Catalog::ids(const QVector<int> &rowVector) const
+{
+    QList<int> l_idList;
+    l_idList.reserve(rowVector.size());
+    foreach (int l_row, rowVector) {
+        l_idList.append(m_ids.at(l_row));
+    }
+
+    return l_idList;
+}
+
+/**
+ * @brief Returns the movies of some rows, without their people and tags,
+ * as DatabaseManager returns the lists of movies
+ *
+ * @param QVector<int> rows
+ * @return QList<Movie>
+ */
+QList<Movie> Catalog::movies(const QVector<int> &rowVector) const
+{
+    QList<Movie> l_movieList;
+    l_movieList.reserve(rowVector.size());
+    foreach (int l_row, rowVector) {
+        Movie l_movie;
+        l_movie.setId(m_ids.at(l_row));
+        l_movie.setTitle(m_titles.at(l_row));
+        l_movie.setOriginalTitle(m_originalTitles.at(l_row));
+        l_movie.setReleaseDate(m_releaseDates.at(l_row));
+        l_movie.setFileAbsolutePath(m_moviesPaths.value(m_pathIds.at(l_row))
+                                    + QDir::separator()
+                                    + m_filePaths.at(l_row));
+        l_movie.setFileRelativePath(m_filePaths.at(l_row));
+        l_movie.setPosterPath(m_posterPaths.at(l_row));
+        l_movie.setShow(m_flags.at(l_row) & ShowFlag);
+        l_movie.setImported(m_flags.at(l_row) & ImportedFlag);
+        l_movie.setColored(m_flags.at(l_row) & ColoredFlag);
+        l_movieList.append(l_movie);
+    }
+
+    return l_movieList;
+}
+
+/**
+ * @brief Returns the people or the tags linked to some rows.
+ * -1 stands for the rows without any.
+ *
+ * @param QVector<int> rows
+ * @param int Macaw::isPeople or Macaw::isTag
+ * @param int type of the people
+ * @return QSet<int>
+ */
+QSet<int> Catalog::elementIds(const QVector<int> &rowVector,
+                              const int typeElement,
+                              const int peopleType) const
+{
+    QSet<int> l_elementIdSet;
+    foreach (int l_row, rowVector) {
+        bool l_linked = false;
+        if (typeElement == Macaw::isPeople) {
+            for (int i = m_peopleOffsets.at(l_row) ; i < m_peopleOffsets.at(l_row + 1) ; i++) {
+                if (m_peopleTypes.at(i) == peopleType) {
+                    l_elementIdSet.insert(m_peopleIds.at(i));
+                    l_linked = true;
+                }
+            }
+        } else if (typeElement == Macaw::isTag) {
+            for (int i = m_tagOffsets.at(l_row) ; i < m_tagOffsets.at(l_row + 1) ; i++) {
+                l_elementIdSet.insert(m_tagIds.at(i));
+                l_linked = true;
+            }
+        }
+        if (!l_linked) {
+            l_elementIdSet.insert(-1);
+        }
+    }
+
+    return l_elementIdSet;
+}
+
+/**
+ * @brief Reads movies and their links, by batches of CATALOG_BATCH_SIZE
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the movies, or an empty list for all of them
+ * @param QHash<int, Record> records to fill
+ * @return bool
+ */
+bool Catalog::loadRecords(QSqlDatabase db,
+                          const QList<int> &movieIdList,
+                          QHash<int, Record> &records)
+{
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        QList<int> l_batchIdList = movieIdList.mid(i, CATALOG_BATCH_SIZE);
+        l_query.prepare("SELECT id, title, original_title, release_date, id_path, "
+                               "file_path, poster_path, colored, imported, show, title_sort "
+                        "FROM movies "
+                        + idCondition("id", l_batchIdList));
+
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In Catalog::loadRecords():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+
+        QSet<int> l_foundIdSet;
+        while (l_query.next()) {
+            Record l_record;
+            l_record.id = l_query.value(0).toInt();
+            l_record.title = m_stringPool.intern(l_query.value(1).toString());
+            l_record.titleSort = m_stringPool.intern(l_query.value(10).toString());
+            l_record.originalTitle = m_stringPool.intern(l_query.value(2).toString());
+            l_record.releaseDate = QDate::fromString(l_query.value(3).toString(), DATE_FORMAT);
+            l_record.pathId = l_query.value(4).toInt();
+            l_record.filePath = l_query.value(5).toString();
+            l_record.posterPath = l_query.value(6).toString();
+            l_record.flags = 0;
+            if (l_query.value(7).toBool()) {
+                l_record.flags |= ColoredFlag;
+            }
+            if (l_query.value(8).toBool()) {
+                l_record.flags |= ImportedFlag;
+            }
+            if (l_query.value(9).toBool()) {
+                l_record.flags |= ShowFlag;
+            }
+            records.insert(l_record.id, l_record);
+            l_foundIdSet.insert(l_record.id);
+        }
+
+        l_query.prepare("SELECT id_movie, id_people, type "
+                        "FROM movies_people "
+                        + idCondition("id_movie", l_batchIdList));
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In Catalog::loadRecords():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+        while (l_query.next()) {
+            int l_movieId = l_query.value(0).toInt();
+            if (l_foundIdSet.contains(l_movieId)) {
+                Record &l_record = records[l_movieId];
+                l_record.peopleIds.append(l_query.value(1).toInt());
+                l_record.peopleTypes.append(l_query.value(2).toInt());
+            }
+        }
+
+        l_query.prepare("SELECT id_movie, id_tag "
+                        "FROM movies_tags "
+                        + idCondition("id_movie", l_batchIdList));
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In Catalog::loadRecords():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+        while (l_query.next()) {
+            int l_movieId = l_query.value(0).toInt();
+            if (l_foundIdSet.contains(l_movieId)) {
+                records[l_movieId].tagIds.append(l_query.value(1).toInt());
+            }
+        }
+        i += CATALOG_BATCH_SIZE;
+    } while (i < movieIdList.size());
+
+    return true;
+}
+
+/**
+ * @brief Reads the names of some people or tags, by batches of CATALOG_BATCH_SIZE
+ *
+ * @param QSqlDatabase connection to read
+ * @param QString table of the elements, "people" or "tags"
+ * @param QList<int> ids of the elements, or an empty list for all of them
+ * @param QHash<int, QString> names to fill
+ * @return bool
+ */
+bool Catalog::loadNames(QSqlDatabase db,
+                        const QString table,
+                        const QList<int> &idList,
+                        QHash<int, QString> &names)
+{
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        l_query.prepare("SELECT id, name "
+                        "FROM " + table + " "
+                        + idCondition("id", idList.mid(i, CATALOG_BATCH_SIZE)));
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In Catalog::loadNames():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+        while (l_query.next()) {
+            names.insert(l_query.value(0).toInt(), m_stringPool.intern(l_query.value(1).toString()));
+        }
+        i += CATALOG_BATCH_SIZE;
+    } while (i < idList.size());
+
+    return true;
+}
+
+/**
+ * @brief Returns the movies of the columns, to build them again
+ *
+ * @return QHash<int, Record>
+ */
+QHash<int, Catalog::Record> Catalog::records() const
+{
+    QHash<int, Record> l_records;
+    l_records.reserve(m_ids.size());
+    for (int l_row = 0 ; l_row < m_ids.size() ; l_row++) {
+        Record l_record;
+        l_record.id = m_ids.at(l_row);
+        l_record.title = m_titles.at(l_row);
+        l_record.titleSort = m_titleSorts.at(l_row);
+        l_record.originalTitle = m_originalTitles.at(l_row);
+        l_record.releaseDate = m_releaseDates.at(l_row);
+        l_record.pathId = m_pathIds.at(l_row);
+        l_record.filePath = m_filePaths.at(l_row);
+        l_record.posterPath = m_posterPaths.at(l_row);
+        l_record.flags = m_flags.at(l_row);
+        int l_first = m_peopleOffsets.at(l_row);
+        int l_count = m_peopleOffsets.at(l_row + 1) - l_first;
+        l_record.peopleIds = m_peopleIds.mid(l_first, l_count);
+        l_record.peopleTypes = m_peopleTypes.mid(l_first, l_count);
+        l_first = m_tagOffsets.at(l_row);
+        l_count = m_tagOffsets.at(l_row + 1) - l_first;
+        l_record.tagIds = m_tagIds.mid(l_first, l_count);
+        l_records.insert(l_record.id, l_record);
+    }
+
+    return l_records;
+}
+
+/**
+ * @brief Fills the columns with some movies, ordered by the sort key of the title
+ *
+ * @param QHash<int, Record> movies by id
+ */
+void Catalog::build(const QHash<int, Record> &records)
+{
+    QList<int> l_idList = records.keys();
+    qSort(l_idList.begin(), l_idList.end(), RecordLessThan(&records));
+
+    int l_size = l_idList.size();
+    m_ids.resize(l_size);
+    m_titles.resize(l_size);
+    m_titleSorts.resize(l_size);
+    m_originalTitles.resize(l_size);
+    m_releaseDates.resize(l_size);
+    m_pathIds.resize(l_size);
+    m_filePaths.resize(l_size);
+    m_posterPaths.resize(l_size);
+    m_flags.resize(l_size);
+    m_peopleOffsets.resize(l_size + 1);
+    m_peopleIds.clear();
+    m_peopleTypes.clear();
+    m_tagOffsets.resize(l_size + 1);
+    m_tagIds.clear();
+
+    m_peopleOffsets[0] = 0;
+    m_tagOffsets[0] = 0;
+    for (int l_row = 0 ; l_row < l_size ; l_row++) {
+        const Record &l_record = records.find(l_idList.at(l_row)).value();
+        m_ids[l_row] = l_record.id;
+        m_titles[l_row] = l_record.title;
+        m_titleSorts[l_row] = l_record.titleSort;
+        m_originalTitles[l_row] = l_record.originalTitle;
+        m_releaseDates[l_row] = l_record.releaseDate;
+        m_pathIds[l_row] = l_record.pathId;
+        m_filePaths[l_row] = l_record.filePath;
+        m_posterPaths[l_row] = l_record.posterPath;
+        m_flags[l_row] = l_record.flags;
+        m_peopleIds += l_record.peopleIds;
+        m_peopleTypes += l_record.peopleTypes;
+        m_peopleOffsets[l_row + 1] = m_peopleIds.size();
+        m_tagIds += l_record.tagIds;
+        m_tagOffsets[l_row + 1] = m_tagIds.size();
+    }
+}
+
+/**
+ * @brief Removes the rows of some movies, with their links
+ *
+ * @param QSet<int> ids of the movies
+ */
+void Catalog::removeRows(const QSet<int> &movieIdSet)
+{
+    int l_kept = 0;
+    int l_keptPeople = 0;
+    int l_keptTags = 0;
+    for (int l_row = 0 ; l_row < m_ids.size() ; l_row++) {
+        int l_firstPeople = m_peopleOffsets.at(l_row);
+        int l_lastPeople = m_peopleOffsets.at(l_row + 1);
+        int l_firstTag = m_tagOffsets.at(l_row);
+        int l_lastTag = m_tagOffsets.at(l_row + 1);
+        if (movieIdSet.contains(m_ids.at(l_row))) {
+            continue;
+        }
+
+        m_ids[l_kept] = m_ids.at(l_row);
+        m_titles[l_kept] = m_titles.at(l_row);
+        m_titleSorts[l_kept] = m_titleSorts.at(l_row);
+        m_originalTitles[l_kept] = m_originalTitles.at(l_row);
+        m_releaseDates[l_kept] = m_releaseDates.at(l_row);
+        m_pathIds[l_kept] = m_pathIds.at(l_row);
+        m_filePaths[l_kept] = m_filePaths.at(l_row);
+        m_posterPaths[l_kept] = m_posterPaths.at(l_row);
+        m_flags[l_kept] = m_flags.at(l_row);
+        for (int i = l_firstPeople ; i < l_lastPeople ; i++) {
+            m_peopleIds[l_keptPeople] = m_peopleIds.at(i);
+            m_peopleTypes[l_keptPeople] = m_peopleTypes.at(i);
+            l_keptPeople++;
+        }
+        for (int i = l_firstTag ; i < l_lastTag ; i++) {
+            m_tagIds[l_keptTags] = m_tagIds.at(i);
+            l_keptTags++;
+        }
+        l_kept++;
+        m_peopleOffsets[l_kept] = l_keptPeople;
+        m_tagOffsets[l_kept] = l_keptTags;
+    }
+
+    m_ids.resize(l_kept);
+    m_titles.resize(l_kept);
+    m_titleSorts.resize(l_kept);
+    m_originalTitles.resize(l_kept);
+    m_releaseDates.resize(l_kept);
+    m_pathIds.resize(l_kept);
+    m_filePaths.resize(l_kept);
+    m_posterPaths.resize(l_kept);
+    m_flags.resize(l_kept);
+    m_peopleOffsets.resize(l_kept + 1);
+    m_peopleIds.resize(l_keptPeople);
+    m_peopleTypes.resize(l_keptPeople);
+    m_tagOffsets.resize(l_kept + 1);
+    m_tagIds.resize(l_keptTags);
+}
+
+/**
+ * @brief Inserts the row of a movie at its place in the order of the titles
+ *
+ * @param Record movie to insert
+ */
+void Catalog::insertRow(const Record &record)
+{
+    int l_row = this->rowPosition(record.titleSort, record.id);
+    m_ids.insert(l_row, record.id);
+    m_titles.insert(l_row, record.title);
+    m_titleSorts.insert(l_row, record.titleSort);
+    m_originalTitles.insert(l_row, record.originalTitle);
+    m_releaseDates.insert(l_row, record.releaseDate);
+    m_pathIds.insert(l_row, record.pathId);
+    m_filePaths.insert(l_row, record.filePath);
+    m_posterPaths.insert(l_row, record.posterPath);
+    m_flags.insert(l_row, record.flags);
+
+    // The links of the row go before the ones of the next rows,
+    // whose offsets are shifted by their number
+    int l_first = m_peopleOffsets.at(l_row);
+    for (int i = 0 ; i < record.peopleIds.size() ; i++) {
+        m_peopleIds.insert(l_first + i, record.peopleIds.at(i));
+        m_peopleTypes.insert(l_first + i, record.peopleTypes.at(i));
+    }
+    m_peopleOffsets.insert(l_row + 1, l_first);
+    for (int i = l_row + 1 ; i < m_peopleOffsets.size() ; i++) {
+        m_peopleOffsets[i] += record.peopleIds.size();
+    }
+
+    l_first = m_tagOffsets.at(l_row);
+    for (int i = 0 ; i < record.tagIds.size() ; i++) {
+        m_tagIds.insert(l_first + i, record.tagIds.at(i));
+    }
+    m_tagOffsets.insert(l_row + 1, l_first);
+    for (int i = l_row + 1 ; i < m_tagOffsets.size() ; i++) {
+        m_tagOffsets[i] += record.tagIds.size();
+    }
+}
+
+/**
+ * @brief Returns the row where a movie goes, in the order of RecordLessThan
+ *
+ * @param QString sort key of the title
+ * @param int id of the movie
+ * @return int
+ */
+int Catalog::rowPosition(const QString &titleSort, const int id) const
+{
+    int l_first = 0;
+    int l_last = m_ids.size();
+    while (l_first < l_last) {
+        int l_middle = (l_first + l_last) / 2;
+        int l_compare = QString::compare(m_titleSorts.at(l_middle), titleSort);
+        if (l_compare < 0 || (l_compare == 0 && m_ids.at(l_middle) < id)) {
+            l_first = l_middle + 1;
+        } else {
+            l_last = l_middle;
+        }
+    }
+
+    return l_first;
+}
+
+/**
+ * @brief Tells if a row passes a filter
+ *
+ * @param int row
+ * @param Filter
+ * @return bool
+ */
+bool Catalog::rowMatches(const int row, const Filter &filter) const
+{
+    if (filter.show != -1 && ((m_flags.at(row) & ShowFlag) != 0) != (filter.show != 0)) {
+
+        return false;
+    }
+
+    if (filter.elementId != 0) {
+        bool l_linked = false;
+        bool l_found = false;
+        if (filter.typeElement == Macaw::isPeople) {
+            for (int i = m_peopleOffsets.at(row) ; i < m_peopleOffsets.at(row + 1) ; i++) {
+                if (m_peopleTypes.at(i) == filter.peopleType) {
+                    l_linked = true;
+                    l_found |= m_peopleIds.at(i) == filter.elementId;
+                }
+            }
+        } else if (filter.typeElement == Macaw::isTag) {
+            for (int i = m_tagOffsets.at(row) ; i < m_tagOffsets.at(row + 1) ; i++) {
+                l_linked = true;
+                l_found |= m_tagIds.at(i) == filter.elementId;
+            }
+        } else {
+
+            return false;
+        }
+        if (filter.elementId == -1 ? l_linked : !l_found) {
+
+            return false;
+        }
+    }
+
+    int l_id = m_ids.at(row);
+    if (filter.matchingIdSet != 0 && !filter.matchingIdSet->contains(l_id)) {
+
+        return false;
+    }
+    if (filter.toWatchIdSet != 0 && !filter.toWatchIdSet->contains(l_id)) {
+
+        return false;
+    }
+
+    return true;
+}
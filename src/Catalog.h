@@ -0,0 +1,180 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+#include "StringPool.h"
+
+class Movie;
+
+/**
+ * @brief In-memory copy of the library, answering the filters of the pannels
+ * without going through SQLite, which stays the reference.
+ *
+ * The movies are stored column by column, one row per movie, the rows being
+ * ordered by the sort key of their title (movies.title_sort): a filter is a
+ * scan of a few columns, and its result comes sorted. The people and the tags
+ * of the movies are stored in compressed rows: the links of the row r are at
+ * [offsets[r], offsets[r+1]).
+ *
+ * The titles, their sort keys and the names are interned, so that the
+ * equal ones share their data. A few changed movies are patched in place; more of them
+ * rebuild the columns.
+ *
+ * The names of the people and of the tags are kept too, to fill the left
+ * pannel.
+ *
+ * The catalog is loaded once with load(), or from a snapshot file written
+ * by saveSnapshot(), and then kept up to date with reload*() and remove*().
+ * It is not thread safe.
+ */
+class Catalog
+{
+    #define CATALOG_BATCH_SIZE 500
+    #define CATALOG_PATCH_MAX_SIZE 100
+    #define CATALOG_SNAPSHOT_MAGIC 0x4d435443
+    #define CATALOG_SNAPSHOT_FORMAT 2
+public:
+    enum flags {
+        ShowFlag = 0x1,
+        ImportedFlag = 0x2,
+        ColoredFlag = 0x4
+    };
+
+    /**
+     * @brief Selection of movies: kind, element of the left pannel,
+     * and optional sets the movies must belong to
+     */
+    struct Filter {
+        Filter() :
+            show(-1),
+            typeElement(0),
+            elementId(0),
+            peopleType(0),
+            matchingIdSet(0),
+            toWatchIdSet(0)
+        {}
+
+        int show;                           // Macaw::movieOrShow, -1 for both
+        int typeElement;                    // Macaw::typeElement
+        int elementId;                      // 0 for all, -1 for none
+        int peopleType;                     // People::typePeople
+        const QSet<int> *matchingIdSet;     // 0 to ignore
+        const QSet<int> *toWatchIdSet;      // 0 to ignore
+    };
+
+    Catalog();
+    bool load(QSqlDatabase db);
+    bool reloadMovies(QSqlDatabase db, const QList<int> &movieIdList);
+    bool reloadPaths(QSqlDatabase db);
+    bool reloadPeople(QSqlDatabase db, const QList<int> &peopleIdList);
+    bool reloadTags(QSqlDatabase db, const QList<int> &tagIdList);
+    void removePeople(const int peopleId);
+    void removeTag(const int tagId);
+    bool saveSnapshot(const QString path, const int dataVersion) const;
+    bool loadSnapshot(const QString path, int &dataVersion);
+    QVector<int> select(const Filter &filter) const;
+    QList<int> ids(const QVector<int> &rowVector) const;
+    QList<Movie> movies(const QVector<int> &rowVector) const;
+    QString peopleName(const int peopleId) const { return m_peopleNames.value(peopleId); }
+    QString tagName(const int tagId) const { return m_tagNames.value(tagId); }
+    QSet<int> elementIds(const QVector<int> &rowVector,
+                         const int typeElement,
+                         const int peopleType) const;
+
+private:
+    /**
+     * @brief A movie while the columns are built
+     */
+    struct Record {
+        int id;
+        QString title;
+        QString titleSort;
+        QString originalTitle;
+        QDate releaseDate;
+        int pathId;
+        QString filePath;
+        QString posterPath;
+        quint8 flags;
+        QVector<int> peopleIds;
+        QVector<int> peopleTypes;
+        QVector<int> tagIds;
+    };
+
+    /**
+     * @brief Orders the records like the database does with `ORDER BY title_sort`
+     */
+    class RecordLessThan
+    {
+    public:
+        explicit RecordLessThan(const QHash<int, Record> *records) : m_records(records) {}
+        bool operator()(const int left, const int right) const;
+
+    private:
+        const QHash<int, Record> *m_records;
+    };
+
+    bool loadRecords(QSqlDatabase db,
+                     const QList<int> &movieIdList,
+                     QHash<int, Record> &records);
+    bool loadNames(QSqlDatabase db,
+                   const QString table,
+                   const QList<int> &idList,
+                   QHash<int, QString> &names);
+    QHash<int, Record> records() const;
+    void build(const QHash<int, Record> &records);
+    void removeRows(const QSet<int> &movieIdSet);
+    void insertRow(const Record &record);
+    int rowPosition(const QString &titleSort, const int id) const;
+    bool rowMatches(const int row, const Filter &filter) const;
+
+    QHash<int, QString> m_moviesPaths;
+    QHash<int, QString> m_peopleNames;
+    QHash<int, QString> m_tagNames;
+    StringPool m_stringPool;
+
+    // Columns, one row per movie
+    QVector<int> m_ids;
+    QVector<QString> m_titles;
+    QVector<QString> m_titleSorts;
+    QVector<QString> m_originalTitles;
+    QVector<QDate> m_releaseDates;
+    QVector<int> m_pathIds;
+    QVector<QString> m_filePaths;
+    QVector<QString> m_posterPaths;
+    QVector<quint8> m_flags;
+
+    // Links of the rows
+    QVector<int> m_peopleOffsets;
+    QVector<int> m_peopleIds;
+    QVector<int> m_peopleTypes;
+    QVector<int> m_tagOffsets;
+    QVector<int> m_tagIds;
+};
+
+#endif // CATALOG_H
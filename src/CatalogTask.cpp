@@ -0,0 +1,88 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "CatalogTask.h"
+
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "Catalog.h"
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param databasePath: file of the database
+ * @param catalog to load
+ * @param snapshotDataVersion: data version of the shown snapshot, -1 if none
+ */
+CatalogTask::CatalogTask(const QString databasePath,
+                         Catalog *catalog,
+                         const int snapshotDataVersion) :
+    m_databasePath(databasePath),
+    m_catalog(catalog),
+    m_snapshotDataVersion(snapshotDataVersion)
+{
+}
+
+/**
+ * @brief Checks the snapshot, or loads the catalog and tells if it succeeded
+ */
+void CatalogTask::run()
+{
+    QString l_connectionName = "catalog";
+    bool l_succeeded = false;
+    bool l_upToDate = false;
+    {
+        QSqlDatabase l_db = QSqlDatabase::addDatabase("QSQLITE", l_connectionName);
+        l_db.setDatabaseName(m_databasePath);
+        l_db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=1000");
+
+        if (!l_db.open()) {
+            Macaw::DEBUG("In CatalogTask::run():");
+            Macaw::DEBUG(l_db.lastError().text());
+        } else if (m_snapshotDataVersion >= 0) {
+            QSqlQuery l_query(l_db);
+            l_upToDate = l_query.exec("SELECT data_version FROM config")
+                    && l_query.next()
+                    && l_query.value(0).toInt() == m_snapshotDataVersion;
+        }
+
+        if (l_db.isOpen() && !l_upToDate) {
+            QElapsedTimer l_timer;
+            l_timer.start();
+            l_succeeded = m_catalog->load(l_db);
+            Macaw::DEBUG("[CatalogTask] Catalog loaded in "
+                         + QString::number(l_timer.elapsed()) + " ms");
+        }
+        l_db.close();
+    }
+    QSqlDatabase::removeDatabase(l_connectionName);
+
+    if (l_upToDate) {
+        emit catalogUpToDate();
+    } else {
+        emit catalogBuilt(l_succeeded);
+    }
+}
@@ -0,0 +1,61 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef CATALOGTASK_H
+#define CATALOGTASK_H
+
+#include <QObject>
+#include <QRunnable>
+
+class Catalog;
+
+/**
+ * @brief Loads a Catalog in a thread of a QThreadPool,
+ * on its own connection to the database.
+ *
+ * The catalog belongs to the caller, which must not use it
+ * before catalogBuilt() is received.
+ *
+ * When a snapshot of the catalog is already shown, its data version is
+ * given: if the database has not changed since, catalogUpToDate() is sent
+ * instead and the catalog is not loaded.
+ */
+class CatalogTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit CatalogTask(const QString databasePath,
+                         Catalog *catalog,
+                         const int snapshotDataVersion = -1);
+    void run();
+
+signals:
+    void catalogBuilt(bool succeeded);
+    void catalogUpToDate();
+
+private:
+    QString m_databasePath;
+    Catalog *m_catalog;
+    int m_snapshotDataVersion;
+};
+
+#endif // CATALOGTASK_H
@@ -21,14 +21,18 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QPair>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
+#include <QStringList>
 #include <QVariant>
 
+#include "enumerations.h"
 #include "include_var.h"
 
 #include "MacawDebug.h"
+#include "SortKey.h"
 #include "Entities/Episode.h"
 #include "Entities/Movie.h"
 #include "Entities/PathForMovies.h"
@@ -79,11 +83,35 @@ DatabaseManager::DatabaseManager()
     m_tagFields = "t.id, "
                   "t.name ";
 
+    m_transactionDepth = 0;
+    m_transactionFailed = false;
+
+    m_movieCache.setMaxCost(ENTITY_CACHE_SIZE);
+    m_peopleCache.setMaxCost(ENTITY_CACHE_SIZE);
+    m_tagCache.setMaxCost(ENTITY_CACHE_SIZE);
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+
     openDB();
     createTables();
     Macaw::DEBUG("[DatabaseManager] object created");
 }
 
+/**
+ * @brief Logs how often the elements read by id were found in the caches,
+ * and the memory released by the string pool.
+ * Called at the end of each fetch run and when the application quits.
+ */
+void DatabaseManager::logStatistics() const
+{
+    Macaw::DEBUG(QString("[DatabaseManager] Cache hits: %1, misses: %2")
+                 .arg(this->cacheHits())
+                 .arg(this->cacheMisses()));
+    Macaw::DEBUG(QString("[DatabaseManager] Interned strings: %1, memory released: %2 kB")
+                 .arg(m_stringPool.size())
+                 .arg(m_stringPool.releasedBytes() / 1024));
+}
+
 /**
  * @brief Hydrates a movie from the database and all the corresponding lists
  *
@@ -112,7 +140,7 @@ Movie DatabaseManager::hydrateMovieOnly(QSqlQuery &query)
     l_movie.setTitle(query.value(1).toString());
     l_movie.setOriginalTitle(query.value(2).toString());
     l_movie.setReleaseDate(QDate::fromString(query.value(3).toString(), DATE_FORMAT));
-    l_movie.setCountry(query.value(4).toString());
+    l_movie.setCountry(m_stringPool.intern(query.value(4).toString()));
     l_movie.setDuration(QTime::fromMSecsSinceStartOfDay(query.value(5).toInt()));
     l_movie.setSynopsis(query.value(6).toString());
     l_movie.setFileAbsolutePath(getMoviesPathById(query.value(7).toInt())
@@ -121,8 +149,8 @@ Movie DatabaseManager::hydrateMovieOnly(QSqlQuery &query)
     l_movie.setFileRelativePath(query.value(8).toString());
     l_movie.setPosterPath(query.value(9).toString());
     l_movie.setColored(query.value(10).toBool());
-    l_movie.setFormat(query.value(12).toString());
-    l_movie.setSuffix(query.value(13).toString());
+    l_movie.setFormat(m_stringPool.intern(query.value(12).toString()));
+    l_movie.setSuffix(m_stringPool.intern(query.value(13).toString()));
     l_movie.setRank(query.value(14).toInt());
     l_movie.setImported(query.value(14).toBool());
     l_movie.setTmdbId(query.value(15).toInt());
@@ -146,7 +174,7 @@ Episode DatabaseManager::hydrateEpisode(QSqlQuery &query)
 
     Show l_show;
     l_show.setId(query.value(5).toInt());
-    l_show.setName(query.value(6).toString());
+    l_show.setName(m_stringPool.intern(query.value(6).toString()));
     l_show.setFinished(query.value(7).toBool());
     l_episode.setShow(l_show);
 
@@ -170,7 +198,7 @@ Episode DatabaseManager::hydrateEpisode(QSqlQuery &query, const Movie &movie)
 
     Show l_show;
     l_show.setId(query.value(5).toInt());
-    l_show.setName(query.value(6).toString());
+    l_show.setName(m_stringPool.intern(query.value(6).toString()));
     l_show.setFinished(query.value(7).toBool());
     l_episode.setShow(l_show);
 
@@ -189,7 +217,7 @@ Show DatabaseManager::hydrateShow(QSqlQuery &query)
 {
     Show l_show;
     l_show.setId(query.value(0).toInt());
-    l_show.setName(query.value(1).toString());
+    l_show.setName(m_stringPool.intern(query.value(1).toString()));
     l_show.setFinished(query.value(2).toBool());
 
     return l_show;
@@ -205,7 +233,7 @@ People DatabaseManager::hydratePeople(QSqlQuery &query)
 {
     People l_people;
     l_people.setId(query.value(0).toInt());
-    l_people.setName(query.value(1).toString());
+    l_people.setName(m_stringPool.intern(query.value(1).toString()));
     l_people.setBirthday(QDate::fromString(query.value(2).toString(), DATE_FORMAT));
     l_people.setBiography(query.value(3).toString());
     l_people.setImported(query.value(4).toBool());
@@ -229,7 +257,7 @@ Tag DatabaseManager::hydrateTag(QSqlQuery &query)
 {
     Tag l_tag;
     l_tag.setId(query.value(0).toInt());
-    l_tag.setName(query.value(1).toString());
+    l_tag.setName(m_stringPool.intern(query.value(1).toString()));
 
     return l_tag;
 }
@@ -301,6 +329,245 @@ bool DatabaseManager::closeDB()
     return true;
 }
 
+/**
+ * @brief Starts a transaction.
+ * Transactions can be nested: only the outermost one reaches the database,
+ * so that a batch of changes is written at once.
+ *
+ * @return bool
+ */
+bool DatabaseManager::beginTransaction()
+{
+    if (m_transactionDepth == 0)
+    {
+        if (!m_db.transaction())
+        {
+            Macaw::DEBUG("In beginTransaction():");
+            Macaw::DEBUG(m_db.lastError().text());
+
+            return false;
+        }
+        m_transactionFailed = false;
+    }
+    m_transactionDepth++;
+
+    return true;
+}
+
+/**
+ * @brief Commits a transaction started with beginTransaction().
+ * If an inner transaction was rolled back, the outermost one is rolled back too.
+ *
+ * @return bool
+ */
+bool DatabaseManager::commitTransaction()
+{
+    if (m_transactionDepth == 0)
+    {
+        return false;
+    }
+    m_transactionDepth--;
+    if (m_transactionDepth > 0)
+    {
+        return true;
+    }
+
+    if (m_transactionFailed)
+    {
+        m_db.rollback();
+        m_pendingChanges.clear();
+        m_orphanPeopleCandidates.clear();
+        m_orphanTagCandidates.clear();
+        clearCaches();
+
+        return false;
+    }
+    if ((!m_pendingChanges.isEmpty() && !bumpDataVersion()) || !m_db.commit())
+    {
+        Macaw::DEBUG("In commitTransaction():");
+        Macaw::DEBUG(m_db.lastError().text());
+        m_db.rollback();
+        m_pendingChanges.clear();
+        m_orphanPeopleCandidates.clear();
+        m_orphanTagCandidates.clear();
+        clearCaches();
+
+        return false;
+    }
+    emitChanges();
+    sweepOrphans();
+
+    return true;
+}
+
+/**
+ * @brief Rolls back a transaction started with beginTransaction()
+ *
+ * @return bool
+ */
+bool DatabaseManager::rollbackTransaction()
+{
+    if (m_transactionDepth == 0)
+    {
+        return false;
+    }
+    m_transactionDepth--;
+    m_transactionFailed = true;
+    if (m_transactionDepth > 0)
+    {
+        return true;
+    }
+    m_pendingChanges.clear();
+    m_orphanPeopleCandidates.clear();
+    m_orphanTagCandidates.clear();
+    clearCaches();
+
+    return m_db.rollback();
+}
+
+/**
+ * @brief Records that an element has been inserted, updated or deleted.
+ * Outside of a transaction the change is signaled at once, else it waits
+ * for the outermost commit, merged with the other changes of the transaction.
+ *
+ * @param int type of the element (Macaw::typeElement)
+ * @param int change (Macaw::changeType)
+ * @param int id of the element
+ */
+void DatabaseManager::recordChange(const int type, const int change, const int id)
+{
+    invalidateCaches(type, id);
+
+    ChangeSet &l_changes = m_pendingChanges[type];
+    switch (change)
+    {
+    case Macaw::Inserted:
+        if (l_changes.deleted.remove(id)) {
+            l_changes.updated.insert(id);
+        } else {
+            l_changes.inserted.insert(id);
+        }
+        break;
+    case Macaw::Updated:
+        if (!l_changes.inserted.contains(id)) {
+            l_changes.updated.insert(id);
+        }
+        break;
+    case Macaw::Deleted:
+        l_changes.updated.remove(id);
+        if (!l_changes.inserted.remove(id)) {
+            l_changes.deleted.insert(id);
+        }
+        break;
+    }
+
+    if (m_transactionDepth == 0) {
+        bumpDataVersion();
+        emitChanges();
+    }
+}
+
+/**
+ * @brief Drops an element from the caches.
+ * The movies hold their people and tags, and the absolute path of their
+ * file, so a change on a person, a tag or a folder drops all the movies.
+ *
+ * @param int type of the element (Macaw::typeElement)
+ * @param int id of the element
+ */
+void DatabaseManager::invalidateCaches(const int type, const int id)
+{
+    switch (type)
+    {
+    case Macaw::isMovie:
+        m_movieCache.remove(id);
+        break;
+    case Macaw::isPeople:
+        m_peopleCache.remove(id);
+        m_movieCache.clear();
+        break;
+    case Macaw::isTag:
+        m_tagCache.remove(id);
+        m_movieCache.clear();
+        break;
+    case Macaw::isMoviesPath:
+        m_movieCache.clear();
+        break;
+    }
+}
+
+/**
+ * @brief Empties the caches of movies, people and tags.
+ * To be called when the database is changed without recording it,
+ * or when a transaction is rolled back.
+ */
+void DatabaseManager::clearCaches()
+{
+    m_movieCache.clear();
+    m_peopleCache.clear();
+    m_tagCache.clear();
+}
+
+/**
+ * @brief Signals the recorded changes and forgets them
+ */
+void DatabaseManager::emitChanges()
+{
+    // The receivers may write in the database again
+    QHash<int, ChangeSet> l_changesHash = m_pendingChanges;
+    m_pendingChanges.clear();
+
+    QHashIterator<int, ChangeSet> l_iterator(l_changesHash);
+    while (l_iterator.hasNext()) {
+        l_iterator.next();
+        QList<int> l_insertedIdList = l_iterator.value().inserted.toList();
+        QList<int> l_updatedIdList = l_iterator.value().updated.toList();
+        QList<int> l_deletedIdList = l_iterator.value().deleted.toList();
+        if (l_insertedIdList.isEmpty() && l_updatedIdList.isEmpty() && l_deletedIdList.isEmpty()) {
+            continue;
+        }
+
+        switch (l_iterator.key())
+        {
+        case Macaw::isMovie:
+            emit moviesChanged(l_insertedIdList, l_updatedIdList, l_deletedIdList);
+            break;
+        case Macaw::isPeople:
+            emit peopleChanged(l_insertedIdList, l_updatedIdList, l_deletedIdList);
+            break;
+        case Macaw::isTag:
+            emit tagsChanged(l_insertedIdList, l_updatedIdList, l_deletedIdList);
+            break;
+        case Macaw::isPlaylist:
+            emit playlistsChanged(l_insertedIdList, l_updatedIdList, l_deletedIdList);
+            break;
+        case Macaw::isMoviesPath:
+            emit moviesPathsChanged(l_insertedIdList, l_updatedIdList, l_deletedIdList);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Increments the version of the data, which tells the copies
+ * made outside the database (the snapshot of the catalog) that they are stale.
+ * Called before the changes are committed.
+ *
+ * @return bool
+ */
+bool DatabaseManager::bumpDataVersion()
+{
+    QSqlQuery l_query(m_db);
+    if (!l_query.exec("UPDATE config SET data_version = data_version + 1")) {
+        Macaw::DEBUG("In bumpDataVersion():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Deletes the database.
  *
@@ -468,24 +735,155 @@ bool DatabaseManager::upgradeDB(int fromVersion, int toVersion)
                                       "SET db_version = 050");
                 l_fromVersion = 050;
             } else {
-                m_db.close();
+                this->restoreBackup();
+            }
+            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v050");
+        }
+
+        //switch to DB_VERSION 051
+        if (toVersion >= 51 && l_ret) {
+
+            Macaw::DEBUG_IN("[DatabaseManager] upgrade to v051");
+
+            // People fetched from TMDb are now identified by their TMDb id.
+            // Duplicates are merged into the oldest entry before adding the unique index.
+            l_ret &= l_query.exec("UPDATE movies_people "
+                                  "SET id_people = (SELECT MIN(p2.id) "
+                                                   "FROM people AS p1, people AS p2 "
+                                                   "WHERE p1.id = movies_people.id_people "
+                                                     "AND p2.id_tmdb = p1.id_tmdb) "
+                                  "WHERE id_people IN (SELECT id FROM people WHERE id_tmdb > 0)");
+            l_ret &= l_query.exec("DELETE FROM people "
+                                  "WHERE id_tmdb > 0 "
+                                    "AND id NOT IN (SELECT MIN(id) FROM people "
+                                                   "WHERE id_tmdb > 0 GROUP BY id_tmdb)");
+            l_ret &= l_query.exec("DELETE FROM movies_people "
+                                  "WHERE id_people NOT IN (SELECT id FROM people)");
+            if(!l_ret)
+            {
+                Macaw::DEBUG(l_query.lastError().text());
+            }
+            l_ret &= createIndexPeopleTmdbId(l_query);
 
-                Macaw::DEBUG_IN("[DatabaseManager] FAILED => Come back to backup");
-                QDir l_backups = m_db.databaseName();
-                l_backups.cdUp();
-                QStringList l_backupNameList = l_backups.entryList(QDir::Files|QDir::NoDotAndDotDot,
-                                                                   QDir::Name);
-                Macaw::DEBUG("Return to "+l_backupNameList.last());
+            if(l_ret) {
+                l_ret &= l_query.exec("UPDATE config "
+                                      "SET db_version = 51");
+                l_fromVersion = 51;
+            } else {
+                this->restoreBackup();
+            }
+            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v051");
+        }
 
-                this->deleteDB();
-                QFile::copy(l_backups.absolutePath()+QDir::separator()+l_backupNameList.last(),
-                            m_db.databaseName());
+        //switch to DB_VERSION 052
+        if (toVersion >= 52 && l_ret) {
 
-                Macaw::DEBUG_OUT("[DatabaseManager] Returned to backup");
+            Macaw::DEBUG_IN("[DatabaseManager] upgrade to v052");
+            l_ret &= createTableFetchJobs(l_query);
 
-                this->openDB();
+            if(l_ret) {
+                l_ret &= l_query.exec("UPDATE config "
+                                      "SET db_version = 52");
+                l_fromVersion = 52;
+            } else {
+                this->restoreBackup();
             }
-            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v050");
+            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v052");
+        }
+
+        //switch to DB_VERSION 053
+        if (toVersion >= 53 && l_ret) {
+
+            Macaw::DEBUG_IN("[DatabaseManager] upgrade to v053");
+            if (!m_db.record("config").contains("data_version")) {
+                l_ret &= l_query.exec("ALTER TABLE config ADD data_version INTEGER DEFAULT 0");
+                if(!l_ret)
+                {
+                    Macaw::DEBUG(l_query.lastError().text());
+                }
+            }
+
+            if(l_ret) {
+                l_ret &= l_query.exec("UPDATE config "
+                                      "SET db_version = 53, data_version = 0");
+                l_fromVersion = 53;
+            } else {
+                this->restoreBackup();
+            }
+            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v053");
+        }
+
+        //switch to DB_VERSION 054
+        if (toVersion >= 54 && l_ret) {
+
+            Macaw::DEBUG_IN("[DatabaseManager] upgrade to v054");
+            if (!m_db.record("movies").contains("title_sort")) {
+                l_ret &= l_query.exec("ALTER TABLE movies ADD title_sort VARCHAR(255)");
+            }
+            if (!m_db.record("people").contains("name_sort")) {
+                l_ret &= l_query.exec("ALTER TABLE people ADD name_sort VARCHAR(200)");
+            }
+            if(!l_ret)
+            {
+                Macaw::DEBUG(l_query.lastError().text());
+            }
+
+            // The sort keys are computed by Qt, not by SQLite: the texts
+            // are read first, then all the keys are written in one transaction
+            QStringList l_tables;
+            l_tables << "movies" << "people";
+            QStringList l_columns;
+            l_columns << "title" << "name";
+            QList<QPair<int, QString> > l_sortKeyList[2];
+            for (int i = 0 ; i < l_tables.size() && l_ret ; i++) {
+                l_ret &= l_query.exec("SELECT id, " + l_columns.at(i) + " "
+                                      "FROM " + l_tables.at(i));
+                while (l_ret && l_query.next()) {
+                    QString l_text = l_query.value(1).toString();
+                    l_sortKeyList[i].append(qMakePair(l_query.value(0).toInt(),
+                                                      i == 0 ? SortKey::title(l_text)
+                                                             : SortKey::name(l_text)));
+                }
+            }
+            l_query.finish();
+
+            if (l_ret && m_db.transaction()) {
+                QSqlQuery l_query2(m_db);
+                for (int i = 0 ; i < l_tables.size() && l_ret ; i++) {
+                    l_query2.prepare("UPDATE " + l_tables.at(i) + " "
+                                     "SET " + l_columns.at(i) + "_sort = :sort_key "
+                                     "WHERE id = :id");
+                    for (int j = 0 ; j < l_sortKeyList[i].size() && l_ret ; j++) {
+                        l_query2.bindValue(":sort_key", l_sortKeyList[i].at(j).second);
+                        l_query2.bindValue(":id", l_sortKeyList[i].at(j).first);
+                        l_ret &= l_query2.exec();
+                    }
+                }
+                if(!l_ret)
+                {
+                    Macaw::DEBUG(l_query2.lastError().text());
+                    m_db.rollback();
+                } else {
+                    l_ret &= m_db.commit();
+                }
+            } else {
+                l_ret = false;
+            }
+            if(!l_ret)
+            {
+                Macaw::DEBUG(m_db.lastError().text());
+            }
+
+            l_ret &= createIndexesSortKeys(l_query);
+
+            if(l_ret) {
+                l_ret &= l_query.exec("UPDATE config "
+                                      "SET db_version = 54");
+                l_fromVersion = 54;
+            } else {
+                this->restoreBackup();
+            }
+            Macaw::DEBUG_OUT("[DatabaseManager] exits upgrade to v054");
         }
     }
     Macaw::DEBUG_OUT("[DatabaseManager] exits upgradeDB");
@@ -493,6 +891,31 @@ bool DatabaseManager::upgradeDB(int fromVersion, int toVersion)
     return l_ret;
 }
 
+/**
+ * @brief Replaces the database by the last backup made by upgradeDB()
+ *
+ * @return bool
+ */
+bool DatabaseManager::restoreBackup()
+{
+    m_db.close();
+
+    Macaw::DEBUG_IN("[DatabaseManager] FAILED => Come back to backup");
+    QDir l_backups = m_db.databaseName();
+    l_backups.cdUp();
+    QStringList l_backupNameList = l_backups.entryList(QDir::Files|QDir::NoDotAndDotDot,
+                                                       QDir::Name);
+    Macaw::DEBUG("Return to "+l_backupNameList.last());
+
+    this->deleteDB();
+    bool l_ret = QFile::copy(l_backups.absolutePath()+QDir::separator()+l_backupNameList.last(),
+                             m_db.databaseName());
+
+    Macaw::DEBUG_OUT("[DatabaseManager] Returned to backup");
+
+    return this->openDB() && l_ret;
+}
+
 /**
  * @brief Creates all the tables
  *
@@ -526,6 +949,8 @@ bool DatabaseManager::createTables()
 
             l_ret &= createTableMovies(l_query);
             l_ret &= createTablePeople(l_query);
+            l_ret &= createIndexPeopleTmdbId(l_query);
+            l_ret &= createIndexesSortKeys(l_query);
             l_ret &= createTableMoviesPeople(l_query);
             l_ret &= createTablePlaylists(l_query);
             l_ret &= createTableMoviesPlaylists(l_query);
@@ -534,6 +959,7 @@ bool DatabaseManager::createTables()
             l_ret &= createTableShow(l_query);
             l_ret &= createTableEpisodes(l_query);
             l_ret &= createTablePathList(l_query);
+            l_ret &= createTableFetchJobs(l_query);
             if (l_ret) {
                 l_ret &= createTableConfig(l_query);
             }
@@ -568,6 +994,7 @@ bool DatabaseManager::createTableMovies(QSqlQuery &query)
                   "imported BOOLEAN, "
                   "id_tmdb INTEGER, "
                   "show BOOLEAN, "
+                  "title_sort VARCHAR(255), "
                   "UNIQUE (id_path, file_path) ON CONFLICT IGNORE "
                   ")");
 
@@ -594,7 +1021,8 @@ bool DatabaseManager::createTablePeople(QSqlQuery &query)
                   "birthday VARCHAR(10), "
                   "biography TEXT, "
                   "imported BOOLEAN, "
-                  "id_tmdb INTEGER"
+                  "id_tmdb INTEGER, "
+                  "name_sort VARCHAR(200)"
                   ")");
 
     if (!query.exec()) {
@@ -606,6 +1034,48 @@ bool DatabaseManager::createTablePeople(QSqlQuery &query)
 
     return true;
 }
+/**
+ * @brief Create the unique index on `people.id_tmdb`
+ * People added by the user have no TMDb id (0) and are not concerned.
+ * @param query
+ * @return
+ */
+bool DatabaseManager::createIndexPeopleTmdbId(QSqlQuery &query)
+{
+    query.prepare("CREATE UNIQUE INDEX IF NOT EXISTS people_id_tmdb "
+                  "ON people(id_tmdb) WHERE id_tmdb > 0");
+
+    if (!query.exec()) {
+        Macaw::DEBUG("In createIndexPeopleTmdbId:");
+        Macaw::DEBUG(query.lastError().text());
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Create the indexes on the sort keys of the titles and of the names,
+ * which the lists are ordered by
+ * @param query
+ * @return
+ */
+bool DatabaseManager::createIndexesSortKeys(QSqlQuery &query)
+{
+    if (!query.exec("CREATE INDEX IF NOT EXISTS movies_title_sort "
+                    "ON movies(show, title_sort)")
+            || !query.exec("CREATE INDEX IF NOT EXISTS people_name_sort "
+                           "ON people(name_sort)")) {
+        Macaw::DEBUG("In createIndexesSortKeys:");
+        Macaw::DEBUG(query.lastError().text());
+
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Create the table `movies_people` which links between people and movies (a type of person is given here)
  * @param query
@@ -816,7 +1286,8 @@ bool DatabaseManager::createTableConfig(QSqlQuery &query)
 {
     query.prepare("CREATE TABLE IF NOT EXISTS config("
                   "db_version INTEGER,"
-                  "media_player VARCHAR(255))");
+                  "media_player VARCHAR(255),"
+                  "data_version INTEGER DEFAULT 0)");
 
     if (!query.exec()) {
         Macaw::DEBUG("In createTableConfig:");
@@ -839,6 +1310,36 @@ bool DatabaseManager::createTableConfig(QSqlQuery &query)
     return true;
 }
 
+/**
+ * @brief Create table `fetch_jobs`, where the pending and failed metadata fetchings are stored.
+ * `type` is a Macaw::typeElement, `state` a Macaw::fetchJobState
+ * and `next_retry` a timestamp.
+ * @param query
+ * @return
+ */
+bool DatabaseManager::createTableFetchJobs(QSqlQuery &query)
+{
+    query.prepare("CREATE TABLE IF NOT EXISTS fetch_jobs("
+                  "id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE, "
+                  "type INTEGER NOT NULL, "
+                  "id_element INTEGER NOT NULL, "
+                  "state INTEGER NOT NULL DEFAULT 0, "
+                  "attempts INTEGER NOT NULL DEFAULT 0, "
+                  "last_error TEXT, "
+                  "next_retry INTEGER NOT NULL DEFAULT 0, "
+                  "UNIQUE (type, id_element) ON CONFLICT IGNORE"
+                  ")");
+
+    if (!query.exec()) {
+        Macaw::DEBUG("In createTableFetchJobs:");
+        Macaw::DEBUG(query.lastError().text());
+
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief add a new tag with specified name to the database.
  * Returns the id of created tag, -1 if an error occurred.
@@ -862,7 +1363,10 @@ int DatabaseManager::createTag(QString name)
     if(l_query.exec("SELECT last_insert_rowid()"))
     {
         l_query.next();
-        return l_query.value(0).toInt();
+        int l_tagId = l_query.value(0).toInt();
+        recordChange(Macaw::isTag, Macaw::Inserted, l_tagId);
+
+        return l_tagId;
     }
 
     return -1;
@@ -888,6 +1392,7 @@ bool DatabaseManager::addMoviesPath(PathForMovies moviesPath)
 
         return false;
     }
+    recordChange(Macaw::isMoviesPath, Macaw::Inserted, l_query.lastInsertId().toInt());
 
     return true;
 }
@@ -973,6 +1478,7 @@ bool DatabaseManager::updateMoviesPath(PathForMovies moviesPath)
 
         return false;
     }
+    recordChange(Macaw::isMoviesPath, Macaw::Updated, moviesPath.id());
 
     return true;
 }
@@ -1039,29 +1545,96 @@ bool DatabaseManager::existMoviesPath(PathForMovies moviesPath)
     return !this->getMoviesPathById(moviesPath.id()).isEmpty();
 }
 
+/**
+ * @brief Removes a path and all its movies.
+ * The movies and their links are removed by a few set-based statements
+ * in one transaction, then the people and the tags left without movies
+ * are swept once it is committed.
+ *
+ * @param PathForMovies path to remove
+ * @return bool
+ */
 bool DatabaseManager::deleteMoviesPath(PathForMovies moviesPath)
 {
-    QList<Movie> l_movieList = getMoviesByPath(moviesPath);
+    QString l_movieIds = "SELECT id FROM movies WHERE id_path = :id_path";
+    QStringList l_posterPathList;
+    QSqlQuery l_query(m_db);
+    l_query.setForwardOnly(true);
+
+    beginTransaction();
+
+    // What is about to be deleted: for the change signals, the posters and the orphans
+    QStringList l_selectList;
+    l_selectList << "SELECT id, poster_path FROM movies WHERE id_path = :id_path"
+                 << "SELECT id, 0 FROM path_list WHERE id = :id_path"
+                 << "SELECT DISTINCT id_playlist, 0 FROM movies_playlists WHERE id_movie IN (" + l_movieIds + ")"
+                 << "SELECT DISTINCT id_people, 0 FROM movies_people WHERE id_movie IN (" + l_movieIds + ")"
+                 << "SELECT DISTINCT id_tag, 0 FROM movies_tags WHERE id_movie IN (" + l_movieIds + ")";
+    for (int i = 0 ; i < l_selectList.size() ; i++) {
+        l_query.prepare(l_selectList.at(i));
+        l_query.bindValue(":id_path", moviesPath.id());
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In deleteMoviesPath():");
+            Macaw::DEBUG(l_query.lastError().text());
+            rollbackTransaction();
 
-    foreach (Movie l_movie, l_movieList) {
-        if (!deleteMovie(l_movie))
-        {
+            return false;
+        }
+        while (l_query.next()) {
+            int l_id = l_query.value(0).toInt();
+            switch (i) {
+            case 0:
+                recordChange(Macaw::isMovie, Macaw::Deleted, l_id);
+                if (!l_query.value(1).toString().isEmpty()) {
+                    l_posterPathList.append(l_query.value(1).toString());
+                }
+                break;
+            case 1:
+                recordChange(Macaw::isMoviesPath, Macaw::Deleted, l_id);
+                break;
+            case 2:
+                recordChange(Macaw::isPlaylist, Macaw::Updated, l_id);
+                break;
+            case 3:
+                recordOrphanCandidate(Macaw::isPeople, l_id);
+                break;
+            case 4:
+                recordOrphanCandidate(Macaw::isTag, l_id);
+                break;
+            }
+        }
+    }
+
+    QStringList l_deleteList;
+    l_deleteList << "DELETE FROM movies_people WHERE id_movie IN (" + l_movieIds + ")"
+                 << "DELETE FROM movies_tags WHERE id_movie IN (" + l_movieIds + ")"
+                 << "DELETE FROM movies_playlists WHERE id_movie IN (" + l_movieIds + ")"
+                 << "DELETE FROM fetch_jobs WHERE type = " + QString::number(Macaw::isMovie)
+                    + " AND id_element IN (" + l_movieIds + ")"
+                 << "DELETE FROM movies WHERE id_path = :id_path"
+                 << "DELETE FROM path_list WHERE id = :id_path";
+    foreach (QString l_delete, l_deleteList) {
+        l_query.prepare(l_delete);
+        l_query.bindValue(":id_path", moviesPath.id());
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In deleteMoviesPath():");
+            Macaw::DEBUG(l_query.lastError().text());
+            rollbackTransaction();
 
             return false;
         }
     }
 
-    QSqlQuery l_query(m_db);
-    l_query.prepare("DELETE FROM path_list WHERE movies_path LIKE :movies_path||'%'");
-    l_query.bindValue(":movies_path", moviesPath.path());
-    if(!l_query.exec())
-    {
-        Macaw::DEBUG("In removeMoviesPath(), deleting path:");
-        Macaw::DEBUG(l_query.lastError().text());
+    if (!commitTransaction()) {
 
         return false;
     }
 
+    QDir l_posterPath(qApp->property("postersPath").toString());
+    foreach (QString l_posterFile, l_posterPathList) {
+        l_posterPath.remove(l_posterFile);
+    }
+
     return true;
 }
 
@@ -1089,3 +1662,22 @@ QString DatabaseManager::getMediaPlayerPath()
 
     return l_mediaPlayerPath;
 }
+
+/**
+ * @brief Gets the version of the data, incremented by each change
+ *
+ * @return int, -1 if it could not be read
+ */
+int DatabaseManager::getDataVersion()
+{
+    QSqlQuery l_query(m_db);
+    if (!l_query.exec("SELECT data_version FROM config") || !l_query.next())
+    {
+        Macaw::DEBUG("In getDataVersion():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return -1;
+    }
+
+    return l_query.value(0).toInt();
+}
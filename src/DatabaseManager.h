@@ -20,9 +20,15 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include <QCache>
+#include <QDateTime>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QSqlDatabase>
 
+#include "StringPool.h"
+
 class Episode;
 class Movie;
 class PathForMovies;
@@ -39,6 +45,8 @@ class Tag;
 class DatabaseManager : public QObject
 {
     #define DATE_FORMAT "yyyy.MM.dd"
+    #define SQL_BATCH_SIZE 500
+    #define ENTITY_CACHE_SIZE 2000
     Q_OBJECT
 
 public:
@@ -46,10 +54,20 @@ public:
     // Database management
     bool openDB();
     bool closeDB();
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
     bool deleteDB();
+    QString databasePath() const { return m_db.databaseName(); }
+    QSqlDatabase database() const { return m_db; }
+    int cacheHits() const { return m_cacheHits; }
+    int cacheMisses() const { return m_cacheMisses; }
+    void clearCaches();
     bool createTables();
     bool createTableMovies(QSqlQuery&);
     bool createTablePeople(QSqlQuery&);
+    bool createIndexPeopleTmdbId(QSqlQuery&);
+    bool createIndexesSortKeys(QSqlQuery&);
     bool createTableMoviesPeople(QSqlQuery&);
     bool createTablePlaylists(QSqlQuery&);
     bool createTableMoviesPlaylists(QSqlQuery&);
@@ -59,13 +77,16 @@ public:
     bool createTableEpisodes(QSqlQuery&);
     bool createTablePathList(QSqlQuery&);
     bool createTableConfig(QSqlQuery&);
+    bool createTableFetchJobs(QSqlQuery&);
     QSqlError lastError();
     bool upgradeDB(int fromVersion, int toVersion);
+    bool restoreBackup();
 
     // Getters for paths, config
     QString getMoviesPathById(int id);
     QList<PathForMovies> getMoviesPaths(bool imported = true);
     QString getMediaPlayerPath();
+    int getDataVersion();
 
     // Insertions for paths, config
     bool addMoviesPath(PathForMovies moviesPath);
@@ -77,30 +98,51 @@ public:
     bool existMoviesPath(PathForMovies moviesPath);
 
 signals:
-    void orphanTagDetected(const Tag &tag);
-    void orphanPeopleDetected(const People &people);
+    // Emitted after the outermost commit, with all the orphans of the transaction
+    void orphansDetected(const QList<People> &peopleList, const QList<Tag> &tagList);
+
+    // Emitted once the changes are committed, one signal per transaction
+    void moviesChanged(const QList<int> &insertedIdList,
+                       const QList<int> &updatedIdList,
+                       const QList<int> &deletedIdList);
+    void peopleChanged(const QList<int> &insertedIdList,
+                       const QList<int> &updatedIdList,
+                       const QList<int> &deletedIdList);
+    void tagsChanged(const QList<int> &insertedIdList,
+                     const QList<int> &updatedIdList,
+                     const QList<int> &deletedIdList);
+    void playlistsChanged(const QList<int> &insertedIdList,
+                          const QList<int> &updatedIdList,
+                          const QList<int> &deletedIdList);
+    void moviesPathsChanged(const QList<int> &insertedIdList,
+                            const QList<int> &updatedIdList,
+                            const QList<int> &deletedIdList);
+
+public slots:
+    void logStatistics() const;
 
 //// Getters - in DatabaseManager_getters.cpp
 public:
     // Movies
     Movie getOneMovieById(const int id);
-    QList<Movie> getAllMovies(const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByPeople(const int id, const int type, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByPeople(const People &people, const int type, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByTag(const int id, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByTag(const Tag &tag, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByPlaylist(const int id, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByPlaylist(const Playlist &playlist, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByPath(const PathForMovies &path, const QString fieldOrder = "title");
-    QList<Movie> getMoviesWithoutPeople(const int type, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesWithoutTag(const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesByAny(const QString text, const bool show = false, const QString fieldOrder = "title");
-    QList<Movie> getMoviesNotImported(const bool show = false, const QString fieldOrder = "title");
+    QList<Movie> getAllMovies(const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByPeople(const int id, const int type, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByPeople(const People &people, const int type, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByTag(const int id, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByTag(const Tag &tag, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByPlaylist(const int id, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByPlaylist(const Playlist &playlist, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByPath(const PathForMovies &path, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesWithoutPeople(const int type, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesWithoutTag(const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesByAny(const QString text, const bool show = false, const QString fieldOrder = "title_sort");
+    QList<Movie> getMoviesNotImported(const bool show = false, const QString fieldOrder = "title_sort");
+    static void prepareMoviesByAny(QSqlQuery &query, const QString fields, const QString text, const bool show, const QString fieldOrder);
 
     // Episodes
     Episode getOneEpisodeById(const int id);
     QList<Episode> getAllEpisodes();
-    QList<Episode> getEpisodesByMovies(QList<Movie> movieList); // Do not pass by reference !
+    QList<Episode> getEpisodesByMovies(const QList<Movie> &movieList);
 /*    QList<Episode> getEpisodesByPeople(const int id, const int type, const QString fieldOrder = "s.name, e.season, e.number");
     QList<Episode> getEpisodesByPeople(const People &people, const int type, const QString fieldOrder = "s.name, e.season, e.number");
     QList<Episode> getEpisodesByTag(const int id, const QString fieldOrder = "s.name, e.season, e.number");
@@ -120,10 +162,12 @@ public:
     People getOnePeopleById(const int id);
     People getOnePeopleById(const int id , const int type);
     People getOnePeopleByName(const QString name);
-    QList<People> getPeopleUsedByType(const int type, const QString fieldOrder = "name");
-    QList<People> getPeopleByName(const QString name, const QString fieldOrder = "name");
-    QList<People> getPeopleByMovie(const Movie &movie, int type, const QString fieldOrder = "name");
-    QList<People> getPeopleByAny(const QString text, const int type, const QString fieldOrder = "name");
+    People getOnePeopleByTmdbId(const int tmdbId);
+    QList<People> getPeopleUsedByType(const int type, const QString fieldOrder = "name_sort");
+    QList<People> getPeopleByName(const QString name, const QString fieldOrder = "name_sort");
+    QList<People> getPeopleByMovie(const Movie &movie, int type, const QString fieldOrder = "name_sort");
+    QList<People> getPeopleByAny(const QString text, const int type, const QString fieldOrder = "name_sort");
+    QHash<int, QList<int> > getPeopleIdsByMovieId(const int type);
 
     // Tags
     Tag getOneTagById(const int id);
@@ -131,6 +175,7 @@ public:
     QList<Tag> getAllTags(const QString fieldOrder = "name");
     QList<Tag> getTagsUsed(const QString fieldOrder = "name");
     QList<Tag> getTagsByAny(const QString text, const QString fieldOrder = "name");
+    QHash<int, QList<int> > getTagIdsByMovieId();
 
     // Playlists
     Playlist getOnePlaylistById(const int id);
@@ -139,6 +184,7 @@ public:
     bool isMovieInPlaylist(int movieId, int playlistId);
     bool isMovieInPlaylist(Movie &movie, int playlistId);
     bool isMovieInPlaylist(Movie &movie, Playlist &playlist);
+    QSet<int> getMovieIdsByPlaylist(const int playlistId);
 
     // Does element exist ?
     bool existEpisode(const QString);
@@ -146,6 +192,14 @@ public:
     bool existMovie(const QString);
     bool existTag(const QString);
     bool existPeople(const QString name);
+    bool existFetchJobs(const int maxAttempts);
+
+    // Fetch jobs
+    QList<Movie> getMoviesToFetch(const int maxAttempts);
+    QList<Movie> getMoviesToReview();
+    QList<People> getPeopleToFetch(const int maxAttempts);
+    int getFetchJobAttempts(const int type, const int id);
+    QDateTime getNextFetchRetry(const int maxAttempts);
 
 private:
     // Other functions for getters
@@ -168,6 +222,7 @@ public:
     bool insertNewPlaylist(Playlist &playlist);
     bool addTagToMovie(Tag &tag, Movie &movie);
     bool addPeopleToMovie(People &people, Movie &movie, const int type);
+    bool addFetchJobs(const int type, const QList<int> &idList, const bool reset = false);
 
 private:
     bool insertNewPeople(People &people);
@@ -183,18 +238,38 @@ public:
     bool updateTagInMovie(Tag &tag, Movie &movie);
     bool updatePlaylist(Playlist &playlist);
     bool updateMovieInPlaylist(Movie &movie, Playlist &playlist);
+    bool setFetchJobFailed(const int type, const int id, const QString error, const QDateTime nextRetry);
+    bool setFetchJobToReview(const int type, const int id, const QString reason);
 
 //// Delete - in DatabaseManager_delete.cpp
 public:
     bool deleteMovie(Movie &movie);
+    bool deleteMovies(const QList<int> &movieIdList);
     bool removePeopleFromMovie(People &people, Movie &movie, const int type);
     bool removeTagFromMovie(Tag &tag, Movie &movie);
     bool removeMovieFromPlaylist(Movie &movie, Playlist &playlist);
     bool deletePlaylist(Playlist &playlist);
     bool deleteTag(const Tag &tag);
     bool deletePeople(const People &people);
+    bool deleteOrphans(const QList<People> &peopleList, const QList<Tag> &tagList);
+    bool deleteFetchJob(const int type, const int id);
 
 private:
+    bool execWithIds(QSqlQuery &query, const QString queryText, const QList<int> &idList);
+    bool findOrphans(const QSet<int> &peopleIdSet,
+                     const QSet<int> &tagIdSet,
+                     QList<People> &orphanPeopleList,
+                     QList<Tag> &orphanTagList);
+
+    /**
+     * @brief Ids of the elements changed by the current transaction
+     */
+    struct ChangeSet {
+        QSet<int> inserted;
+        QSet<int> updated;
+        QSet<int> deleted;
+    };
+
     QSqlDatabase m_db;
     QString m_movieFields;
     QString m_episodeFields;
@@ -202,5 +277,46 @@ private:
     QString m_peopleFields;
     QString m_tagFields;
 
+    /**
+     * @brief Number of nested transactions currently open
+     */
+    int m_transactionDepth;
+    bool m_transactionFailed;
+
+    /**
+     * @brief Changes waiting for the commit, by Macaw::typeElement
+     */
+    QHash<int, ChangeSet> m_pendingChanges;
+    void recordChange(const int type, const int change, const int id);
+    void emitChanges();
+    bool bumpDataVersion();
+
+    /**
+     * @brief People and tags unlinked from a movie by the current transaction,
+     * checked for orphans once it is committed
+     */
+    QSet<int> m_orphanPeopleCandidates;
+    QSet<int> m_orphanTagCandidates;
+    void recordOrphanCandidate(const int type, const int id);
+    void sweepOrphans();
+
+    /**
+     * @brief Movies, people and tags recently read by id,
+     * the least recently used being dropped first.
+     * An element is dropped as soon as a change is recorded on it.
+     */
+    QCache<int, Movie> m_movieCache;
+    QCache<int, People> m_peopleCache;
+    QCache<int, Tag> m_tagCache;
+    int m_cacheHits;
+    int m_cacheMisses;
+    void invalidateCaches(const int type, const int id);
+
+    /**
+     * @brief Values repeated across the hydrated elements (countries,
+     * formats, suffixes, names), shared rather than copied
+     */
+    StringPool m_stringPool;
+
 };
 #endif // DATABASEMANAGER_H
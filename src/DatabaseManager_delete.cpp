@@ -23,8 +23,11 @@
 #include <QDir>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QStringList>
 #include <QVariant>
 
+#include "enumerations.h"
+
 #include "MacawDebug.h"
 #include "Entities/Episode.h"
 #include "Entities/Movie.h"
@@ -40,10 +43,13 @@
  */
 bool DatabaseManager::deleteMovie(Movie &movie)
 {
+    beginTransaction();
     foreach(People l_people, movie.peopleList())
     {
         if (!removePeopleFromMovie(l_people, movie, l_people.type()))
         {
+            rollbackTransaction();
+
             return false;
         }
     }
@@ -51,6 +57,8 @@ bool DatabaseManager::deleteMovie(Movie &movie)
     {
         if (!removeTagFromMovie(l_tag, movie))
         {
+            rollbackTransaction();
+
             return false;
         }
     }
@@ -59,6 +67,8 @@ bool DatabaseManager::deleteMovie(Movie &movie)
     {
         if (!removeMovieFromPlaylist(movie, l_playlist))
         {
+            rollbackTransaction();
+
             return false;
         }
     }
@@ -67,6 +77,13 @@ bool DatabaseManager::deleteMovie(Movie &movie)
         QDir l_posterPath(qApp->property("postersPath").toString());
         l_posterPath.remove(movie.posterPath());
     }
+    if (!deleteFetchJob(Macaw::isMovie, movie.id()))
+    {
+        rollbackTransaction();
+
+        return false;
+    }
+
     QSqlQuery l_query(m_db);
     l_query.prepare("DELETE FROM movies WHERE id = :id");
     l_query.bindValue(":id", movie.id());
@@ -75,6 +92,230 @@ bool DatabaseManager::deleteMovie(Movie &movie)
     {
         Macaw::DEBUG("In deleteMovie():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
+
+        return false;
+    }
+    recordChange(Macaw::isMovie, Macaw::Deleted, movie.id());
+
+    return commitTransaction();
+}
+
+/**
+ * @brief Removes several movies from the database, in one transaction.
+ * The ids are handled by batches of SQL_BATCH_SIZE. The people and the tags
+ * which are not linked to any movie anymore are swept once the transaction
+ * is committed.
+ *
+ * @param QList<int> ids of the movies to remove
+ * @return boolean
+ */
+bool DatabaseManager::deleteMovies(const QList<int> &movieIdList)
+{
+    QStringList l_posterPathList;
+    QSqlQuery l_query(m_db);
+    l_query.setForwardOnly(true);
+
+    beginTransaction();
+    for (int l_first = 0 ; l_first < movieIdList.size() ; l_first += SQL_BATCH_SIZE) {
+        QList<int> l_batchIdList = movieIdList.mid(l_first, SQL_BATCH_SIZE);
+
+        // Elements linked to the movies, checked for orphans at the end
+        if (!execWithIds(l_query, "SELECT id_people FROM movies_people WHERE id_movie IN (%1)", l_batchIdList)) {
+            rollbackTransaction();
+
+            return false;
+        }
+        while (l_query.next()) {
+            recordOrphanCandidate(Macaw::isPeople, l_query.value(0).toInt());
+        }
+
+        if (!execWithIds(l_query, "SELECT id_tag FROM movies_tags WHERE id_movie IN (%1)", l_batchIdList)) {
+            rollbackTransaction();
+
+            return false;
+        }
+        while (l_query.next()) {
+            recordOrphanCandidate(Macaw::isTag, l_query.value(0).toInt());
+        }
+
+        if (!execWithIds(l_query, "SELECT DISTINCT id_playlist FROM movies_playlists WHERE id_movie IN (%1)", l_batchIdList)) {
+            rollbackTransaction();
+
+            return false;
+        }
+        while (l_query.next()) {
+            recordChange(Macaw::isPlaylist, Macaw::Updated, l_query.value(0).toInt());
+        }
+
+        if (!execWithIds(l_query, "SELECT poster_path FROM movies WHERE id IN (%1) AND poster_path != ''", l_batchIdList)) {
+            rollbackTransaction();
+
+            return false;
+        }
+        while (l_query.next()) {
+            l_posterPathList.append(l_query.value(0).toString());
+        }
+
+        if (!execWithIds(l_query, "DELETE FROM movies_people WHERE id_movie IN (%1)", l_batchIdList)
+                || !execWithIds(l_query, "DELETE FROM movies_tags WHERE id_movie IN (%1)", l_batchIdList)
+                || !execWithIds(l_query, "DELETE FROM movies_playlists WHERE id_movie IN (%1)", l_batchIdList)
+                || !execWithIds(l_query, "DELETE FROM fetch_jobs WHERE type = " + QString::number(Macaw::isMovie)
+                                + " AND id_element IN (%1)", l_batchIdList)
+                || !execWithIds(l_query, "DELETE FROM movies WHERE id IN (%1)", l_batchIdList)) {
+            rollbackTransaction();
+
+            return false;
+        }
+        foreach (int l_id, l_batchIdList) {
+            recordChange(Macaw::isMovie, Macaw::Deleted, l_id);
+        }
+    }
+
+    if (!commitTransaction()) {
+
+        return false;
+    }
+
+    QDir l_posterPath(qApp->property("postersPath").toString());
+    foreach (QString l_posterFile, l_posterPathList) {
+        l_posterPath.remove(l_posterFile);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Records that a person or a tag has been unlinked from a movie.
+ * Outside of a transaction it is checked at once, else it waits for
+ * the outermost commit, with the other candidates of the transaction.
+ *
+ * @param int type of the element (Macaw::isPeople or Macaw::isTag)
+ * @param int id of the element
+ */
+void DatabaseManager::recordOrphanCandidate(const int type, const int id)
+{
+    if (type == Macaw::isPeople) {
+        m_orphanPeopleCandidates.insert(id);
+    } else if (type == Macaw::isTag) {
+        m_orphanTagCandidates.insert(id);
+    }
+
+    if (m_transactionDepth == 0) {
+        sweepOrphans();
+    }
+}
+
+/**
+ * @brief Checks the orphan candidates with one anti-join per type,
+ * and sends the orphans found through orphansDetected()
+ */
+void DatabaseManager::sweepOrphans()
+{
+    if (m_orphanPeopleCandidates.isEmpty() && m_orphanTagCandidates.isEmpty()) {
+
+        return;
+    }
+
+    // The receivers may write in the database again
+    QSet<int> l_peopleIdSet = m_orphanPeopleCandidates;
+    QSet<int> l_tagIdSet = m_orphanTagCandidates;
+    m_orphanPeopleCandidates.clear();
+    m_orphanTagCandidates.clear();
+
+    QList<People> l_orphanPeopleList;
+    QList<Tag> l_orphanTagList;
+    if (!findOrphans(l_peopleIdSet, l_tagIdSet, l_orphanPeopleList, l_orphanTagList)) {
+
+        return;
+    }
+
+    if (!l_orphanPeopleList.isEmpty() || !l_orphanTagList.isEmpty()) {
+        Macaw::DEBUG("[DatabaseManager] orphans detected");
+        emit orphansDetected(l_orphanPeopleList, l_orphanTagList);
+    }
+}
+
+/**
+ * @brief Finds, among some people and tags, those which are not linked
+ * to any movie anymore
+ *
+ * @param QSet<int> ids of the people to check
+ * @param QSet<int> ids of the tags to check
+ * @param QList<People> orphan people found
+ * @param QList<Tag> orphan tags found
+ * @return boolean
+ */
+bool DatabaseManager::findOrphans(const QSet<int> &peopleIdSet,
+                                  const QSet<int> &tagIdSet,
+                                  QList<People> &orphanPeopleList,
+                                  QList<Tag> &orphanTagList)
+{
+    QSqlQuery l_query(m_db);
+    l_query.setForwardOnly(true);
+
+    QList<int> l_peopleIdList = peopleIdSet.toList();
+    for (int l_first = 0 ; l_first < l_peopleIdList.size() ; l_first += SQL_BATCH_SIZE) {
+        if (!execWithIds(l_query, "SELECT id FROM people WHERE id IN (%1) "
+                                  "AND id NOT IN (SELECT id_people FROM movies_people)",
+                         l_peopleIdList.mid(l_first, SQL_BATCH_SIZE))) {
+
+            return false;
+        }
+        QList<int> l_orphanIdList;
+        while (l_query.next()) {
+            l_orphanIdList.append(l_query.value(0).toInt());
+        }
+        foreach (int l_id, l_orphanIdList) {
+            orphanPeopleList.append(getOnePeopleById(l_id));
+        }
+    }
+
+    QList<int> l_tagIdList = tagIdSet.toList();
+    for (int l_first = 0 ; l_first < l_tagIdList.size() ; l_first += SQL_BATCH_SIZE) {
+        if (!execWithIds(l_query, "SELECT id FROM tags WHERE id IN (%1) "
+                                  "AND id NOT IN (SELECT id_tag FROM movies_tags)",
+                         l_tagIdList.mid(l_first, SQL_BATCH_SIZE))) {
+
+            return false;
+        }
+        QList<int> l_orphanIdList;
+        while (l_query.next()) {
+            l_orphanIdList.append(l_query.value(0).toInt());
+        }
+        foreach (int l_id, l_orphanIdList) {
+            orphanTagList.append(getOneTagById(l_id));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Executes a query on a list of ids.
+ * The `%1` of the query is replaced by one placeholder per id;
+ * the list must not be longer than SQL_BATCH_SIZE.
+ *
+ * @param QSqlQuery query to execute
+ * @param QString text of the query
+ * @param QList<int> ids to bind
+ * @return boolean
+ */
+bool DatabaseManager::execWithIds(QSqlQuery &query, const QString queryText, const QList<int> &idList)
+{
+    QStringList l_placeholderList;
+    for (int i = 0 ; i < idList.size() ; i++) {
+        l_placeholderList.append("?");
+    }
+    query.prepare(queryText.arg(l_placeholderList.join(",")));
+    foreach (int l_id, idList) {
+        query.addBindValue(l_id);
+    }
+
+    if (!query.exec()) {
+        Macaw::DEBUG("In execWithIds():");
+        Macaw::DEBUG(query.lastQuery());
+        Macaw::DEBUG(query.lastError().text());
 
         return false;
     }
@@ -84,7 +325,8 @@ bool DatabaseManager::deleteMovie(Movie &movie)
 
 /**
  * @brief Removes the link between a person and a movie
- * If there is no more link with the person, it is deleted
+ * If there is no more link with the person, it is sent with the other orphans
+ * of the transaction through orphansDetected()
  *
  * @param People to remove
  * @param Movie concerned by the deletion
@@ -111,28 +353,16 @@ bool DatabaseManager::removePeopleFromMovie(People &people,
 
         return false;
     }
-
-    // Checks if this people is still used, if not asks for deleting it.
-    l_query.prepare("SELECT id FROM movies_people WHERE id_people = :id_people");
-    l_query.bindValue(":id_people", people.id());
-    if(!l_query.exec())
-    {
-        Macaw::DEBUG("In removePeopleFromMovie():");
-        Macaw::DEBUG(l_query.lastError().text());
-
-        return false;
-    }
-    if (!l_query.next()) {
-        Macaw::DEBUG("[DatabaseManager] orphan people detected");
-        emit orphanPeopleDetected(people);
-    }
+    recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
+    recordOrphanCandidate(Macaw::isPeople, people.id());
 
     return true;
 }
 
 /**
  * @brief Removes the link between a tag and a movie
- * If there is no more link with the tag, it is deleted
+ * If there is no more link with the tag, it is sent with the other orphans
+ * of the transaction through orphansDetected()
  *
  * @param Tag to remove
  * @param Movie concerned by the deletion
@@ -153,22 +383,8 @@ bool DatabaseManager::removeTagFromMovie(Tag &tag, Movie &movie)
 
         return false;
     }
-
-    // Checks if this tag is still used, if not; asks for deleting it.
-    l_query.prepare("SELECT id FROM movies_tags WHERE id_tag = :id_tag");
-    l_query.bindValue(":id_tag", tag.id());
-    if(!l_query.exec())
-    {
-        Macaw::DEBUG("In removeTagFromMovie():");
-        Macaw::DEBUG(l_query.lastError().text());
-
-        return false;
-    }
-
-    if(!l_query.next())
-    {
-        emit orphanTagDetected(tag);
-    }
+    recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
+    recordOrphanCandidate(Macaw::isTag, tag.id());
 
     return true;
 }
@@ -195,6 +411,7 @@ bool DatabaseManager::removeMovieFromPlaylist(Movie &movie, Playlist &playlist)
 
         return false;
     }
+    recordChange(Macaw::isPlaylist, Macaw::Updated, playlist.id());
 
     return true;
 }
@@ -213,6 +430,7 @@ bool DatabaseManager::deletePlaylist(Playlist &playlist)
         return false;
     }
 
+    beginTransaction();
     foreach (Movie l_movie, playlist.movieList())
     {
         removeMovieFromPlaylist(l_movie, playlist);
@@ -227,11 +445,13 @@ bool DatabaseManager::deletePlaylist(Playlist &playlist)
     {
         Macaw::DEBUG("In deletePlaylist():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
+    recordChange(Macaw::isPlaylist, Macaw::Deleted, playlist.id());
 
-    return true;
+    return commitTransaction();
 }
 
 /**
@@ -256,6 +476,11 @@ bool DatabaseManager::deletePeople(const People &people)
         return false;
     }
 
+    if (!deleteFetchJob(Macaw::isPeople, people.id()))
+    {
+        return false;
+    }
+
     l_query.prepare("DELETE FROM people WHERE id = :id");
     l_query.bindValue(":id", people.id());
 
@@ -266,6 +491,7 @@ bool DatabaseManager::deletePeople(const People &people)
 
         return false;
     }
+    recordChange(Macaw::isPeople, Macaw::Deleted, people.id());
 
     return true;
 }
@@ -302,6 +528,85 @@ bool DatabaseManager::deleteTag(const Tag &tag)
 
         return false;
     }
+    recordChange(Macaw::isTag, Macaw::Deleted, tag.id());
+
+    return true;
+}
+
+/**
+ * @brief Deletes people and tags found orphan earlier, in one transaction.
+ * They are checked again first: the ones linked to a movie since
+ * are kept.
+ *
+ * @param QList<People> people to delete
+ * @param QList<Tag> tags to delete
+ * @return boolean
+ */
+bool DatabaseManager::deleteOrphans(const QList<People> &peopleList, const QList<Tag> &tagList)
+{
+    QSet<int> l_peopleIdSet;
+    foreach (People l_people, peopleList) {
+        l_peopleIdSet.insert(l_people.id());
+    }
+    QSet<int> l_tagIdSet;
+    foreach (Tag l_tag, tagList) {
+        l_tagIdSet.insert(l_tag.id());
+    }
+
+    beginTransaction();
+    QList<People> l_orphanPeopleList;
+    QList<Tag> l_orphanTagList;
+    if (!findOrphans(l_peopleIdSet, l_tagIdSet, l_orphanPeopleList, l_orphanTagList))
+    {
+        rollbackTransaction();
+
+        return false;
+    }
+
+    foreach (People l_people, l_orphanPeopleList)
+    {
+        if (!deletePeople(l_people))
+        {
+            rollbackTransaction();
+
+            return false;
+        }
+    }
+    foreach (Tag l_tag, l_orphanTagList)
+    {
+        if (!deleteTag(l_tag))
+        {
+            rollbackTransaction();
+
+            return false;
+        }
+    }
+
+    return commitTransaction();
+}
+
+/**
+ * @brief Removes the fetch job of an element, once done or not wanted anymore
+ *
+ * @param int type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param int id of the element
+ * @return boolean
+ */
+bool DatabaseManager::deleteFetchJob(const int type, const int id)
+{
+    QSqlQuery l_query(m_db);
+    l_query.prepare("DELETE FROM fetch_jobs "
+                    "WHERE type = :type AND id_element = :id_element");
+    l_query.bindValue(":type", type);
+    l_query.bindValue(":id_element", id);
+
+    if(!l_query.exec())
+    {
+        Macaw::DEBUG("In deleteFetchJob():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return false;
+    }
 
     return true;
 }
@@ -19,9 +19,14 @@
 
 #include "DatabaseManager.h"
 
+#include <QHash>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QStringList>
 #include <QVariant>
+#include <QtAlgorithms>
+
+#include "enumerations.h"
 
 #include "MacawDebug.h"
 #include "Entities/Episode.h"
@@ -38,6 +43,13 @@
  */
 Movie DatabaseManager::getOneMovieById(const int id)
 {
+    if (m_movieCache.contains(id)) {
+        m_cacheHits++;
+
+        return *m_movieCache.object(id);
+    }
+    m_cacheMisses++;
+
     Movie l_movie;
     QSqlQuery l_query(m_db);
     l_query.prepare("SELECT " + m_movieFields +
@@ -54,6 +66,7 @@ Movie DatabaseManager::getOneMovieById(const int id)
     if(l_query.next())
     {
         l_movie = hydrateMovie(l_query);
+        m_movieCache.insert(id, new Movie(l_movie));
     }
 
     return l_movie;
@@ -355,12 +368,45 @@ QList<Movie> DatabaseManager::getMoviesByAny(const QString text,
                                              const bool show,
                                              const QString fieldOrder)
 {
-    // @TODO: too long
     QList<Movie> l_movieList;
     QSqlQuery l_query(m_db);
+    prepareMoviesByAny(l_query, m_movieFields, text, show, fieldOrder);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getMoviesByAny():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        Movie l_movie = hydrateMovieOnly(l_query);
+        l_movieList.append(l_movie);
+    }
+
+    return l_movieList;
+}
+
+/**
+ * @brief Prepares the query of getMoviesByAny() on any connection.
+ * It does not use the members, so that the search can run in another thread.
+ *
+ * @param QSqlQuery query to prepare
+ * @param QString fields to select
+ * @param QString text
+ * @param bool show
+ * @param QString fieldOrder
+ */
+void DatabaseManager::prepareMoviesByAny(QSqlQuery &query,
+                                         const QString fields,
+                                         const QString text,
+                                         const bool show,
+                                         const QString fieldOrder)
+{
+    // @TODO: too long
     QStringList l_splittedText = text.split(' ');
 
-    QString l_queryText = "SELECT " + m_movieFields + " FROM movies AS m WHERE show = :show AND ";
+    QString l_queryText = "SELECT " + fields + " FROM movies AS m WHERE show = :show AND ";
     for( int i = 0 ; i < l_splittedText.size() ; i++)
     {
         if (i != 0)
@@ -387,28 +433,14 @@ QList<Movie> DatabaseManager::getMoviesByAny(const QString text,
                   ") ";
     }
     l_queryText = l_queryText+ "ORDER BY m." + fieldOrder;
-    l_query.prepare(l_queryText);
+    query.prepare(l_queryText);
 
-    l_query.bindValue(":show", show);
+    query.bindValue(":show", show);
 
     for( int i = 0 ; i < l_splittedText.size() ; i++)
     {
-        l_query.bindValue(":text"+ QString::number(i), l_splittedText.at(i));
+        query.bindValue(":text"+ QString::number(i), l_splittedText.at(i));
     }
-
-    if (!l_query.exec())
-    {
-        Macaw::DEBUG("In getMoviesByAny():");
-        Macaw::DEBUG(l_query.lastError().text());
-    }
-
-    while(l_query.next())
-    {
-        Movie l_movie = hydrateMovieOnly(l_query);
-        l_movieList.append(l_movie);
-    }
-
-    return l_movieList;
 }
 
 QList<Movie> DatabaseManager::getMoviesNotImported(const bool show, const QString fieldOrder)
@@ -490,46 +522,77 @@ QList<Episode> DatabaseManager::getAllEpisodes()
     return l_episodeList;
 }
 
-QList<Episode> DatabaseManager::getEpisodesByMovies(QList<Movie> movieList)
+/**
+ * @brief Orders the episodes by show name, season and number
+ */
+static bool episodeLessThan(const Episode &left, const Episode &right)
 {
-    QList<Episode> l_episodeList;
+    if (left.show().name() != right.show().name()) {
+        return left.show().name() < right.show().name();
+    }
+    if (left.season() != right.season()) {
+        return left.season() < right.season();
+    }
 
-    QString l_queryText;
-    l_queryText = "SELECT " + m_episodeFields + ", " + m_showFields +
-                  "FROM episodes AS e "
-                  "LEFT JOIN show AS s "
-                  "ON s.id = e.id_show "
-                  "WHERE e.id_movie IN (";
+    return left.number() < right.number();
+}
 
-    foreach (Movie l_movie, movieList) {
-        l_queryText += QString::number(l_movie.id()) +',';
-    }
+/**
+ * @brief Get the episodes of a list of movies.
+ * The ids are bound as parameters, by batches of SQL_BATCH_SIZE
+ * to stay under the SQLite limit, and the rows are joined to the
+ * movies through a hash.
+ *
+ * @param QList<Movie> movieList
+ * @return QList<Episode> ordered by show name, season and number
+ */
+QList<Episode> DatabaseManager::getEpisodesByMovies(const QList<Movie> &movieList)
+{
+    QList<Episode> l_episodeList;
 
-    if (l_queryText.endsWith(',')) {
-        l_queryText.remove(l_queryText.count()-1,1);
+    QHash<int, Movie> l_movieHash;
+    l_movieHash.reserve(movieList.size());
+    foreach (Movie l_movie, movieList) {
+        l_movieHash.insert(l_movie.id(), l_movie);
     }
-    l_queryText += ") ORDER BY s.name, e.season, e.number";
+    QList<int> l_movieIdList = l_movieHash.keys();
 
     QSqlQuery l_query(m_db);
-    l_query.prepare(l_queryText);
+    for (int l_first = 0 ; l_first < l_movieIdList.size() ; l_first += SQL_BATCH_SIZE) {
+        QList<int> l_batchIdList = l_movieIdList.mid(l_first, SQL_BATCH_SIZE);
 
-    if (!l_query.exec())
-    {
-        Macaw::DEBUG("In getEpisodesByMovies:");
-        Macaw::DEBUG(l_query.lastError().text());
-    }
+        QStringList l_placeholderList;
+        for (int i = 0 ; i < l_batchIdList.size() ; i++) {
+            l_placeholderList.append("?");
+        }
+        l_query.prepare("SELECT " + m_episodeFields + ", " + m_showFields +
+                        "FROM episodes AS e "
+                        "LEFT JOIN show AS s "
+                        "ON s.id = e.id_show "
+                        "WHERE e.id_movie IN (" + l_placeholderList.join(",") + ") "
+                        "ORDER BY s.name, e.season, e.number");
+        foreach (int l_id, l_batchIdList) {
+            l_query.addBindValue(l_id);
+        }
 
-    while(l_query.next())
-    {
-        foreach (Movie l_movie, movieList) {
-            if (l_movie.id() == l_query.value(4)) {
-                l_episodeList.append(hydrateEpisode(l_query, l_movie));
-                movieList.removeOne(l_movie);
-                break;
-            }
+        if (!l_query.exec())
+        {
+            Macaw::DEBUG("In getEpisodesByMovies:");
+            Macaw::DEBUG(l_query.lastError().text());
+        }
+
+        while(l_query.next())
+        {
+            l_episodeList.append(hydrateEpisode(l_query,
+                                                l_movieHash.value(l_query.value(4).toInt())));
         }
     }
 
+    // Each batch is ordered, not the whole list
+    if (l_movieIdList.size() > SQL_BATCH_SIZE) {
+        qStableSort(l_episodeList.begin(), l_episodeList.end(), episodeLessThan);
+    }
+
     return l_episodeList;
 }
 /*
@@ -611,6 +674,13 @@ QList<Episode> DatabaseManager::getEpisodesNotImported(const QString fieldOrder)
  */
 People DatabaseManager::getOnePeopleById(const int id)
 {
+    if (m_peopleCache.contains(id)) {
+        m_cacheHits++;
+
+        return *m_peopleCache.object(id);
+    }
+    m_cacheMisses++;
+
     People l_people;
     QSqlQuery l_query(m_db);
 
@@ -628,6 +698,7 @@ People DatabaseManager::getOnePeopleById(const int id)
     if(l_query.next())
     {
         l_people = hydratePeople(l_query);
+        m_peopleCache.insert(id, new People(l_people));
     }
 
     return l_people;
@@ -695,6 +766,36 @@ People DatabaseManager::getOnePeopleByName(const QString name)
     return l_people;
 }
 
+/**
+ * @brief Gets the one person known by TMDb with the id `tmdbId`
+ *
+ * @param int tmdbId of the person
+ * @return People
+ */
+People DatabaseManager::getOnePeopleByTmdbId(const int tmdbId)
+{
+    People l_people;
+    QSqlQuery l_query(m_db);
+
+    l_query.prepare("SELECT " + m_peopleFields +
+                    "FROM people AS p "
+                    "WHERE p.id_tmdb = :id_tmdb ");
+    l_query.bindValue(":id_tmdb", tmdbId);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getOnePeopleByTmdbId():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    if(l_query.next())
+    {
+        l_people = hydratePeople(l_query);
+    }
+
+    return l_people;
+}
+
 /**
  * @brief Gets all the people of type `type`
  *
@@ -799,6 +900,36 @@ QList<People> DatabaseManager::getPeopleByMovie(const Movie &movie,
     return l_peopleList;
 }
 
+/**
+ * @brief Get the ids of the people of a type linked to each movie, in one request
+ *
+ * @param int type of the people
+ * @return QHash<int, QList<int> > ids of the people, by movie id
+ */
+QHash<int, QList<int> > DatabaseManager::getPeopleIdsByMovieId(const int type)
+{
+    QHash<int, QList<int> > l_peopleIdHash;
+    QSqlQuery l_query(m_db);
+    l_query.setForwardOnly(true);
+    l_query.prepare("SELECT id_movie, id_people "
+                    "FROM movies_people "
+                    "WHERE type = :type");
+    l_query.bindValue(":type", type);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getPeopleIdsByMovieId:");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        l_peopleIdHash[l_query.value(0).toInt()].append(l_query.value(1).toInt());
+    }
+
+    return l_peopleIdHash;
+}
+
 QList<People> DatabaseManager::getPeopleByAny(QString text, int type, QString fieldOrder)
 {
     Macaw::DEBUG("[DatabaseManager] Enters getPeopleByAny");
@@ -868,6 +999,13 @@ QList<People> DatabaseManager::getPeopleByAny(QString text, int type, QString fi
 Tag DatabaseManager::getOneTagById(const int id)
 {
     Macaw::DEBUG("[DatabaseManager] Enters getOneTagById");
+    if (m_tagCache.contains(id)) {
+        m_cacheHits++;
+
+        return *m_tagCache.object(id);
+    }
+    m_cacheMisses++;
+
     Tag l_tag;
     QSqlQuery l_query(m_db);
     l_query.prepare("SELECT id, name "
@@ -885,6 +1023,7 @@ Tag DatabaseManager::getOneTagById(const int id)
     {
         l_tag.setId(l_query.value(0).toInt());
         l_tag.setName(l_query.value(1).toString());
+        m_tagCache.insert(id, new Tag(l_tag));
     }
 
     return l_tag;
@@ -995,6 +1134,33 @@ QList<Tag> DatabaseManager::getTagsUsed(const QString fieldOrder)
     return l_tagList;
 }
 
+/**
+ * @brief Get the ids of the tags of each movie, in one request
+ *
+ * @return QHash<int, QList<int> > ids of the tags, by movie id
+ */
+QHash<int, QList<int> > DatabaseManager::getTagIdsByMovieId()
+{
+    QHash<int, QList<int> > l_tagIdHash;
+    QSqlQuery l_query(m_db);
+    l_query.setForwardOnly(true);
+    l_query.prepare("SELECT id_movie, id_tag "
+                    "FROM movies_tags");
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getTagIdsByMovieId:");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        l_tagIdHash[l_query.value(0).toInt()].append(l_query.value(1).toInt());
+    }
+
+    return l_tagIdHash;
+}
+
 QList<Tag> DatabaseManager::getTagsByAny(const QString text, const QString fieldOrder)
 {
     Macaw::DEBUG("[DatabaseManager] Enters tagsByAny");
@@ -1142,6 +1308,35 @@ bool DatabaseManager::isMovieInPlaylist(Movie &movie, Playlist &playlist)
     return isMovieInPlaylist(movie.id(), playlist.id());
 }
 
+/**
+ * @brief Get the ids of the movies of a playlist, in one request
+ *
+ * @param int id of the playlist
+ * @return QSet<int>
+ */
+QSet<int> DatabaseManager::getMovieIdsByPlaylist(const int playlistId)
+{
+    QSet<int> l_movieIdSet;
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT id_movie "
+                    "FROM movies_playlists "
+                    "WHERE id_playlist = :id_playlist");
+    l_query.bindValue(":id_playlist", playlistId);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getMovieIdsByPlaylist():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while (l_query.next())
+    {
+        l_movieIdSet.insert(l_query.value(0).toInt());
+    }
+
+    return l_movieIdSet;
+}
+
 /**
  * @brief Retuns whether a movie is known by the database or not
  *
@@ -1206,6 +1401,218 @@ bool DatabaseManager::existTag(const QString name)
     return l_query.next();
 }
 
+/**
+ * @brief Checks if some fetch job is pending, or failed and due for a retry,
+ * as the ones returned by getMoviesToFetch() and getPeopleToFetch()
+ *
+ * @param int maxAttempts after which a failed job is not retried anymore
+ * @return bool
+ */
+bool DatabaseManager::existFetchJobs(const int maxAttempts)
+{
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT j.id FROM fetch_jobs AS j "
+                    "LEFT JOIN movies AS m "
+                      "ON j.type = :movie AND j.id_element = m.id "
+                    "LEFT JOIN people AS p "
+                      "ON j.type = :people AND j.id_element = p.id "
+                    "WHERE (m.imported = 0 OR p.imported = 0) "
+                      "AND (j.state = :pending "
+                           "OR (j.state = :failed "
+                               "AND j.attempts < :max_attempts "
+                               "AND j.next_retry <= :now)) "
+                    "LIMIT 1");
+    l_query.bindValue(":movie", Macaw::isMovie);
+    l_query.bindValue(":people", Macaw::isPeople);
+    l_query.bindValue(":pending", Macaw::FetchPending);
+    l_query.bindValue(":failed", Macaw::FetchFailed);
+    l_query.bindValue(":max_attempts", maxAttempts);
+    l_query.bindValue(":now", QDateTime::currentDateTime().toTime_t());
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In existFetchJobs():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    return l_query.next();
+}
+
+/**
+ * @brief Gets the movies whose fetch job is pending, or failed and due for a retry
+ *
+ * @param int maxAttempts after which a failed job is not retried anymore
+ * @return QList<Movie>
+ */
+QList<Movie> DatabaseManager::getMoviesToFetch(const int maxAttempts)
+{
+    QList<Movie> l_movieList;
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT " + m_movieFields +
+                    "FROM movies AS m, fetch_jobs AS j "
+                    "WHERE j.type = :type "
+                      "AND j.id_element = m.id "
+                      "AND m.imported = 0 "
+                      "AND (j.state = :pending "
+                           "OR (j.state = :failed "
+                               "AND j.attempts < :max_attempts "
+                               "AND j.next_retry <= :now)) "
+                    "ORDER BY j.id");
+    l_query.bindValue(":type", Macaw::isMovie);
+    l_query.bindValue(":pending", Macaw::FetchPending);
+    l_query.bindValue(":failed", Macaw::FetchFailed);
+    l_query.bindValue(":max_attempts", maxAttempts);
+    l_query.bindValue(":now", QDateTime::currentDateTime().toTime_t());
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getMoviesToFetch():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        Movie l_movie = hydrateMovieOnly(l_query);
+        l_movieList.append(l_movie);
+    }
+
+    return l_movieList;
+}
+
+/**
+ * @brief Gets the movies for which no result was accurate enough,
+ * so that the user chooses among the results
+ *
+ * @return QList<Movie>
+ */
+QList<Movie> DatabaseManager::getMoviesToReview()
+{
+    QList<Movie> l_movieList;
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT " + m_movieFields +
+                    "FROM movies AS m, fetch_jobs AS j "
+                    "WHERE j.type = :type "
+                      "AND j.id_element = m.id "
+                      "AND m.imported = 0 "
+                      "AND j.state = :review "
+                    "ORDER BY j.id");
+    l_query.bindValue(":type", Macaw::isMovie);
+    l_query.bindValue(":review", Macaw::FetchReview);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getMoviesToReview():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        Movie l_movie = hydrateMovieOnly(l_query);
+        l_movieList.append(l_movie);
+    }
+
+    return l_movieList;
+}
+
+/**
+ * @brief Gets the people whose fetch job is pending, or failed and due for a retry
+ *
+ * @param int maxAttempts after which a failed job is not retried anymore
+ * @return QList<People>
+ */
+QList<People> DatabaseManager::getPeopleToFetch(const int maxAttempts)
+{
+    QList<People> l_peopleList;
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT " + m_peopleFields +
+                    "FROM people AS p, fetch_jobs AS j "
+                    "WHERE j.type = :type "
+                      "AND j.id_element = p.id "
+                      "AND p.imported = 0 "
+                      "AND (j.state = :pending "
+                           "OR (j.state = :failed "
+                               "AND j.attempts < :max_attempts "
+                               "AND j.next_retry <= :now)) "
+                    "ORDER BY j.id");
+    l_query.bindValue(":type", Macaw::isPeople);
+    l_query.bindValue(":pending", Macaw::FetchPending);
+    l_query.bindValue(":failed", Macaw::FetchFailed);
+    l_query.bindValue(":max_attempts", maxAttempts);
+    l_query.bindValue(":now", QDateTime::currentDateTime().toTime_t());
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getPeopleToFetch():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    while(l_query.next())
+    {
+        People l_people = hydratePeople(l_query);
+        l_peopleList.append(l_people);
+    }
+
+    return l_peopleList;
+}
+
+/**
+ * @brief Gets the number of times the fetching of an element failed
+ *
+ * @param int type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param int id of the element
+ * @return int
+ */
+int DatabaseManager::getFetchJobAttempts(const int type, const int id)
+{
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT attempts FROM fetch_jobs "
+                    "WHERE type = :type AND id_element = :id_element");
+    l_query.bindValue(":type", type);
+    l_query.bindValue(":id_element", id);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getFetchJobAttempts():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    if (l_query.next())
+    {
+        return l_query.value(0).toInt();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gets the date of the next retry of a failed fetch job
+ *
+ * @param int maxAttempts after which a failed job is not retried anymore
+ * @return QDateTime, invalid if no retry is planned
+ */
+QDateTime DatabaseManager::getNextFetchRetry(const int maxAttempts)
+{
+    QDateTime l_nextRetry;
+    QSqlQuery l_query(m_db);
+    l_query.prepare("SELECT MIN(next_retry) FROM fetch_jobs "
+                    "WHERE state = :failed AND attempts < :max_attempts");
+    l_query.bindValue(":failed", Macaw::FetchFailed);
+    l_query.bindValue(":max_attempts", maxAttempts);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In getNextFetchRetry():");
+        Macaw::DEBUG(l_query.lastError().text());
+    }
+
+    if (l_query.next() && !l_query.value(0).isNull())
+    {
+        l_nextRetry = QDateTime::fromTime_t(l_query.value(0).toUInt());
+    }
+
+    return l_nextRetry;
+}
+
 /**
  * @brief Gets the people of a movie and adds it to the object
  * @param Movie
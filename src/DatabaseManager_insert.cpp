@@ -23,7 +23,10 @@
 #include <QSqlQuery>
 #include <QVariant>
 
+#include "enumerations.h"
+
 #include "MacawDebug.h"
+#include "SortKey.h"
 #include "Entities/Episode.h"
 #include "Entities/Movie.h"
 #include "Entities/PathForMovies.h"
@@ -38,6 +41,7 @@
  */
 bool DatabaseManager::insertNewMovie(Movie &movie, int moviesPathId)
 {
+    beginTransaction();
     QSqlQuery l_query(m_db);
     l_query.prepare("INSERT INTO movies ("
                                             "title, "
@@ -55,7 +59,8 @@ bool DatabaseManager::insertNewMovie(Movie &movie, int moviesPathId)
                                             "rank, "
                                             "imported, "
                                             "id_tmdb, "
-                                            "show"
+                                            "show, "
+                                            "title_sort"
                                         ") VALUES ("
                                             ":title, "
                                             ":original_title, "
@@ -72,7 +77,8 @@ bool DatabaseManager::insertNewMovie(Movie &movie, int moviesPathId)
                                             ":rank, "
                                             ":imported, "
                                             ":id_tmdb, "
-                                            ":show"
+                                            ":show, "
+                                            ":title_sort"
                                         ")");
     l_query.bindValue(":title", movie.title());
     l_query.bindValue(":original_title", movie.originalTitle()   );
@@ -90,11 +96,13 @@ bool DatabaseManager::insertNewMovie(Movie &movie, int moviesPathId)
     l_query.bindValue(":imported", movie.isImported());
     l_query.bindValue(":id_tmdb", movie.tmdbId());
     l_query.bindValue(":show", movie.isShow());
+    l_query.bindValue(":title_sort", SortKey::title(movie.title()));
 
     if (!l_query.exec())
     {
         Macaw::DEBUG("In insertNewMovie():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
@@ -102,17 +110,20 @@ bool DatabaseManager::insertNewMovie(Movie &movie, int moviesPathId)
     Macaw::DEBUG("[DatabaseManager] Movie added");
 
     movie.setId(l_query.lastInsertId().toInt());
+    recordChange(Macaw::isMovie, Macaw::Inserted, movie.id());
 
     for(int i = 0 ; i < movie.peopleList().size() ; i++)
     {
         People l_people = movie.peopleList().at(i);
         if (!addPeopleToMovie(l_people, movie, l_people.type()))
         {
+            rollbackTransaction();
+
             return false;
         }
     }
 
-    return true;
+    return commitTransaction();
 }
 
 /**
@@ -142,6 +153,7 @@ bool DatabaseManager::addPeopleToMovie(People &people, Movie &movie, const int t
 
         return false;
     }
+    recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
 
     return true;
 }
@@ -173,11 +185,66 @@ bool DatabaseManager::addTagToMovie(Tag &tag, Movie &movie)
 
         return false;
     }
+    recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
     movie = getOneMovieById(movie.id());
 
     return true;
 }
 
+/**
+ * @brief Adds the fetch jobs of a list of elements.
+ * Elements that already have a job are ignored, unless `reset` is true:
+ * their failures are then forgotten.
+ *
+ * @param int type of the elements (Macaw::isMovie or Macaw::isPeople)
+ * @param QList<int> ids of the elements
+ * @param bool reset
+ * @return bool
+ */
+bool DatabaseManager::addFetchJobs(const int type, const QList<int> &idList, const bool reset)
+{
+    QSqlQuery l_query(m_db);
+    beginTransaction();
+    foreach (int l_id, idList)
+    {
+        l_query.prepare("INSERT INTO fetch_jobs (type, id_element, state) "
+                        "VALUES (:type, :id_element, :state)");
+        l_query.bindValue(":type", type);
+        l_query.bindValue(":id_element", l_id);
+        l_query.bindValue(":state", Macaw::FetchPending);
+
+        if (!l_query.exec())
+        {
+            Macaw::DEBUG("In addFetchJobs():");
+            Macaw::DEBUG(l_query.lastError().text());
+            rollbackTransaction();
+
+            return false;
+        }
+
+        if (reset)
+        {
+            l_query.prepare("UPDATE fetch_jobs "
+                            "SET state = :state, attempts = 0, last_error = NULL, next_retry = 0 "
+                            "WHERE type = :type AND id_element = :id_element");
+            l_query.bindValue(":state", Macaw::FetchPending);
+            l_query.bindValue(":type", type);
+            l_query.bindValue(":id_element", l_id);
+
+            if (!l_query.exec())
+            {
+                Macaw::DEBUG("In addFetchJobs():");
+                Macaw::DEBUG(l_query.lastError().text());
+                rollbackTransaction();
+
+                return false;
+            }
+        }
+    }
+
+    return commitTransaction();
+}
+
 /**
  * @brief Adds a person to the database.
  * Should not be called directly.
@@ -188,13 +255,32 @@ bool DatabaseManager::addTagToMovie(Tag &tag, Movie &movie)
 bool DatabaseManager::insertNewPeople(People &people)
 {
     QSqlQuery l_query(m_db);
-    // If a people with the same name exist, we update it
+    // People coming from TMDb are identified by their TMDb id,
+    // the others by their name. If the person exists, we update it
     // else we insert
-    if(existPeople(people.name())) {
-        Macaw::DEBUG("[DatabaseManager.insertNewPeople] Name already known");
-        People l_peopleToUpdate = getOnePeopleByName(people.name());
-        people.setId(l_peopleToUpdate.id());
-        if(!updatePeople(people)) {
+    People l_knownPeople;
+    if (people.tmdbId() != 0) {
+        l_knownPeople = getOnePeopleByTmdbId(people.tmdbId());
+    }
+    if (l_knownPeople.id() == 0 && existPeople(people.name())) {
+        l_knownPeople = getOnePeopleByName(people.name());
+        // Homonyms are different people on TMDb
+        if (people.tmdbId() != 0 && l_knownPeople.tmdbId() != 0) {
+            l_knownPeople = People();
+        }
+    }
+
+    if (l_knownPeople.id() != 0) {
+        Macaw::DEBUG("[DatabaseManager.insertNewPeople] People already known");
+        people.setId(l_knownPeople.id());
+        if (l_knownPeople.isImported() && !people.isImported()) {
+            // Do not overwrite what has been fetched with partial data
+            people.setName(l_knownPeople.name());
+            people.setBirthday(l_knownPeople.birthday());
+            people.setBiography(l_knownPeople.biography());
+            people.setTmdbId(l_knownPeople.tmdbId());
+            people.setImported(true);
+        } else if(!updatePeople(people)) {
 
             return false;
         }
@@ -204,13 +290,15 @@ bool DatabaseManager::insertNewPeople(People &people)
                                                 "birthday, "
                                                 "biography, "
                                                 "imported, "
-                                                "id_tmdb "
+                                                "id_tmdb, "
+                                                "name_sort "
                                             ") VALUES ("
                                                 ":name, "
                                                 ":birthday, "
                                                 ":biography, "
                                                 ":imported, "
-                                                ":id_tmdb "
+                                                ":id_tmdb, "
+                                                ":name_sort "
                                             ")"
                         );
         l_query.bindValue(":name", people.name());
@@ -218,6 +306,7 @@ bool DatabaseManager::insertNewPeople(People &people)
         l_query.bindValue(":biography", people.biography());
         l_query.bindValue(":imported", people.isImported());
         l_query.bindValue(":id_tmdb", people.tmdbId());
+        l_query.bindValue(":name_sort", SortKey::name(people.name()));
 
         if (!l_query.exec()) {
             Macaw::DEBUG("In insertNewPeople():");
@@ -226,6 +315,7 @@ bool DatabaseManager::insertNewPeople(People &people)
             return false;
         }
         people.setId(l_query.lastInsertId().toInt());
+        recordChange(Macaw::isPeople, Macaw::Inserted, people.id());
     }
 
     return true;
@@ -253,6 +343,7 @@ bool DatabaseManager::insertNewTag(Tag &tag)
         return false;
     }
     tag.setId(l_query.lastInsertId().toInt());
+    recordChange(Macaw::isTag, Macaw::Inserted, tag.id());
 
     return true;
 }
@@ -280,6 +371,7 @@ bool DatabaseManager::insertNewPlaylist(Playlist &playlist)
         return false;
     }
     playlist.setId(l_query.lastInsertId().toInt());
+    recordChange(Macaw::isPlaylist, Macaw::Inserted, playlist.id());
 
     return true;
 }
@@ -23,7 +23,10 @@
 #include <QSqlQuery>
 #include <QVariant>
 
+#include "enumerations.h"
+
 #include "MacawDebug.h"
+#include "SortKey.h"
 #include "Entities/Episode.h"
 #include "Entities/Movie.h"
 #include "Entities/PathForMovies.h"
@@ -39,9 +42,11 @@
 bool DatabaseManager::updateMovie(Movie &movie)
 {
     Macaw::DEBUG("[DatabaseManager] Enters updateMovie()");
+    beginTransaction();
     QSqlQuery l_query(m_db);
     l_query.prepare("UPDATE movies "
                     "SET title = :title, "
+                        "title_sort = :title_sort, "
                         "original_title = :original_title, "
                         "release_date = :release_date, "
                         "country = :country, "
@@ -54,6 +59,7 @@ bool DatabaseManager::updateMovie(Movie &movie)
                         "id_tmdb = :id_tmdb "
                     "WHERE id = :id");
     l_query.bindValue(":title", movie.title());
+    l_query.bindValue(":title_sort", SortKey::title(movie.title()));
     l_query.bindValue(":original_title", movie.originalTitle());
     l_query.bindValue(":release_date", movie.releaseDate().toString(DATE_FORMAT));
     l_query.bindValue(":country", movie.country());
@@ -71,9 +77,11 @@ bool DatabaseManager::updateMovie(Movie &movie)
     {
         Macaw::DEBUG("In updateMovie():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
+    recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
 
     // Insertions/Updates of the linked elements
     foreach (People l_people, movie.peopleList())
@@ -99,6 +107,7 @@ bool DatabaseManager::updateMovie(Movie &movie)
     {
         Macaw::DEBUG("In updateMovie():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
@@ -128,6 +137,7 @@ bool DatabaseManager::updateMovie(Movie &movie)
         {
             Macaw::DEBUG("In updateMovie():");
             Macaw::DEBUG(l_query.lastError().text());
+            rollbackTransaction();
 
             return false;
         }
@@ -144,7 +154,7 @@ bool DatabaseManager::updateMovie(Movie &movie)
 
     Macaw::DEBUG("[DatabaseManager] Movie updated");
 
-    return true;
+    return commitTransaction();
 }
 
 /**
@@ -160,12 +170,14 @@ bool DatabaseManager::updatePeople(People &people)
     QSqlQuery l_query(m_db);
     l_query.prepare("UPDATE people "
                     "SET name = :name, "
+                        "name_sort = :name_sort, "
                         "birthday = :birthday, "
                         "biography = :biography, "
                         "imported = :imported, "
                         "id_tmdb = :id_tmdb "
                     "WHERE id = :id");
     l_query.bindValue(":name", people.name());
+    l_query.bindValue(":name_sort", SortKey::name(people.name()));
     l_query.bindValue(":birthday",  people.birthday().toString(DATE_FORMAT));
     l_query.bindValue(":biography", people.biography());
     l_query.bindValue(":imported", people.isImported());
@@ -179,6 +191,7 @@ bool DatabaseManager::updatePeople(People &people)
 
         return false;
     }
+    recordChange(Macaw::isPeople, Macaw::Updated, people.id());
 
     return true;
 }
@@ -239,6 +252,7 @@ bool DatabaseManager::updatePeopleInMovie(People &people,
 
                 return false;
             }
+            recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
         }
     }
 
@@ -267,6 +281,7 @@ bool DatabaseManager::updateTag(Tag &tag)
 
         return false;
     }
+    recordChange(Macaw::isTag, Macaw::Updated, tag.id());
 
     return true;
 }
@@ -321,6 +336,7 @@ bool DatabaseManager::updateTagInMovie(Tag &tag, Movie &movie)
 
                 return false;
             }
+            recordChange(Macaw::isMovie, Macaw::Updated, movie.id());
         }
     }
 
@@ -336,6 +352,7 @@ bool DatabaseManager::updateTagInMovie(Tag &tag, Movie &movie)
 bool DatabaseManager::updatePlaylist(Playlist &playlist)
 {
     Macaw::DEBUG("[DatabaseManager] Enters updatePlaylist()");
+    beginTransaction();
     QSqlQuery l_query(m_db);
     l_query.prepare("UPDATE playlists "
                     "SET name = :name, "
@@ -349,9 +366,11 @@ bool DatabaseManager::updatePlaylist(Playlist &playlist)
     {
         Macaw::DEBUG("In updatePlaylist():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
+    recordChange(Macaw::isPlaylist, Macaw::Updated, playlist.id());
 
     // Insertions/Updates of the linked elements
     foreach (Movie l_movie, playlist.movieList())
@@ -368,6 +387,7 @@ bool DatabaseManager::updatePlaylist(Playlist &playlist)
     {
         Macaw::DEBUG("In updatePlaylist():");
         Macaw::DEBUG(l_query.lastError().text());
+        rollbackTransaction();
 
         return false;
     }
@@ -382,7 +402,7 @@ bool DatabaseManager::updatePlaylist(Playlist &playlist)
 
     Macaw::DEBUG("[DatabaseManager] Playlist updated");
 
-    return true;
+    return commitTransaction();
 }
 
 /**
@@ -423,6 +443,76 @@ bool DatabaseManager::updateMovieInPlaylist(Movie &movie, Playlist &playlist)
 
             return false;
         }
+        recordChange(Macaw::isPlaylist, Macaw::Updated, playlist.id());
+    }
+
+    return true;
+}
+
+/**
+ * @brief Records the failure of a fetch job
+ *
+ * @param int type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param int id of the element
+ * @param QString error to record
+ * @param QDateTime nextRetry: date before which the job is not retried
+ * @return bool
+ */
+bool DatabaseManager::setFetchJobFailed(const int type,
+                                       const int id,
+                                       const QString error,
+                                       const QDateTime nextRetry)
+{
+    QSqlQuery l_query(m_db);
+    l_query.prepare("UPDATE fetch_jobs "
+                    "SET state = :state, "
+                        "attempts = attempts + 1, "
+                        "last_error = :last_error, "
+                        "next_retry = :next_retry "
+                    "WHERE type = :type AND id_element = :id_element");
+    l_query.bindValue(":state", Macaw::FetchFailed);
+    l_query.bindValue(":last_error", error);
+    l_query.bindValue(":next_retry", nextRetry.toTime_t());
+    l_query.bindValue(":type", type);
+    l_query.bindValue(":id_element", id);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In setFetchJobFailed():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Puts a fetch job aside until the user reviews it
+ *
+ * @param int type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param int id of the element
+ * @param QString reason why the job needs a review
+ * @return bool
+ */
+bool DatabaseManager::setFetchJobToReview(const int type, const int id, const QString reason)
+{
+    QSqlQuery l_query(m_db);
+    l_query.prepare("UPDATE fetch_jobs "
+                    "SET state = :state, "
+                        "last_error = :last_error "
+                    "WHERE type = :type AND id_element = :id_element");
+    l_query.bindValue(":state", Macaw::FetchReview);
+    l_query.bindValue(":last_error", reason);
+    l_query.bindValue(":type", type);
+    l_query.bindValue(":id_element", id);
+
+    if (!l_query.exec())
+    {
+        Macaw::DEBUG("In setFetchJobToReview():");
+        Macaw::DEBUG(l_query.lastError().text());
+
+        return false;
     }
 
     return true;
@@ -0,0 +1,138 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OrphansDialog.h"
+#include "ui_OrphansDialog.h"
+
+#include <QSettings>
+
+#include "enumerations.h"
+
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ * @param parent
+ */
+OrphansDialog::OrphansDialog(QWidget *parent) :
+    QDialog(parent),
+    m_ui(new Ui::OrphansDialog)
+{
+    Macaw::DEBUG("[OrphansDialog] Constructor called");
+
+    m_ui->setupUi(this);
+    this->setWindowTitle(tr("Unused People and Tags"));
+    this->setAttribute(Qt::WA_DeleteOnClose);
+
+    m_ui->orphanListWidget->setSelectionMode(QAbstractItemView::NoSelection);
+
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    m_ui->autoCleanupCheckBox->setChecked(l_settings.value("orphans/autoCleanup", false).toBool());
+
+    Macaw::DEBUG("[OrphansDialog] Construction done");
+}
+
+/**
+ * @brief Destructor
+ */
+OrphansDialog::~OrphansDialog()
+{
+    delete m_ui;
+    Macaw::DEBUG("[OrphansDialog] Destructed");
+}
+
+/**
+ * @brief Adds orphans to the list, all checked for deletion.
+ * Orphans already listed are ignored, so that the sweeps done while
+ * the dialog is open end in the same list.
+ *
+ * @param peopleList: people not linked to any movie anymore
+ * @param tagList: tags not used in any movie anymore
+ */
+void OrphansDialog::addOrphans(const QList<People> &peopleList, const QList<Tag> &tagList)
+{
+    foreach (People l_people, peopleList) {
+        if (m_peopleHash.contains(l_people.id())) {
+            continue;
+        }
+        m_peopleHash.insert(l_people.id(), l_people);
+
+        QListWidgetItem *l_item = new QListWidgetItem(l_people.name(), m_ui->orphanListWidget);
+        l_item->setFlags(l_item->flags() | Qt::ItemIsUserCheckable);
+        l_item->setCheckState(Qt::Checked);
+        l_item->setData(Macaw::ObjectId, l_people.id());
+        l_item->setData(Macaw::ObjectType, Macaw::isPeople);
+    }
+    foreach (Tag l_tag, tagList) {
+        if (m_tagHash.contains(l_tag.id())) {
+            continue;
+        }
+        m_tagHash.insert(l_tag.id(), l_tag);
+
+        QListWidgetItem *l_item = new QListWidgetItem(tr("Tag: %1").arg(l_tag.name()), m_ui->orphanListWidget);
+        l_item->setFlags(l_item->flags() | Qt::ItemIsUserCheckable);
+        l_item->setCheckState(Qt::Checked);
+        l_item->setData(Macaw::ObjectId, l_tag.id());
+        l_item->setData(Macaw::ObjectType, Macaw::isTag);
+    }
+
+    this->updateText();
+}
+
+/**
+ * @brief Slot triggered when the user validates the dialog.
+ * Saves the cleanup policy and sends the checked orphans.
+ */
+void OrphansDialog::on_buttonBox_accepted()
+{
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    l_settings.setValue("orphans/autoCleanup", m_ui->autoCleanupCheckBox->isChecked());
+
+    QList<People> l_peopleList;
+    QList<Tag> l_tagList;
+    for (int i = 0 ; i < m_ui->orphanListWidget->count() ; i++) {
+        QListWidgetItem *l_item = m_ui->orphanListWidget->item(i);
+        if (l_item->checkState() != Qt::Checked) {
+            continue;
+        }
+
+        int l_id = l_item->data(Macaw::ObjectId).toInt();
+        if (l_item->data(Macaw::ObjectType).toInt() == Macaw::isPeople) {
+            l_peopleList.append(m_peopleHash.value(l_id));
+        } else {
+            l_tagList.append(m_tagHash.value(l_id));
+        }
+    }
+
+    if (!l_peopleList.isEmpty() || !l_tagList.isEmpty()) {
+        emit orphansAccepted(l_peopleList, l_tagList);
+    }
+    this->accept();
+}
+
+/**
+ * @brief Updates the message with the number of orphans listed
+ */
+void OrphansDialog::updateText()
+{
+    m_ui->messageLabel->setText(tr("%1 people and %2 tags are not linked to any movie now. "
+                                   "Do you want to delete the checked ones?")
+                                .arg(m_peopleHash.size())
+                                .arg(m_tagHash.size()));
+}
@@ -0,0 +1,60 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ORPHANSDIALOG_H
+#define ORPHANSDIALOG_H
+
+#include <QDialog>
+#include <QHash>
+
+#include "Entities/People.h"
+#include "Entities/Tag.h"
+
+namespace Ui {
+class OrphansDialog;
+}
+
+/**
+ * @brief Dialog listing the people and the tags not linked to any movie anymore.
+ * The user chooses which ones are deleted, and can ask to delete them
+ * automatically from now on.
+ */
+class OrphansDialog : public QDialog
+{
+Q_OBJECT
+
+public:
+    explicit OrphansDialog(QWidget *parent = 0);
+    ~OrphansDialog();
+    void addOrphans(const QList<People> &peopleList, const QList<Tag> &tagList);
+
+signals:
+    void orphansAccepted(const QList<People> &peopleList, const QList<Tag> &tagList);
+
+private slots:
+    void on_buttonBox_accepted();
+
+private:
+    Ui::OrphansDialog *m_ui;
+    QHash<int, People> m_peopleHash;
+    QHash<int, Tag> m_tagHash;
+    void updateText();
+};
+
+#endif // ORPHANSDIALOG_H
@@ -22,6 +22,7 @@
 
 #include <QDir>
 #include <QFileDialog>
+#include <QSettings>
 
 #include "MacawDebug.h"
 #include "ServicesManager.h"
@@ -48,6 +49,9 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
     QString l_mediaPlayerPath(databaseManager->getMediaPlayerPath());
     m_ui->playerPathEdit->setText(l_mediaPlayerPath);
 
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    m_ui->autoCleanupCheckBox->setChecked(l_settings.value("orphans/autoCleanup", false).toBool());
+
     Macaw::DEBUG_OUT("[SettingsDialog] Construction done");
 }
 
@@ -75,6 +79,9 @@ void SettingsDialog::on_buttonBox_accepted()
         databaseManager->addMediaPlayerPath(m_ui->playerPathEdit->text());
     }
 
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    l_settings.setValue("orphans/autoCleanup", m_ui->autoCleanupCheckBox->isChecked());
+
     emit closeAndSave();
     close();
     Macaw::DEBUG_OUT("[SettingsDialog] Exits on_buttonBox_accepted()");
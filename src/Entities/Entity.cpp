@@ -19,31 +19,47 @@
 
 #include "Entity.h"
 
+template<> EntityData *QSharedDataPointer<EntityData>::clone()
+{
+    return d->clone();
+}
+
 Entity::Entity(const QString name) :
-    m_id(0),
-    m_name(name)
+    d(new EntityData)
 {
+    d->m_name = name;
+}
 
+/**
+ * @brief Constructor for the entities with more data
+ *
+ * @param data: derived from EntityData, owned by the entity
+ * @param name
+ */
+Entity::Entity(EntityData *data, const QString name) :
+    d(data)
+{
+    d->m_name = name;
 }
 
 int Entity::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
 void Entity::setId(int id)
 {
-    m_id = id;
+    d->m_id = id;
 }
 
 QString Entity::name() const
 {
-    return m_name;
+    return d->m_name;
 }
 
 void Entity::setName(const QString name)
 {
-    m_name = name;
+    d->m_name = name;
 }
 
 bool Entity::operator== (const Entity &other)
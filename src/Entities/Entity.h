@@ -20,12 +20,33 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include <QSharedData>
 #include <QString>
 
 class QString;
 
 /**
- * @brief The Entity class
+ * @brief Data of an Entity, shared between its copies.
+ * The entities with more data derive it, and reimplement clone()
+ * so that a copy is detached with its whole data.
+ */
+class EntityData : public QSharedData
+{
+public:
+    EntityData() : m_id(0) {}
+    virtual ~EntityData() {}
+    virtual EntityData *clone() const { return new EntityData(*this); }
+
+    int m_id;
+    QString m_name;
+};
+
+template<> EntityData *QSharedDataPointer<EntityData>::clone();
+
+/**
+ * @brief The Entity class.
+ * Entities are implicitly shared: a copy only costs a reference count,
+ * until one of the copies is modified.
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
@@ -41,8 +62,8 @@ public:
     bool operator!= (const Entity &other);
 
 protected:
-    int m_id;
-    QString m_name;
+    Entity(EntityData *data, const QString name);
+    QSharedDataPointer<EntityData> d;
 };
 
 #endif // ENTITY_H
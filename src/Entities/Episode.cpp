@@ -19,61 +19,91 @@
 
 #include "Episode.h"
 
-Episode::Episode():
-    m_id(0),
-    m_season(0),
-    m_number(0)
+class EpisodeData : public QSharedData
 {
+public:
+    EpisodeData() :
+        m_id(0),
+        m_season(0),
+        m_number(0)
+    {}
+
+    int m_id;
+    Show m_show;
+    Movie m_movie;
+    int m_season;
+    int m_number;
+};
+
+Episode::Episode() :
+    d(new EpisodeData)
+{
+}
+
+Episode::Episode(const Episode &other) :
+    d(other.d)
+{
+}
+
+Episode::~Episode()
+{
+}
+
+Episode &Episode::operator= (const Episode &other)
+{
+    d = other.d;
+
+    return *this;
 }
 
 int Episode::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
 void Episode::setId(const int id)
 {
-    m_id = id;
+    d->m_id = id;
 }
 
 int Episode::number() const
 {
-    return m_number;
+    return d->m_number;
 }
 
 void Episode::setNumber(const int number)
 {
-    m_number = number;
+    d->m_number = number;
 }
 
 Movie Episode::movie() const
 {
-    return m_movie;
+    return d->m_movie;
 }
 
 void Episode::setMovie(const Movie &movie)
 {
-    m_movie = movie;
+    d->m_movie = movie;
 }
 
 int Episode::season() const
 {
-    return m_season;
+    return d->m_season;
 }
 
 void Episode::setSeason(const int season)
 {
-    m_season = season;
+    d->m_season = season;
 }
 
 Show Episode::show() const
 {
-    return m_show;
+    return d->m_show;
 }
 
 void Episode::setShow(const Show &show)
 {
-    m_show = show;
+    d->m_show = show;
 }
 
 bool Episode::operator== (const Episode &other)
@@ -20,14 +20,19 @@
 #ifndef EPISODE_H
 #define EPISODE_H
 
+#include <QSharedDataPointer>
+
 #include "Entities/Movie.h"
 #include "Entities/Show.h"
 
+class EpisodeData;
 class Movie;
 class Show;
 
 /**
- * @brief The Episode class
+ * @brief The Episode class.
+ * Episodes are implicitly shared: a copy only costs a reference count,
+ * until one of the copies is modified.
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
@@ -35,6 +40,13 @@ class Episode
 {
 public:
     explicit Episode();
+    Episode(const Episode &other);
+    ~Episode();
+    Episode &operator= (const Episode &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    Episode(Episode &&other) Q_DECL_NOTHROW { d.swap(other.d); }
+    Episode &operator= (Episode &&other) Q_DECL_NOTHROW { d.swap(other.d); return *this; }
+#endif
     int id() const;
     void setId(const int id);
     int number() const;
@@ -49,11 +61,7 @@ public:
     bool operator!= (const Episode&);
 
 private:
-    int m_id;
-    Show m_show;
-    Movie m_movie;
-    int m_season;
-    int m_number;
+    QSharedDataPointer<EpisodeData> d;
 };
 
 #endif // EPISODE
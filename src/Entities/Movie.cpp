@@ -19,203 +19,247 @@
 
 #include "Movie.h"
 
-Movie::Movie()
-{
-    m_id = 0;
-    m_title = "";
-    m_originalTitle = "";
-    m_country =  "";
-    m_synopsis = "";
-    m_fileRelativePath = "";
-    m_fileAbsolutePath = "";
-    m_colored = true;
-    m_format = "";
-    m_suffix = "";
-    m_rank = 0;
-    m_imported = false;
-    m_show = false;
-    m_tmdbId = 0;
+class MovieData : public QSharedData
+{
+public:
+    MovieData() :
+        m_id(0),
+        m_title(""),
+        m_originalTitle(""),
+        m_colored(true),
+        m_country(""),
+        m_fileAbsolutePath(""),
+        m_fileRelativePath(""),
+        m_format(""),
+        m_imported(false),
+        m_rank(0),
+        m_show(false),
+        m_suffix(""),
+        m_synopsis(""),
+        m_tmdbId(0)
+    {}
+
+    int m_id;
+    QString m_title;
+    QString m_originalTitle;
+    bool m_colored;
+    QString m_country;
+    QTime m_duration;
+    QString m_fileAbsolutePath;
+    QString m_fileRelativePath;
+    QString m_format;
+    bool m_imported;
+    QString m_posterPath;
+    int m_rank;
+    QDate m_releaseDate;
+    bool m_show;
+    QString m_suffix;
+    QString m_synopsis;
+    QList<People> m_peopleList;
+    QList<Tag> m_tagList;
+    int m_tmdbId;
+};
+
+Movie::Movie() :
+    d(new MovieData)
+{
+}
+
+Movie::Movie(const Movie &other) :
+    d(other.d)
+{
+}
+
+Movie::~Movie()
+{
+}
+
+Movie &Movie::operator= (const Movie &other)
+{
+    d = other.d;
+
+    return *this;
 }
 
 int Movie::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
 void Movie::setId(const int id)
 {
-    m_id = id;
+    d->m_id = id;
 }
 
 QString Movie::title() const
 {
-    return m_title;
+    return d->m_title;
 }
 
 void Movie::setTitle(const QString title)
 {
-    m_title = title;
+    d->m_title = title;
 }
 
 QString Movie::originalTitle() const
 {
-    return m_originalTitle;
+    return d->m_originalTitle;
 }
 
 void Movie::setOriginalTitle(const QString originalTitle)
 {
-    m_originalTitle = originalTitle;
+    d->m_originalTitle = originalTitle;
 }
 
 QDate Movie::releaseDate() const
 {
-    return m_releaseDate;
+    return d->m_releaseDate;
 }
 
 void Movie::setReleaseDate(const QDate releaseDate)
 {
-    m_releaseDate = releaseDate;
+    d->m_releaseDate = releaseDate;
 }
 
 bool Movie::isShow() const
 {
-    return m_show;
+    return d->m_show;
 }
 
 void Movie::setShow(const bool show)
 {
-    m_show = show;
+    d->m_show = show;
 }
 
 QString Movie::country() const
 {
-    return m_country;
+    return d->m_country;
 }
 
 void Movie::setCountry(const QString country)
 {
-    m_country = country;
+    d->m_country = country;
 }
 
 QTime Movie::duration() const
 {
-    return m_duration;
+    return d->m_duration;
 }
 
 void Movie::setDuration(const QTime duration)
 {
-    m_duration = duration;
+    d->m_duration = duration;
 }
 
 QString Movie::fileRelativePath() const
 {
-    return m_fileRelativePath;
+    return d->m_fileRelativePath;
 }
 
 void Movie::setFileRelativePath(const QString fileRelativePath)
 {
-    m_fileRelativePath = fileRelativePath;
+    d->m_fileRelativePath = fileRelativePath;
 }
 
 QString Movie::fileAbsolutePath() const
 {
-    return m_fileAbsolutePath;
+    return d->m_fileAbsolutePath;
 }
 
 void Movie::setFileAbsolutePath(const QString fileAbsolutePath)
 {
-    m_fileAbsolutePath = fileAbsolutePath;
+    d->m_fileAbsolutePath = fileAbsolutePath;
 }
 
 QString Movie::synopsis() const
 {
-    return m_synopsis;
+    return d->m_synopsis;
 }
 
 void Movie::setSynopsis(const QString synopsis)
 {
-    m_synopsis = synopsis;
+    d->m_synopsis = synopsis;
 }
 
 int Movie::tmdbId() const
 {
-    return m_tmdbId;
+    return d->m_tmdbId;
 }
 
 void Movie::setTmdbId(const int id)
 {
-    m_tmdbId = id;
+    d->m_tmdbId = id;
 }
 
 QString Movie::posterPath() const
 {
-    return m_posterPath;
+    return d->m_posterPath;
 }
 
 void Movie::setPosterPath(const QString posterPath)
 {
-    m_posterPath = posterPath;
+    d->m_posterPath = posterPath;
 }
 
 bool Movie::isColored() const
 {
-    return m_colored;
+    return d->m_colored;
 }
 
 void Movie::setColored(const bool colored)
 {
-    m_colored = colored;
+    d->m_colored = colored;
 }
 
 QString Movie::format() const
 {
-    return m_format;
+    return d->m_format;
 }
 
 void Movie::setFormat(const QString format)
 {
-    m_format = format;
+    d->m_format = format;
 }
 
 QString Movie::suffix() const
 {
-    return m_suffix;
+    return d->m_suffix;
 }
 
 void Movie::setSuffix(const QString suffix)
 {
-    m_suffix = suffix;
+    d->m_suffix = suffix;
 }
 
 int Movie::rank() const
 {
-    return m_rank;
+    return d->m_rank;
 }
 
 void Movie::setRank(const int rank)
 {
-    m_rank = rank;
+    d->m_rank = rank;
 }
 
 bool Movie::isImported() const
 {
-    return m_imported;
+    return d->m_imported;
 }
 
 void Movie::setImported(const bool imported)
 {
-    m_imported = imported;
+    d->m_imported = imported;
 }
 
 QList<People> Movie::peopleList() const
 {
-    return m_peopleList;
+    return d->m_peopleList;
 }
 
 QList<People> Movie::peopleList(const int type) const
 {
     QList<People> l_peopleList;
-    foreach (People l_people, m_peopleList)
+    foreach (People l_people, d->m_peopleList)
     {
         if (l_people.type() == type)
         {
@@ -228,49 +272,49 @@ QList<People> Movie::peopleList(const int type) const
 
 void Movie::setPeopleList(const QList<People> &peopleList)
 {
-    m_peopleList = peopleList;
+    d->m_peopleList = peopleList;
 }
 
 void Movie::addPeople(const People &people)
 {
-    m_peopleList.append(people);
+    d->m_peopleList.append(people);
 }
 
 void Movie::removePeople(const People &people)
 {
-    m_peopleList.removeAll(people);
+    d->m_peopleList.removeAll(people);
 }
 
 void Movie::updatePeople(const People &people)
 {
-    for (int i = 0 ; i < m_peopleList.size() ; i++)
+    for (int i = 0 ; i < d->m_peopleList.size() ; i++)
     {
-        if(m_peopleList.at(i).id() == people.id())
+        if(d->m_peopleList.at(i).id() == people.id())
         {
-            m_peopleList.replace(i, people);
+            d->m_peopleList.replace(i, people);
         }
    }
 }
 
 QList<Tag> Movie::tagList()  const
 {
-    return m_tagList;
+    return d->m_tagList;
 }
 
 
 void Movie::setTagList(const QList<Tag> &tagList)
 {
-    m_tagList = tagList;
+    d->m_tagList = tagList;
 }
 
 void Movie::addTag(const Tag &tag)
 {
-    m_tagList.append(tag);
+    d->m_tagList.append(tag);
 }
 
 void Movie::removeTag(const Tag &tag)
 {
-    m_tagList.removeAll(tag);
+    d->m_tagList.removeAll(tag);
 }
 
 
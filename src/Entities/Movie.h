@@ -20,6 +20,8 @@
 #ifndef MOVIE_H
 #define MOVIE_H
 
+#include <QMetaType>
+#include <QSharedDataPointer>
 #include <QString>
 
 #include "Entities/People.h"
@@ -29,11 +31,14 @@ class QDate;
 template<class T> class QList;
 class QString;
 
+class MovieData;
 class People;
 class Tag;
 
 /**
- * @brief The Movie class
+ * @brief The Movie class.
+ * Movies are implicitly shared: a copy only costs a reference count,
+ * until one of the copies is modified.
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
@@ -41,6 +46,13 @@ class  Movie
 {
 public:
     explicit Movie();
+    Movie(const Movie &other);
+    ~Movie();
+    Movie &operator= (const Movie &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    Movie(Movie &&other) Q_DECL_NOTHROW { d.swap(other.d); }
+    Movie &operator= (Movie &&other) Q_DECL_NOTHROW { d.swap(other.d); return *this; }
+#endif
     int id() const;
     void setId(const int id);
     QString title() const;
@@ -90,25 +102,9 @@ public:
     bool operator!= (const Movie &other);
 
 private:
-    int m_id;
-    QString m_title;
-    QString m_originalTitle;
-    bool m_colored;
-    QString m_country;
-    QTime m_duration;
-    QString m_fileAbsolutePath;
-    QString m_fileRelativePath;
-    QString m_format;
-    bool m_imported;
-    QString m_posterPath;
-    int m_rank;
-    QDate m_releaseDate;
-    bool m_show;
-    QString m_suffix;
-    QString m_synopsis;
-    QList<People> m_peopleList;
-    QList<Tag> m_tagList;
-    int m_tmdbId;
+    QSharedDataPointer<MovieData> d;
 };
 
+Q_DECLARE_METATYPE(Movie)
+
 #endif // MOVIE_H
@@ -19,62 +19,82 @@
 
 #include "People.h"
 
+class PeopleData : public EntityData
+{
+public:
+    PeopleData() : m_biography(""), m_type(People::None), m_tmdbId(0), m_imported(false) {}
+    EntityData *clone() const { return new PeopleData(*this); }
+
+    QDate m_birthday;
+    QString m_biography;
+    int m_type;
+    int m_tmdbId;
+    bool m_imported;
+};
+
 People::People(const QString name) :
-    Entity(name)
+    Entity(new PeopleData, name)
+{
+}
+
+PeopleData *People::data()
+{
+    return static_cast<PeopleData *>(d.data());
+}
+
+const PeopleData *People::data() const
 {
-    m_biography = "";
-    m_tmdbId = 0;
-    m_imported = false;
+    return static_cast<const PeopleData *>(d.constData());
 }
 
 QDate People::birthday() const
 {
-    return m_birthday;
+    return data()->m_birthday;
 }
 
 void People::setBirthday(const QDate birthday)
 {
-    m_birthday = birthday;
+    data()->m_birthday = birthday;
 }
 
 QString People::biography() const
 {
-    return m_biography;
+    return data()->m_biography;
 }
 
 void People::setBiography(const QString biography)
 {
-    m_biography = biography;
+    data()->m_biography = biography;
 }
 
 int People::type() const
 {
-    return m_type;
+    return data()->m_type;
 }
 
 void People::setType(const int type)
 {
-    m_type = type;
+    data()->m_type = type;
 }
 
 int People::tmdbId() const
 {
-    return m_tmdbId;
+    return data()->m_tmdbId;
 }
 
 void People::setTmdbId(const int id)
 {
-    m_tmdbId = id;
+    data()->m_tmdbId = id;
 }
 
 bool People::isImported() const
 {
-    return m_imported;
+    return data()->m_imported;
 }
 
 void People::setImported(const bool imported)
 {
-    m_imported = imported;
+    data()->m_imported = imported;
 }
 
 bool People::operator== (const People &other)
@@ -21,12 +21,15 @@
 #define PEOPLE_H
 
 #include <QDate>
+#include <QMetaType>
 
 #include "Entities/Entity.h"
 
 class QDate;
 class QString;
 
+class PeopleData;
+
 /**
  * @brief The People class
  *
@@ -52,11 +55,10 @@ public:
     enum typePeople {None, Director, Producer, Actor};
 
 private:
-    QDate m_birthday;
-    QString m_biography;
-    int m_type;
-    int m_tmdbId;
-    bool m_imported;
+    PeopleData *data();
+    const PeopleData *data() const;
 };
 
+Q_DECLARE_METATYPE(People)
+
 #endif // PEOPLE_H
@@ -19,50 +19,69 @@
 
 #include "Playlist.h"
 
+class PlaylistData : public EntityData
+{
+public:
+    PlaylistData() : m_rate(0), m_creationDate(QDateTime::currentDateTime()) {}
+    EntityData *clone() const { return new PlaylistData(*this); }
+
+    int m_rate;
+    QDateTime m_creationDate;
+    QList<Movie> m_movieList;
+};
+
 Playlist::Playlist(const QString name):
-    Entity(name),
-    m_rate(0),
-    m_creationDate(QDateTime::currentDateTime())
+    Entity(new PlaylistData, name)
+{
+}
+
+PlaylistData *Playlist::data()
+{
+    return static_cast<PlaylistData *>(d.data());
+}
+
+const PlaylistData *Playlist::data() const
 {
+    return static_cast<const PlaylistData *>(d.constData());
 }
 
 int Playlist::rate() const
 {
-    return m_rate;
+    return data()->m_rate;
 }
 
 void Playlist::setRate(const int rate)
 {
-    m_rate = rate;
+    data()->m_rate = rate;
 }
 
 QDateTime Playlist::creationDate() const
 {
-    return m_creationDate;
+    return data()->m_creationDate;
 }
 
 void Playlist::setCreationDate(const QDateTime creationDate)
 {
-    m_creationDate = creationDate;
+    data()->m_creationDate = creationDate;
 }
 
 QList<Movie> Playlist::movieList() const
 {
-    return m_movieList;
+    return data()->m_movieList;
 }
 void Playlist::setMovieList(const QList<Movie> &movieList)
 {
-    m_movieList = movieList;
+    data()->m_movieList = movieList;
 }
 
 void Playlist::addMovie(const Movie &movie)
 {
-    m_movieList.append(movie);
+    data()->m_movieList.append(movie);
 }
 
 void Playlist::removeMovie(const Movie &movie)
 {
-    m_movieList.removeAll(movie);
+    data()->m_movieList.removeAll(movie);
 }
 
 /**
@@ -71,11 +90,11 @@ void Playlist::removeMovie(const Movie &movie)
  */
 void Playlist::updateMovie(const Movie &movie)
 {
-    for (int i = 0 ; i < m_movieList.size() ; i++)
+    for (int i = 0 ; i < data()->m_movieList.size() ; i++)
     {
-        if(m_movieList.at(i).id() == movie.id())
+        if(data()->m_movieList.at(i).id() == movie.id())
         {
-            m_movieList.replace(i, movie);
+            data()->m_movieList.replace(i, movie);
         }
     }
 }
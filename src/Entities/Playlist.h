@@ -28,6 +28,7 @@ class QDateTime;
 template<class T> class QList;
 
 class Movie;
+class PlaylistData;
 
 /**
  * @brief The Playlist class
@@ -50,9 +51,8 @@ public:
     enum typePlaylist { New = -1, None = 0, ToWatch = 1 };
 
 private:
-    int m_rate;
-    QDateTime m_creationDate;
-    QList<Movie> m_movieList;
+    PlaylistData *data();
+    const PlaylistData *data() const;
 };
 
 #endif // PLAYLIST_H
@@ -19,20 +19,38 @@
 
 #include "Show.h"
 
+class ShowData : public EntityData
+{
+public:
+    ShowData() : m_finished(false) {}
+    EntityData *clone() const { return new ShowData(*this); }
+
+    bool m_finished;
+};
+
 Show::Show(const QString name) :
-    Entity(name)
+    Entity(new ShowData, name)
+{
+}
+
+ShowData *Show::data()
 {
+    return static_cast<ShowData *>(d.data());
+}
 
+const ShowData *Show::data() const
+{
+    return static_cast<const ShowData *>(d.constData());
 }
 
 bool Show::isFinished() const
 {
-    return m_finished;
+    return data()->m_finished;
 }
 
 void Show::setFinished(const bool finished)
 {
-    m_finished = finished;
+    data()->m_finished = finished;
 }
 
 /*
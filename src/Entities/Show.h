@@ -24,6 +24,8 @@
 
 class QString;
 
+class ShowData;
+
 /**
  * @brief The Show class
  *
@@ -44,7 +46,8 @@ public:
 */
 
 private:
-    bool m_finished;
+    ShowData *data();
+    const ShowData *data() const;
 //    QList<Episode> m_episodeList;
 };
 
@@ -23,11 +23,14 @@
 #include <QMessageBox>
 #include <QTimer>
 
+#include "enumerations.h"
+
 #include "DatabaseManager.h"
 #include "MacawDebug.h"
 #include "ServicesManager.h"
 #include "FetchMetadata/FetchMetadataQuery.h"
 #include "FetchMetadata/FetchMetadataDialog.h"
+#include "FetchMetadata/MovieMatcher.h"
 
 FetchMetadata::FetchMetadata(QObject *parent) :
     QObject(parent)
@@ -40,9 +43,27 @@ FetchMetadata::FetchMetadata(QObject *parent) :
     m_fetchMetadataDialog = NULL;
     m_initialMovieQueueSize = 0;
     m_moviesProcessed = 0;
+    m_moviesSaved = 0;
+    m_peopleRequestsAvoided = 0;
+    m_movieIdQueues.resize(Macaw::FetchUserRequested + 1);
+
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
 
     connect(this, SIGNAL(jobDone()),
             this, SLOT(on_jobDone()));
+    connect(m_retryTimer, SIGNAL(timeout()),
+            this, SLOT(resumeQueue()));
+
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(FETCH_BATCH_DELAY);
+    connect(m_saveTimer, SIGNAL(timeout()),
+            this, SLOT(saveFetchedMovies()));
+    connect(m_fetchMetadataQuery, SIGNAL(networkError(QString)),
+            this, SLOT(networkError(QString)));
+    connect(m_fetchMetadataQuery, SIGNAL(peopleNetworkError(QString)),
+            this, SLOT(peopleNetworkError(QString)));
 
     Macaw::DEBUG("[FetchMetadata] Construction done");
 }
@@ -52,12 +73,121 @@ FetchMetadata::~FetchMetadata()
     Macaw::DEBUG("[FetchMetadata] Object destructed");
 }
 
-void FetchMetadata::addMoviesToQueue(const QList<Movie> &movieList)
+/**
+ * @brief Records fetch jobs for the movies, then takes in the queue
+ * the jobs that are due.
+ * Movies whose fetching failed recently wait for their next retry,
+ * unless the user explicitly asked for them.
+ * For the movies asked by the user, the choice dialog opens as soon as
+ * no result is accurate enough.
+ *
+ * @param movieList
+ * @param priority of the movies (Macaw::fetchPriority)
+ */
+void FetchMetadata::addMoviesToQueue(const QList<Movie> &movieList, const int priority)
 {
     Macaw::DEBUG("[FetchMetadata] Add movies to the queue list");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    QList<int> l_idList;
+    foreach (Movie l_movie, movieList) {
+        l_idList.append(l_movie.id());
+    }
+    if (priority == Macaw::FetchUserRequested) {
+        m_askUser = true;
+        m_reviewIdSet.unite(l_idList.toSet());
+    }
+    databaseManager->addFetchJobs(Macaw::isMovie, l_idList,
+                                  priority == Macaw::FetchUserRequested);
+
+    this->prioritizeMovies(l_idList, priority);
+    this->resumeQueue();
+}
+
+/**
+ * @brief Makes the given movies jump ahead of the background queue.
+ * The visible and selected movies replace the previous ones,
+ * whereas the movies requested by the user are kept until processed.
+ * Movies that are not in the queue are ignored when taken.
+ *
+ * @param idList of the movies
+ * @param priority of the movies (Macaw::fetchPriority)
+ */
+void FetchMetadata::prioritizeMovies(const QList<int> &idList, const int priority)
+{
+    if (priority <= Macaw::FetchBackground || priority >= m_movieIdQueues.size()) {
+
+        return;
+    }
+
+    if (priority == Macaw::FetchUserRequested) {
+        m_movieIdQueues[priority].append(idList);
+    } else {
+        m_movieIdQueues[priority] = idList;
+    }
+}
+
+/**
+ * @brief Takes the next movie to process, highest priority first
+ *
+ * @return the movie, or a Movie with id 0 if the queue is empty
+ */
+Movie FetchMetadata::takeNextMovie()
+{
+    for (int i = m_movieIdQueues.size() - 1 ; i >= 0 ; i--) {
+        while (!m_movieIdQueues.at(i).isEmpty()) {
+            int l_id = m_movieIdQueues[i].takeFirst();
+            if (m_movieQueue.contains(l_id)) {
+
+                return m_movieQueue.take(l_id);
+            }
+        }
+    }
+
+    return Movie();
+}
+
+/**
+ * @brief Takes again the movies for which no result was accurate enough.
+ * This time, the user is asked to choose among the results.
+ */
+void FetchMetadata::reviewMovies()
+{
+    Macaw::DEBUG("[FetchMetadata] Review the unmatched movies");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    QList<Movie> l_movieList = databaseManager->getMoviesToReview();
+    if (l_movieList.isEmpty()) {
+        ServicesManager::instance()->requestTempStatusBarMessage("No movie to review", 10000);
+
+        return;
+    }
+
+    this->addMoviesToQueue(l_movieList, Macaw::FetchUserRequested);
+}
+
+/**
+ * @brief Fills the queues with the fetch jobs stored in the database
+ * that are pending, or failed and due for a retry.
+ */
+void FetchMetadata::resumeQueue()
+{
+    Macaw::DEBUG("[FetchMetadata] Resume the fetch jobs");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
-    m_movieQueue.append(movieList);
-    if (m_movieQueue.count() == movieList.count()) {
+    bool l_queueWasEmpty = m_movieQueue.isEmpty();
+    foreach (Movie l_movie, databaseManager->getMoviesToFetch(FETCH_MAX_ATTEMPTS)) {
+        if (!m_movieQueue.contains(l_movie.id())
+                && !m_fetchedMovies.contains(l_movie.id())
+                && l_movie.id() != m_movie.id()) {
+            m_movieQueue.insert(l_movie.id(), l_movie);
+            m_movieIdQueues[Macaw::FetchBackground].append(l_movie.id());
+        }
+    }
+    this->addPeopleToQueue(databaseManager->getPeopleToFetch(FETCH_MAX_ATTEMPTS));
+
+    // m_movie.id() != 0 means that a movie is already being processed
+    if (l_queueWasEmpty && m_movie.id() == 0 && !m_movieQueue.isEmpty()) {
         this->startMovieProcess();
     }
 }
@@ -65,13 +195,31 @@ void FetchMetadata::addMoviesToQueue(const QList<Movie> &movieList)
 void FetchMetadata::addPeopleToQueue(const QList<People> &peopleList)
 {
     Macaw::DEBUG("[FetchMetadata] Add people to the queue list");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
-    m_peopleQueue.append(peopleList);
+    bool l_queueWasEmpty = m_peopleQueue.isEmpty();
+    QList<int> l_idList;
+    foreach (People l_people, peopleList) {
+        if (l_people.tmdbId() == 0 || l_people.id() == 0) {
+            // We don't take in account people added by users
+            continue;
+        }
+        // The same person appears in many movies, it is only requested once
+        if (l_people.isImported() || m_peopleTmdbIdSet.contains(l_people.tmdbId())) {
+            m_peopleRequestsAvoided++;
+            continue;
+        }
+        m_peopleTmdbIdSet.insert(l_people.tmdbId());
+        m_peopleQueue.append(l_people);
+        l_idList.append(l_people.id());
+    }
+    databaseManager->addFetchJobs(Macaw::isPeople, l_idList);
 
-    if (m_peopleQueue.count() == peopleList.count()) {
+    if (l_queueWasEmpty && !m_peopleQueue.isEmpty()) {
         this->startPeopleProcess();
     }
 }
+
 void FetchMetadata::on_jobDone()
 {
      m_running = false;
@@ -103,24 +251,31 @@ void FetchMetadata::startMovieProcess()
         return;
     }
     if (!m_movieQueue.isEmpty()) {
+        if (!m_runTimer.isValid()) {
+            m_runTimer.start();
+        }
         //Showing a message in status bar on the processing status
         m_initialMovieQueueSize == 0 ? m_initialMovieQueueSize = m_movieQueue.size() : m_moviesProcessed++;
         ServicesManager::instance()->requestTempStatusBarMessage("Movies fetched: "+QString::number(m_moviesProcessed) + '/' +QString::number(m_initialMovieQueueSize));
 
-        m_movie = m_movieQueue.takeFirst();
+        m_movie = this->takeNextMovie();
 
         connect(m_fetchMetadataQuery, SIGNAL(primaryResponse(QList<Movie>)),
                 this, SLOT(processPrimaryResponse(QList<Movie>)));
-        connect(m_fetchMetadataQuery, SIGNAL(networkError(QString)),
-                this, SLOT(networkError(QString)));
 
-        QString l_cleanedTitle = cleanString(m_movie.title());
+        // The release year and tags of the file name would spoil the search
+        QString l_cleanedTitle = MovieMatcher::titleTokens(m_movie.title()).join(" ");
         m_fetchMetadataQuery->sendPrimaryRequest(l_cleanedTitle);
     } else {
         // m_fetchMetadataQuery->deleteLater();
         ServicesManager::instance()->requestTempStatusBarMessage("Movies fetching completed! ", 10000);
         // id = 0 so we know that no movie is being processed
         m_movie = Movie();
+        this->saveFetchedMovies();
+        if (m_people.id() == 0) {
+            this->finishRun();
+        }
+        this->scheduleRetry();
     }
 }
 
@@ -138,25 +293,127 @@ void FetchMetadata::startPeopleProcess()
         return;
     }
     if (!m_peopleQueue.isEmpty()) {
+        if (!m_runTimer.isValid()) {
+            m_runTimer.start();
+        }
         m_people = m_peopleQueue.takeFirst();
         connect(m_fetchMetadataQuery, SIGNAL(peopleResponse(People)),
                 this, SLOT(processPeopleResponse(People)));
 
         Macaw::DEBUG(QString::number(m_people.id()));
-        if (m_people.tmdbId() == 0 || m_people.id() == 0) {
-            // We don't take in account people added by users
-            this->startPeopleProcess();
-        } else {
-            m_fetchMetadataQuery->sendPeopleRequest(m_people.tmdbId());
-        }
+        m_fetchMetadataQuery->sendPeopleRequest(m_people.tmdbId());
     } else {
         // m_fetchMetadataQuery->deleteLater();
         ServicesManager::instance()->requestTempStatusBarMessage("People fetching completed! ", 10000);
         // id = 0 so we know that no people is being processed
         m_people = People();
+        if (m_movie.id() == 0) {
+            this->finishRun();
+        }
+    }
+}
+
+/**
+ * @brief Removes the fetch job of an element once its metadata are fetched
+ *
+ * @param type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param id of the element
+ */
+void FetchMetadata::finishJob(const int type, const int id)
+{
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    databaseManager->deleteFetchJob(type, id);
+    if (type == Macaw::isMovie) {
+        m_reviewIdSet.remove(id);
+    }
+}
+
+/**
+ * @brief Records the failure of a fetch job.
+ * The job is retried after a delay which doubles after each attempt,
+ * up to FETCH_MAX_ATTEMPTS attempts.
+ *
+ * @param type of the element (Macaw::isMovie or Macaw::isPeople)
+ * @param id of the element
+ * @param error to record
+ */
+void FetchMetadata::failJob(const int type, const int id, const QString error)
+{
+    Macaw::DEBUG("[FetchMetadata] Fetch job failed: " + error);
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    int l_attempts = databaseManager->getFetchJobAttempts(type, id) + 1;
+    // 5 minutes, 10 minutes, 20 minutes... up to one day
+    int l_delay = qMin(300 << qMin(l_attempts - 1, 9), 86400);
+
+    databaseManager->setFetchJobFailed(type, id, error,
+                                       QDateTime::currentDateTime().addSecs(l_delay));
+    if (type == Macaw::isMovie) {
+        m_reviewIdSet.remove(id);
+    }
+}
+
+/**
+ * @brief Puts a movie aside until the user reviews it,
+ * since no result was accurate enough to be accepted automatically
+ *
+ * @param id of the movie
+ * @param reason to record
+ */
+void FetchMetadata::deferJob(const int id, const QString reason)
+{
+    Macaw::DEBUG("[FetchMetadata] Fetch job deferred: " + reason);
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    databaseManager->setFetchJobToReview(Macaw::isMovie, id, reason);
+    m_reviewIdSet.remove(id);
+}
+
+/**
+ * @brief Starts the timer that resumes the queue at the next planned retry
+ */
+void FetchMetadata::scheduleRetry()
+{
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+
+    QDateTime l_nextRetry = databaseManager->getNextFetchRetry(FETCH_MAX_ATTEMPTS);
+    if (l_nextRetry.isValid()) {
+        qint64 l_delay = QDateTime::currentDateTime().msecsTo(l_nextRetry);
+        m_retryTimer->start(qBound(qint64(1000), l_delay, qint64(86400000)));
     }
 }
 
+/**
+ * @brief Called when both movie and people queues are empty.
+ * Reports the throughput, the people requests that were not sent
+ * and the use of the caches of the database, and resets the run.
+ */
+void FetchMetadata::finishRun()
+{
+    double l_minutes = m_runTimer.isValid() ? m_runTimer.elapsed() / 60000.0 : 0;
+    double l_moviesPerMinute = l_minutes > 0 ? m_moviesSaved / l_minutes : 0;
+
+    Macaw::DEBUG("[FetchMetadata] Run finished, "
+                 + QString::number(m_moviesSaved) + " movies in "
+                 + QString::number(l_minutes * 60, 'f', 1) + " s ("
+                 + QString::number(l_moviesPerMinute, 'f', 1) + " movies/min), "
+                 + "people requests avoided: " + QString::number(m_peopleRequestsAvoided));
+    ServicesManager::instance()->requestTempStatusBarMessage("Metadata fetching completed! "
+                                                             + QString::number(l_moviesPerMinute, 'f', 1)
+                                                             + " movies/min, "
+                                                             + QString::number(m_peopleRequestsAvoided)
+                                                             + " people requests avoided", 10000);
+    ServicesManager::instance()->databaseManager()->logStatistics();
+    emit runFinished(m_moviesSaved, m_runTimer.isValid() ? m_runTimer.elapsed() : 0);
+    m_peopleTmdbIdSet.clear();
+    m_peopleRequestsAvoided = 0;
+    m_initialMovieQueueSize = 0;
+    m_moviesProcessed = 0;
+    m_moviesSaved = 0;
+    m_runTimer.invalidate();
+}
+
 void FetchMetadata::initTimerDone()
 {
     Macaw::DEBUG("[FetchMetadata] Initialization timer is done");
@@ -180,17 +437,6 @@ void FetchMetadata::initTimerDone()
     }
 }
 
-QString FetchMetadata::cleanString(QString title)
-{
-    QRegExp l_sep("(\\_|\\-|\\ |\\,|\\)|\\(|\\]|\\[|\\.|\\!|\\?|\\#)");
-    QStringList l_splittedTitle = title.split(l_sep, QString::SkipEmptyParts);
-
-    QRegExp l_alphaOnly("(^['À-Ÿà-ÿA-Za-z]*$)");
-    l_splittedTitle = l_splittedTitle.filter(l_alphaOnly);
-
-    return l_splittedTitle.join(" ");
-}
-
 void FetchMetadata::processPrimaryResponse(const QList<Movie> &movieList)
 {
     Macaw::DEBUG("[FetchMetadata] Signal from primary request received");
@@ -198,42 +444,41 @@ void FetchMetadata::processPrimaryResponse(const QList<Movie> &movieList)
     disconnect(m_fetchMetadataQuery, SIGNAL(primaryResponse(QList<Movie>)),
             this, SLOT(processPrimaryResponse(QList<Movie>)));
 
-    QList<Movie> l_accurateList;
+    MovieMatcher l_matcher(m_movie);
+    QList<Movie> l_rankedList = l_matcher.rank(movieList, m_fetchMetadataQuery->popularityHash());
 
-    if(movieList.count() == 1) {
-        l_accurateList = movieList;
-    } else if(movieList.count() > 1) {
-
-        foreach(Movie l_movie, movieList) {
-
-            if(cleanString(l_movie.title()).compare(cleanString(m_movie.title()), Qt::CaseInsensitive) == 0) {
-                Macaw::DEBUG("[FetchMetadata] One title matches");
-                l_accurateList.append(l_movie);
-            }
-        }
-    }
-
-    if(l_accurateList.count() == 1) {
-        Movie l_movie = l_accurateList.at(0);
-
-        connect(m_fetchMetadataQuery, SIGNAL(movieResponse(Movie)),
-                this, SLOT(processMovieResponse(Movie)));
-        Macaw::DEBUG("[FetchMetadata] Movie request to be sent ["+QString::number(l_movie.tmdbId())+"]");
-        m_fetchMetadataQuery->sendMovieRequest(l_movie.tmdbId());
-    } else if (m_askUser) {
-        if(l_accurateList.isEmpty()) {
-            l_accurateList = movieList;
-        }
-        this->openFetchMetadataDialog(m_movie, l_accurateList);
+    if (l_matcher.isConfident()) {
+        this->requestMovie(l_rankedList.first());
+    } else if (m_askUser && m_reviewIdSet.contains(m_movie.id())) {
+        this->openFetchMetadataDialog(m_movie, l_rankedList);
     } else {
+        // The dialog would block the fetching until the user answers
+        if (l_rankedList.isEmpty()) {
+            this->deferJob(m_movie.id(), "No result found");
+        } else {
+            this->deferJob(m_movie.id(), "Best result: " + l_rankedList.first().title()
+                           + " (score " + QString::number(l_matcher.bestScore(), 'f', 2) + ")");
+        }
         this->startMovieProcess();
     }
 }
 
+/**
+ * @brief Asks TMDb for the complete metadata of the chosen result
+ *
+ * @param movie: result of the search, with its TMDb id
+ */
+void FetchMetadata::requestMovie(const Movie &movie)
+{
+    connect(m_fetchMetadataQuery, SIGNAL(movieResponse(Movie)),
+            this, SLOT(processMovieResponse(Movie)));
+    Macaw::DEBUG("[FetchMetadata] Movie request to be sent ["+QString::number(movie.tmdbId())+"]");
+    m_fetchMetadataQuery->sendMovieRequest(movie.tmdbId());
+}
+
 void FetchMetadata::processMovieResponse(const Movie &receivedMovie)
 {
     Macaw::DEBUG("[FetchMetadata] Signal from movie request received");
-    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
     disconnect(m_fetchMetadataQuery, SIGNAL(movieResponse(Movie)),
             this, SLOT(processMovieResponse(Movie)));
@@ -245,7 +490,6 @@ void FetchMetadata::processMovieResponse(const Movie &receivedMovie)
     m_movie.setDuration(receivedMovie.duration());
     m_movie.setCountry(receivedMovie.country());
     m_movie.setSynopsis(receivedMovie.synopsis());
-    m_movie.setPeopleList(receivedMovie.peopleList());
     m_movie.setColored(receivedMovie.isColored());
     m_movie.setPeopleList(receivedMovie.peopleList());
     m_movie.setPosterPath(receivedMovie.posterPath().right(receivedMovie.posterPath().size()-1));
@@ -253,22 +497,59 @@ void FetchMetadata::processMovieResponse(const Movie &receivedMovie)
 
     m_movie.setImported(true);
 
-    if (databaseManager->updateMovie(m_movie)) {
-        m_movie = databaseManager->getOneMovieById(m_movie.id());
+    m_fetchedMovies.insert(m_movie.id(), m_movie);
+    if (m_fetchedMovies.size() >= FETCH_BATCH_SIZE) {
+        this->saveFetchedMovies();
+    } else if (!m_saveTimer->isActive()) {
+        m_saveTimer->start();
+    }
 
-        Macaw::DEBUG("**** "+QString::number(m_movie.peopleList().count()));
-        foreach (People p, m_movie.peopleList())
-        {
-            Macaw::DEBUG("**** "+QString::number(p.id()))   ;
-        }
+    this->startMovieProcess();
+}
+
+/**
+ * @brief Saves the fetched movies, each one in its own transaction so that
+ * a failure only fails its movie, then asks once for their people and for
+ * the pannels to be updated.
+ */
+void FetchMetadata::saveFetchedMovies()
+{
+    m_saveTimer->stop();
+    if (m_fetchedMovies.isEmpty()) {
+
+        return;
+    }
+    Macaw::DEBUG("[FetchMetadata] Save " + QString::number(m_fetchedMovies.size()) + " movies");
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
+    QList<int> l_savedIdList;
+    QList<People> l_peopleList;
+    foreach (Movie l_movie, m_fetchedMovies) {
         // while updating the movie, the new people get id and the movie is reset to be aware of it.
         // So we can directly append them to the queue
-        this->addPeopleToQueue(m_movie.peopleList());
+        bool l_saved = false;
+        databaseManager->beginTransaction();
+        if (databaseManager->updateMovie(l_movie)) {
+            this->finishJob(Macaw::isMovie, l_movie.id());
+            l_saved = databaseManager->commitTransaction();
+        } else {
+            databaseManager->rollbackTransaction();
+        }
+
+        if (l_saved) {
+            l_savedIdList.append(l_movie.id());
+            m_moviesSaved++;
+            l_peopleList.append(l_movie.peopleList());
+        } else {
+            this->failJob(Macaw::isMovie, l_movie.id(), "The movie could not be saved");
+        }
     }
+    m_fetchedMovies.clear();
 
-    emit updatedMovie();
-    this->startMovieProcess();
+    this->addPeopleToQueue(l_peopleList);
+    if (!l_savedIdList.isEmpty()) {
+        emit updatedMovies(l_savedIdList);
+    }
 }
 
 void FetchMetadata::processPeopleResponse(const People &receivedPeople)
@@ -286,22 +567,27 @@ void FetchMetadata::processPeopleResponse(const People &receivedPeople)
 
     m_people.setImported(true);
 
-    databaseManager->updatePeople(m_people);
+    if (databaseManager->updatePeople(m_people)) {
+        this->finishJob(Macaw::isPeople, m_people.id());
+    } else {
+        this->failJob(Macaw::isPeople, m_people.id(), "The person could not be saved");
+    }
     emit updatedPeople();
+    // id = 0 so that the next person of the queue can be processed
+    m_people = People();
     this->startPeopleProcess();
 }
 
 void FetchMetadata::on_searchCanceled()
 {
     Macaw::DEBUG("[FetchMetadata] Dialog canceled");
+    this->deferJob(m_movie.id(), "Search canceled");
     this->startProcess();
 }
 
 void FetchMetadata::on_selectedMovie(const Movie &movie)
 {
-    QList<Movie> l_movieList;
-    l_movieList.append(movie);
-    processPrimaryResponse(l_movieList);
+    this->requestMovie(movie);
 }
 
 void FetchMetadata::on_searchMovies(QString title)
@@ -353,13 +639,50 @@ void FetchMetadata::updateFetchMetadataDialog(const QList<Movie> &updatedList)
     m_fetchMetadataDialog->setMovieList(updatedList);
 }
 
+/**
+ * @brief Slot triggered when a request concerning the current movie failed.
+ * The failure is recorded and the next movie is processed.
+ * @param error
+ */
 void FetchMetadata::networkError(QString error)
 {
-    QMessageBox msgBox;
-    msgBox.setIcon(QMessageBox::Critical);
-    msgBox.setText("Network error: " + error);
-    msgBox.setStandardButtons(QMessageBox::Ok);
-    msgBox.exec();
+    ServicesManager::instance()->requestTempStatusBarMessage("Network error: " + error, 10000);
+
+    // The search was asked from the dialog, the user can try again
+    if (disconnect(m_fetchMetadataQuery, SIGNAL(primaryResponse(QList<Movie>)),
+                   this, SLOT(processPrimaryResponseDialog(QList<Movie>)))) {
+        this->updateFetchMetadataDialog(QList<Movie>());
+
+        return;
+    }
+
+    disconnect(m_fetchMetadataQuery, SIGNAL(primaryResponse(QList<Movie>)),
+               this, SLOT(processPrimaryResponse(QList<Movie>)));
+    disconnect(m_fetchMetadataQuery, SIGNAL(movieResponse(Movie)),
+               this, SLOT(processMovieResponse(Movie)));
+
+    if (m_movie.id() != 0) {
+        this->failJob(Macaw::isMovie, m_movie.id(), error);
+        this->startMovieProcess();
+    }
+}
+
+/**
+ * @brief Slot triggered when the request concerning the current person failed.
+ * The failure is recorded and the next person is processed.
+ * @param error
+ */
+void FetchMetadata::peopleNetworkError(QString error)
+{
+    disconnect(m_fetchMetadataQuery, SIGNAL(peopleResponse(People)),
+               this, SLOT(processPeopleResponse(People)));
+
+    if (m_people.id() != 0) {
+        this->failJob(Macaw::isPeople, m_people.id(), error);
+        // id = 0 so that the next person of the queue can be processed
+        m_people = People();
+        this->startPeopleProcess();
+    }
 }
 
 void FetchMetadata::on_dontAskUser()
@@ -373,4 +696,5 @@ void FetchMetadata::on_neverAskUser(Movie movie)
 
     movie.setImported(true);
     databaseManager->updateMovie(movie);
+    this->finishJob(Macaw::isMovie, movie.id());
 }
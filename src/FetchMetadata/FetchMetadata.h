@@ -20,7 +20,13 @@
 #ifndef FETCH_H
 #define FETCH_H
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include "enumerations.h"
 
 #include "Entities/Movie.h"
 
@@ -28,6 +34,7 @@ class Application;
 class FetchMetadataDialog;
 class FetchMetadataQuery;
 class Movie;
+class QTimer;
 
 /**
  * @brief The FetchMetadata class
@@ -36,19 +43,28 @@ class Movie;
  */
 class FetchMetadata : public QObject
 {
+    #define FETCH_MAX_ATTEMPTS 8
+    #define FETCH_BATCH_SIZE 20
+    #define FETCH_BATCH_DELAY 2000
 Q_OBJECT
 
 public:
     explicit FetchMetadata(QObject *parent = 0);
     ~FetchMetadata();
-    void addMoviesToQueue(const QList<Movie> &movieList);
+    void addMoviesToQueue(const QList<Movie> &movieList, const int priority = Macaw::FetchBackground);
     void addPeopleToQueue(const QList<People> &peopleList);
 
+public slots:
+    void resumeQueue();
+    void reviewMovies();
+    void prioritizeMovies(const QList<int> &idList, const int priority);
+
 signals:
     void jobDone();
     void exitInitWaitingLoop();
-    void updatedMovie();
+    void updatedMovies(const QList<int> &idList);
     void updatedPeople();
+    void runFinished(int movieCount, qint64 elapsed);
 
 private slots:
     void initTimerDone();
@@ -63,6 +79,8 @@ private slots:
     void on_neverAskUser(Movie movie);
     void on_jobDone();
     void networkError(QString error);
+    void peopleNetworkError(QString error);
+    void saveFetchedMovies();
 
 private:
     FetchMetadataQuery *m_fetchMetadataQuery;
@@ -74,17 +92,65 @@ private:
 
     Movie m_movie;
     People m_people;
-    QList<Movie> m_movieQueue;
+
+    /**
+     * @brief Movies waiting to be processed, by id
+     */
+    QHash<int, Movie> m_movieQueue;
+
+    /**
+     * @brief Ids of the queued movies, one list per Macaw::fetchPriority.
+     * A movie can appear in several lists: it is taken from the highest one,
+     * and its other entries are skipped since it is not in m_movieQueue anymore.
+     */
+    QVector<QList<int> > m_movieIdQueues;
+
+    /**
+     * @brief Ids of the movies the user is reviewing.
+     * Only these ones open the dialog when no result is accurate enough.
+     */
+    QSet<int> m_reviewIdSet;
+
+    /**
+     * @brief Movies fetched but not saved yet, by id.
+     * They are saved by batches of FETCH_BATCH_SIZE, or FETCH_BATCH_DELAY ms
+     * after the first one was fetched.
+     */
+    QHash<int, Movie> m_fetchedMovies;
+    QTimer *m_saveTimer;
     QList<People> m_peopleQueue;
+
+    /**
+     * @brief TMDb ids of the people queued or fetched during the current run
+     */
+    QSet<int> m_peopleTmdbIdSet;
+    int m_peopleRequestsAvoided;
     bool m_askUser;
     bool m_running;
     int m_initialMovieQueueSize, m_moviesProcessed;
-    QString cleanString(const QString title);
+
+    /**
+     * @brief Measures the throughput of the current run
+     */
+    QElapsedTimer m_runTimer;
+    int m_moviesSaved;
+
+    /**
+     * @brief Resumes the queue when the next failed job is due
+     */
+    QTimer *m_retryTimer;
     void openFetchMetadataDialog(const Movie &movie, const QList<Movie> &accurateList);
     void updateFetchMetadataDialog(const QList<Movie> &updatedList);
     void startProcess();
     void startMovieProcess();
     void startPeopleProcess();
+    Movie takeNextMovie();
+    void finishRun();
+    void finishJob(const int type, const int id);
+    void failJob(const int type, const int id, const QString error);
+    void deferJob(const int id, const QString reason);
+    void requestMovie(const Movie &movie);
+    void scheduleRetry();
 };
 
 #endif // FETCH_H
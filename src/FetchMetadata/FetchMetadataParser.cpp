@@ -0,0 +1,156 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FetchMetadata/FetchMetadataParser.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+
+#include "enumerations.h"
+
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param type of the element described by the reply (Macaw::isMovie or Macaw::isPeople)
+ * @param data received
+ * @param error of the reply, empty if the request succeeded
+ */
+FetchMetadataParser::FetchMetadataParser(const int type, const QByteArray &data, const QString &error) :
+    QObject(),
+    QRunnable()
+{
+    m_type = type;
+    m_data = data;
+    m_error = error;
+}
+
+/**
+ * @brief Parses the reply and emits the result.
+ * Runs in a thread of the pool.
+ */
+void FetchMetadataParser::run()
+{
+    int l_status = Parsed;
+    QString l_error = m_error;
+    QJsonObject l_jsonObject = QJsonDocument::fromJson(m_data).object();
+
+    if (l_jsonObject.contains("status_code")
+            && l_jsonObject.value("status_code").toInt() == 25) {
+        l_status = RateLimited;
+    } else if (!l_error.isEmpty()) {
+        l_status = Invalid;
+    } else if (l_jsonObject.isEmpty()) {
+        l_status = Invalid;
+        l_error = "Empty response";
+    }
+
+    if (m_type == Macaw::isMovie) {
+        Movie l_movie;
+        if (l_status == Parsed) {
+            l_movie = parseMovie(l_jsonObject);
+        }
+        emit movieParsed(l_movie, l_status, l_error);
+    } else {
+        People l_people;
+        if (l_status == Parsed) {
+            l_people = parsePeople(l_jsonObject);
+            if (l_people.tmdbId() == 0) {
+                Macaw::DEBUG("[FetchMetadataParser] Person without id received: " + m_data);
+                l_status = Invalid;
+                l_error = "Invalid response";
+            }
+        }
+        emit peopleParsed(l_people, l_status, l_error);
+    }
+}
+
+/**
+ * @brief Reads a movie and its credits
+ *
+ * @param jsonObject of the movie
+ * @return the movie, without id
+ */
+Movie FetchMetadataParser::parseMovie(const QJsonObject &jsonObject)
+{
+    Movie l_movie;
+    l_movie.setTitle(jsonObject.value("title").toString());
+    l_movie.setOriginalTitle(jsonObject.value("original_title").toString());
+    l_movie.setCountry(jsonObject.value("production_countries").toArray().at(1).toObject().value("name").toString());
+    l_movie.setPosterPath(jsonObject.value("poster_path").toString());
+
+    QLocale locale(QLocale::English, QLocale::UnitedStates);
+    QDate l_releaseDate = locale.toDate(jsonObject.value("release_date").toString(),"yyyy-MM-dd");
+    l_movie.setReleaseDate(l_releaseDate);
+
+    l_movie.setSynopsis(jsonObject.value("overview").toString());
+
+    People l_people;
+    QString l_personName;
+    int l_personId;
+    QJsonArray l_jsonCastArray = jsonObject.value("credits").toObject().value("cast").toArray();
+    for (int i = 0 ; i < l_jsonCastArray.size() ; i++) {
+        l_personId = l_jsonCastArray.at(i).toObject().value("id").toInt();
+        l_personName = l_jsonCastArray.at(i).toObject().value("name").toString();
+        l_people.setTmdbId(l_personId);
+        l_people.setName(l_personName);
+        l_people.setType(People::Actor);
+        l_movie.addPeople(l_people);
+    }
+
+    QJsonArray l_jsonCrewArray = jsonObject.value("credits").toObject().value("crew").toArray();
+    for (int i = 0 ; i < l_jsonCrewArray.size() ; i++) {
+        QString l_job = l_jsonCrewArray.at(i).toObject().value("job").toString();
+        if (l_job == "Director" || l_job == "Producer") {
+            l_personId = l_jsonCrewArray.at(i).toObject().value("id").toInt();
+            l_personName = l_jsonCrewArray.at(i).toObject().value("name").toString();
+            l_people.setTmdbId(l_personId);
+            l_people.setName(l_personName);
+            l_people.setType(l_job == "Director" ? People::Director : People::Producer);
+            l_movie.addPeople(l_people);
+        }
+    }
+    Macaw::DEBUG("[FetchMetadataParser] Movie parsed: " + l_movie.title()
+                 + ", " + QString::number(l_movie.peopleList().size()) + " people");
+
+    return l_movie;
+}
+
+/**
+ * @brief Reads a person
+ *
+ * @param jsonObject of the person
+ * @return the person, without id
+ */
+People FetchMetadataParser::parsePeople(const QJsonObject &jsonObject)
+{
+    People l_people;
+    l_people.setTmdbId(jsonObject.value("id").toInt());
+    l_people.setName(jsonObject.value("name").toString());
+    l_people.setBiography(jsonObject.value("biography").toString());
+    QLocale locale(QLocale::English, QLocale::UnitedStates);
+    QDate l_birthday = locale.toDate(jsonObject.value("birthday").toString(),"yyyy-MM-dd");
+    l_people.setBirthday(l_birthday);
+
+    return l_people;
+}
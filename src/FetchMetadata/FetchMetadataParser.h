@@ -0,0 +1,71 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FETCHMETADATAPARSER_H
+#define FETCHMETADATAPARSER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QRunnable>
+
+#include "Entities/Movie.h"
+#include "Entities/People.h"
+
+class QJsonObject;
+
+/**
+ * @brief Parses a TMDb reply in a thread of the global QThreadPool,
+ * so that large payloads (e.g. the credits of a movie) do not freeze the GUI.
+ * The result is given back through a queued signal.
+ */
+class FetchMetadataParser : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    enum parseStatus {
+        Parsed,
+        RateLimited,
+        Invalid
+    };
+
+    explicit FetchMetadataParser(const int type, const QByteArray &data, const QString &error);
+    void run();
+
+signals:
+    void movieParsed(const Movie &movie, int status, const QString &error);
+    void peopleParsed(const People &people, int status, const QString &error);
+
+private:
+    /**
+     * @brief Type of the element described by the reply (Macaw::isMovie or Macaw::isPeople)
+     */
+    int m_type;
+    QByteArray m_data;
+
+    /**
+     * @brief Network error of the reply, empty if the request succeeded
+     */
+    QString m_error;
+    Movie parseMovie(const QJsonObject &jsonObject);
+    People parsePeople(const QJsonObject &jsonObject);
+};
+
+#endif // FETCHMETADATAPARSER_H
@@ -26,10 +26,15 @@
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
+#include <QThreadPool>
+#include <QTimer>
 #include <QUrl>
 
+#include "enumerations.h"
+
 #include "Application.h"
 #include "MacawDebug.h"
+#include "FetchMetadata/FetchMetadataParser.h"
 
 FetchMetadataQuery::FetchMetadataQuery(QObject *parent) :
     QObject(parent)
@@ -57,7 +62,7 @@ void FetchMetadataQuery::sendInitRequest()
             this, SLOT(on_initRequestResponse(QNetworkReply*)));
 
     QNetworkRequest l_request;
-    QUrl l_initUrl = QUrl("http://api.themoviedb.org/3/configuration"
+    QUrl l_initUrl = QUrl(m_app->tmdbUrl() + "/configuration"
                           "?api_key="+ m_app->tmdbkey()
                           , QUrl::TolerantMode);
     l_request.setUrl(l_initUrl);
@@ -75,7 +80,7 @@ void FetchMetadataQuery::sendPrimaryRequest(QString title)
             this, SLOT(on_primaryRequestResponse(QNetworkReply*)));
 
     QNetworkRequest l_request;
-    l_request.setUrl(QUrl("http://api.themoviedb.org/3/search/movie"
+    l_request.setUrl(QUrl(m_app->tmdbUrl() + "/search/movie"
                           "?api_key="+ m_app->tmdbkey() +"&query="+ title
                           , QUrl::TolerantMode));
     m_nmMovies->get(l_request);
@@ -90,7 +95,7 @@ void FetchMetadataQuery::sendMovieRequest(int tmdbID)
             this, SLOT(on_movieRequestResponse(QNetworkReply*)));
 
     QNetworkRequest l_request;
-    l_request.setUrl(QUrl("http://api.themoviedb.org/3/movie/" +
+    l_request.setUrl(QUrl(m_app->tmdbUrl() + "/movie/" +
                           QString::number(tmdbID) +
                           "?api_key=" + m_app->tmdbkey() +
                           "&append_to_response=credits&language=en"
@@ -108,7 +113,7 @@ void FetchMetadataQuery::sendPeopleRequest(int tmdbID)
             this, SLOT(on_peopleRequestResponse(QNetworkReply*)));
 
     QNetworkRequest l_request;
-    l_request.setUrl(QUrl("http://api.themoviedb.org/3/person/" +
+    l_request.setUrl(QUrl(m_app->tmdbUrl() + "/person/" +
                           QString::number(tmdbID) +
                           "?api_key="+ m_app->tmdbkey()
                           , QUrl::StrictMode));
@@ -162,47 +167,47 @@ void FetchMetadataQuery::on_primaryRequestResponse(QNetworkReply* reply)
     QList<Movie> l_moviesPropositionList;
 
     QByteArray l_receivedData = reply->readAll();
+    QString l_error = replyError(reply);
     reply->deleteLater();
 
-    QJsonDocument l_stream = QJsonDocument::fromJson(l_receivedData);
+    QJsonObject l_jsonObject = QJsonDocument::fromJson(l_receivedData).object();
 
-    if (!l_stream.isEmpty()) {
-        QJsonObject l_jsonObject = l_stream.object();
-        if (!l_jsonObject.isEmpty()) {
-            if (l_jsonObject.contains("status_code")
-                    && l_jsonObject.value("status_code").toInt() == 25) {
-                Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
-                QTime dieTime = QTime::currentTime().addSecs(10);
-                  while (QTime::currentTime() < dieTime)
-                      QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
-
-                  this->sendPrimaryRequest(m_movie.title());
-
-                  return;
-            }
-
-            int l_numberMovies = l_jsonObject.value("total_results").toInt();
-
-            QJsonArray l_jsonResults = l_jsonObject.value("results").toArray();
-
-            Macaw::DEBUG("[FetchMetadataQuery] "+QString::number(l_numberMovies) + " Movie(s) found");
-
-            for (int i = 0 ; i < l_jsonResults.size() ; i++)
-            {
-                QJsonObject l_currentObject = l_jsonResults.at(i).toObject();
-                Movie l_movieProposition;
-                l_movieProposition.setTmdbId(l_currentObject.value("id").toInt());
-                l_movieProposition.setTitle(l_currentObject.value("title").toString());
-                l_movieProposition.setReleaseDate(QDate::fromString(l_currentObject.value("release_date").toString(),"yyyy-MM-dd"));
-                l_moviesPropositionList.append(l_movieProposition);
-            }
-            Macaw::DEBUG("[FetchMetadataQuery] Signal to be emitted to FetchMetadata for primary request");
-            emit primaryResponse(l_moviesPropositionList);
-        }
-    } else {
-        Macaw::DEBUG("[FetchMetadataQuery] Error in on_primaryRequestResponse, stream empty !");
-        // error !!
+    if (l_jsonObject.contains("status_code")
+            && l_jsonObject.value("status_code").toInt() == 25) {
+        Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
+        QTimer::singleShot(10000, this, SLOT(resendPrimaryRequest()));
+
+        return;
     }
+
+    if (!l_error.isEmpty() || l_jsonObject.isEmpty()) {
+        Macaw::DEBUG("[FetchMetadataQuery] Error in on_primaryRequestResponse: " + l_error);
+        emit networkError(l_error.isEmpty() ? "Empty response" : l_error);
+
+        return;
+    }
+
+    int l_numberMovies = l_jsonObject.value("total_results").toInt();
+
+    QJsonArray l_jsonResults = l_jsonObject.value("results").toArray();
+
+    Macaw::DEBUG("[FetchMetadataQuery] "+QString::number(l_numberMovies) + " Movie(s) found");
+
+    m_popularityHash.clear();
+    for (int i = 0 ; i < l_jsonResults.size() ; i++)
+    {
+        QJsonObject l_currentObject = l_jsonResults.at(i).toObject();
+        Movie l_movieProposition;
+        l_movieProposition.setTmdbId(l_currentObject.value("id").toInt());
+        l_movieProposition.setTitle(l_currentObject.value("title").toString());
+        l_movieProposition.setOriginalTitle(l_currentObject.value("original_title").toString());
+        l_movieProposition.setReleaseDate(QDate::fromString(l_currentObject.value("release_date").toString(),"yyyy-MM-dd"));
+        m_popularityHash.insert(l_movieProposition.tmdbId(),
+                                l_currentObject.value("popularity").toDouble());
+        l_moviesPropositionList.append(l_movieProposition);
+    }
+    Macaw::DEBUG("[FetchMetadataQuery] Signal to be emitted to FetchMetadata for primary request");
+    emit primaryResponse(l_moviesPropositionList);
 }
 
 void FetchMetadataQuery::on_movieRequestResponse(QNetworkReply *reply)
@@ -211,75 +216,42 @@ void FetchMetadataQuery::on_movieRequestResponse(QNetworkReply *reply)
     disconnect(m_nmMovies, SIGNAL(finished(QNetworkReply*)),
                this, SLOT(on_movieRequestResponse(QNetworkReply*)));
 
-    QByteArray l_receivedData = reply->readAll();
+    FetchMetadataParser *l_parser = new FetchMetadataParser(Macaw::isMovie,
+                                                            reply->readAll(),
+                                                            replyError(reply));
     reply->deleteLater();
-    QJsonDocument l_stream = QJsonDocument::fromJson(l_receivedData);
-    if (!l_stream.isEmpty()) {
-        QJsonObject l_jsonObject = l_stream.object();
-        if (!l_jsonObject.isEmpty()) {
-            if (l_jsonObject.contains("status_code")
-                    && l_jsonObject.value("status_code").toInt() == 25) {
-                Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
-                QTime dieTime = QTime::currentTime().addSecs(10);
-                  while (QTime::currentTime() < dieTime)
-                      QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
-
-                  this->sendMovieRequest(m_movie.tmdbId());
-
-                  return;
-            }
-            m_movie.setTitle(l_jsonObject.value("title").toString());
-            m_movie.setOriginalTitle(l_jsonObject.value("original_title").toString());
-            m_movie.setCountry(l_jsonObject.value("production_countries").toArray().at(1).toObject().value("name").toString());
-            m_movie.setPosterPath(l_jsonObject.value("poster_path").toString());
-
-            QLocale locale(QLocale::English, QLocale::UnitedStates);
-            QDate l_releaseDate = locale.toDate(l_jsonObject.value("release_date").toString(),"yyyy-MM-dd");
-            m_movie.setReleaseDate(l_releaseDate);
-
-            m_movie.setSynopsis(l_jsonObject.value("overview").toString());
-            if (!l_jsonObject.value("poster_path").toString().isEmpty()) {
-                sendPosterRequest(l_jsonObject.value("poster_path").toString());
-            }
-
-            People l_people;
-            QString l_personName;
-            int l_personId;
-            QJsonArray l_jsonCastArray = l_jsonObject.value("credits").toObject().value("cast").toArray();
-            for (int i = 0 ; i < l_jsonCastArray.size() ; i++) {
-                l_personId = l_jsonCastArray.at(i).toObject().value("id").toInt();
-                l_personName = l_jsonCastArray.at(i).toObject().value("name").toString();
-                l_people.setTmdbId(l_personId);
-                l_people.setType(People::Actor);
-                m_movie.addPeople(l_people);
-
-                Macaw::DEBUG("[FetchMetadataQuery] new Actor: "+ l_personName);
-            }
-
-            QJsonArray l_jsonCrewArray = l_jsonObject.value("credits").toObject().value("crew").toArray();
-            for (int i = 0 ; i < l_jsonCrewArray.size() ; i++) {
-                QString l_job = l_jsonCrewArray.at(i).toObject().value("job").toString();
-                if (l_job == "Director") {
-                    l_personId = l_jsonCrewArray.at(i).toObject().value("id").toInt();
-                    l_personName = l_jsonCrewArray.at(i).toObject().value("name").toString();
-                    l_people.setTmdbId(l_personId);
-                    l_people.setType(People::Director);
-                    m_movie.addPeople(l_people);
-
-                    Macaw::DEBUG("[FetchMetadataQuery] new Director: "+ l_personName);
-                } else if (l_job ==  "Producer") {
-                    l_personId = l_jsonCrewArray.at(i).toObject().value("id").toInt();
-                    l_personName = l_jsonCrewArray.at(i).toObject().value("name").toString();
-                    l_people.setTmdbId(l_personId);
-                    l_people.setType(People::Producer);
-                    m_movie.addPeople(l_people);
-
-                    Macaw::DEBUG("[FetchMetadataQuery] new Producer: "+ l_personName);
-                }
-            }
-        } else {
-            Macaw::DEBUG("[FetchMetadataQuery] Error on MovieRequestResponse: l_jsonObject empty");
-        }
+    connect(l_parser, SIGNAL(movieParsed(Movie,int,QString)),
+            this, SLOT(on_movieParsed(Movie,int,QString)));
+    QThreadPool::globalInstance()->start(l_parser);
+}
+
+/**
+ * @brief Slot triggered when the reply of a movie request has been parsed
+ *
+ * @param movie read from the reply
+ * @param status of the parsing (FetchMetadataParser::parseStatus)
+ * @param error of the reply
+ */
+void FetchMetadataQuery::on_movieParsed(const Movie &movie, int status, const QString &error)
+{
+    if (status == FetchMetadataParser::RateLimited) {
+        Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
+        QTimer::singleShot(10000, this, SLOT(resendMovieRequest()));
+
+        return;
+    }
+    if (status == FetchMetadataParser::Invalid) {
+        Macaw::DEBUG("[FetchMetadataQuery] Error on MovieRequestResponse: " + error);
+        emit networkError(error);
+
+        return;
+    }
+
+    int l_tmdbId = m_movie.tmdbId();
+    m_movie = movie;
+    m_movie.setTmdbId(l_tmdbId);
+    if (!m_movie.posterPath().isEmpty()) {
+        sendPosterRequest(m_movie.posterPath());
     }
 
     emit(movieResponse(m_movie));
@@ -292,47 +264,65 @@ void FetchMetadataQuery::on_peopleRequestResponse(QNetworkReply *reply)
     disconnect(m_nmPeople, SIGNAL(finished(QNetworkReply*)),
                 this, SLOT(on_peopleRequestResponse(QNetworkReply*)));
 
-    QByteArray l_receivedData = reply->readAll();
+    FetchMetadataParser *l_parser = new FetchMetadataParser(Macaw::isPeople,
+                                                            reply->readAll(),
+                                                            replyError(reply));
     reply->deleteLater();
+    connect(l_parser, SIGNAL(peopleParsed(People,int,QString)),
+            this, SLOT(on_peopleParsed(People,int,QString)));
+    QThreadPool::globalInstance()->start(l_parser);
+}
 
-    QJsonDocument l_stream = QJsonDocument::fromJson(l_receivedData);
-    if (!l_stream.isEmpty()) {
-        QJsonObject l_jsonObject = l_stream.object();
-        if (!l_jsonObject.isEmpty()) {
-            if (l_jsonObject.contains("status_code")
-                    && l_jsonObject.value("status_code").toInt() == 25) {
-                Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
-                QTime dieTime = QTime::currentTime().addSecs(10);
-                  while (QTime::currentTime() < dieTime)
-                      QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
-
-                  this->sendPeopleRequest(m_people.tmdbId());
-
-                  return ;
-            }
-            int l_tmdbID = l_jsonObject.value("id").toInt();
-            if (l_tmdbID == 0) {
-                Macaw::DEBUG_IN("---THIS SHOULD NOT HAPPEN ! id = 0-----");
-                Macaw::DEBUG(l_receivedData);
-                Macaw::DEBUG_OUT("-------------");
-            } else if (l_tmdbID == m_people.tmdbId()) {
-                Macaw::DEBUG("[FetchMetadataQuery] Processing response for id=" +QString::number(l_tmdbID));
-                m_people.setName(l_jsonObject.value("name").toString());
-                m_people.setBiography(l_jsonObject.value("biography").toString());
-                QLocale locale(QLocale::English, QLocale::UnitedStates);
-                QDate l_birthday = locale.toDate(l_jsonObject.value("birthday").toString(),"yyyy-MM-dd");
-                m_people.setBirthday(l_birthday);
-
-                Macaw::DEBUG("[FetchMetadataQuery] Processing done, ["+QString::number(l_tmdbID)+ "]");
-            } else {
-                Macaw::DEBUG("[FetchMetadataQuery] received ["+QString::number(l_tmdbID)+ "] != "+QString::number(m_people.tmdbId()));
-            }
-        }
-    }    
+/**
+ * @brief Slot triggered when the reply of a people request has been parsed
+ *
+ * @param people read from the reply
+ * @param status of the parsing (FetchMetadataParser::parseStatus)
+ * @param error of the reply
+ */
+void FetchMetadataQuery::on_peopleParsed(const People &people, int status, const QString &error)
+{
+    if (status == FetchMetadataParser::RateLimited) {
+        Macaw::DEBUG("[FetchMetadataQuery] To many request, wait 10s");
+        QTimer::singleShot(10000, this, SLOT(resendPeopleRequest()));
+
+        return;
+    }
+    if (status == FetchMetadataParser::Invalid) {
+        emit peopleNetworkError(error);
+
+        return;
+    }
+    if (people.tmdbId() != m_people.tmdbId()) {
+        Macaw::DEBUG("[FetchMetadataQuery] received ["+QString::number(people.tmdbId())+ "] != "+QString::number(m_people.tmdbId()));
+        emit peopleNetworkError("Unexpected person received");
+
+        return;
+    }
+
+    m_people.setName(people.name());
+    m_people.setBiography(people.biography());
+    m_people.setBirthday(people.birthday());
+    Macaw::DEBUG("[FetchMetadataQuery] Processing done, ["+QString::number(people.tmdbId())+ "]");
 
     emit(peopleResponse(m_people));
 }
 
+void FetchMetadataQuery::resendPrimaryRequest()
+{
+    this->sendPrimaryRequest(m_movie.title());
+}
+
+void FetchMetadataQuery::resendMovieRequest()
+{
+    this->sendMovieRequest(m_movie.tmdbId());
+}
+
+void FetchMetadataQuery::resendPeopleRequest()
+{
+    this->sendPeopleRequest(m_people.tmdbId());
+}
+
 void FetchMetadataQuery::on_posterRequestResponse(QNetworkReply *reply) {
     Macaw::DEBUG("[FetchMetadataQuery] Poster Request response received");
 
@@ -359,3 +349,17 @@ void FetchMetadataQuery::slotError(int error)
     Macaw::DEBUG("[FetchMetadataQuery] Error " + QString::number(error));
     emit(networkError(QString::number(error)));
 }
+
+/**
+ * @brief Gives the error of a reply
+ * @param reply
+ * @return the error message, empty if the request succeeded
+ */
+QString FetchMetadataQuery::replyError(QNetworkReply *reply)
+{
+    if (reply->error() == QNetworkReply::NoError) {
+        return QString();
+    }
+
+    return reply->errorString();
+}
@@ -20,6 +20,7 @@
 #ifndef FETCHMETADATAQUERY_H
 #define FETCHMETADATAQUERY_H
 
+#include <QHash>
 #include <QObject>
 
 #include "Entities/Movie.h"
@@ -52,12 +53,14 @@ public:
     void sendPeopleRequest(int tmdbID);
     void sendPosterRequest(QString poster_path);
     bool isInitialized() { return m_initialized; }
+    QHash<int, double> popularityHash() const { return m_popularityHash; }
 
 signals:
     void primaryResponse(const QList<Movie>&);
     void movieResponse(const Movie&);
     void networkError(QString);
     void peopleResponse(const People&);
+    void peopleNetworkError(QString);
 
 private slots:
     void on_initRequestResponse(QNetworkReply *reply);
@@ -65,6 +68,11 @@ private slots:
     void on_movieRequestResponse(QNetworkReply *reply);
     void on_peopleRequestResponse(QNetworkReply *reply);
     void on_posterRequestResponse(QNetworkReply *reply);
+    void on_movieParsed(const Movie &movie, int status, const QString &error);
+    void on_peopleParsed(const People &people, int status, const QString &error);
+    void resendPrimaryRequest();
+    void resendMovieRequest();
+    void resendPeopleRequest();
     void slotError(int error);
 
 private:
@@ -76,6 +84,12 @@ private:
     Application *m_app;
     Movie m_movie;
     People m_people;
+
+    /**
+     * @brief TMDb popularity of the movies of the last primary response
+     */
+    QHash<int, double> m_popularityHash;
+    QString replyError(QNetworkReply *reply);
 };
 
 #endif // FETCHMETADATAQUERY_H
@@ -0,0 +1,212 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MovieMatcher.h"
+
+#include <QDate>
+#include <QFileInfo>
+#include <QPair>
+#include <QRegExp>
+#include <QSet>
+#include <QtAlgorithms>
+
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param movie known by Macaw, whose title is usually its file name
+ */
+MovieMatcher::MovieMatcher(const Movie &movie)
+{
+    m_tokenList = titleTokens(movie.title());
+    m_year = yearFromFileName(movie.title());
+    if (m_year == 0) {
+        m_year = yearFromFileName(QFileInfo(movie.fileRelativePath()).completeBaseName());
+    }
+}
+
+/**
+ * @brief Scores the candidates and sorts them, best first.
+ * The ties keep the order given by TMDb.
+ *
+ * @param candidateList returned by a TMDb search
+ * @param popularityHash: TMDb popularity of the candidates, by TMDb id
+ * @return the sorted candidates
+ */
+QList<Movie> MovieMatcher::rank(const QList<Movie> &candidateList, const QHash<int, double> &popularityHash)
+{
+    double l_maxPopularity = 0;
+    foreach (Movie l_candidate, candidateList) {
+        l_maxPopularity = qMax(l_maxPopularity, popularityHash.value(l_candidate.tmdbId()));
+    }
+
+    QList<QPair<double, int> > l_scoreIndexList;
+    for (int i = 0 ; i < candidateList.size() ; i++) {
+        Movie l_candidate = candidateList.at(i);
+        double l_popularity = 0;
+        if (l_maxPopularity > 0) {
+            l_popularity = popularityHash.value(l_candidate.tmdbId()) / l_maxPopularity;
+        }
+        double l_score = 0.6 * qMax(titleSimilarity(l_candidate.title()),
+                                    titleSimilarity(l_candidate.originalTitle()))
+                       + 0.25 * yearAgreement(l_candidate)
+                       + 0.15 * l_popularity;
+        l_scoreIndexList.append(qMakePair(l_score, -i));
+    }
+    qSort(l_scoreIndexList.begin(), l_scoreIndexList.end(), qGreater<QPair<double, int> >());
+
+    QList<Movie> l_rankedList;
+    m_scoreList.clear();
+    for (int i = 0 ; i < l_scoreIndexList.size() ; i++) {
+        l_rankedList.append(candidateList.at(-l_scoreIndexList.at(i).second));
+        m_scoreList.append(l_scoreIndexList.at(i).first);
+    }
+    if (!l_rankedList.isEmpty()) {
+        Macaw::DEBUG("[MovieMatcher] Best match: " + l_rankedList.first().title()
+                     + " (" + QString::number(m_scoreList.first(), 'f', 2) + ")");
+    }
+
+    return l_rankedList;
+}
+
+/**
+ * @brief Tells if the best of the last ranked candidates can be accepted
+ * without asking the user
+ *
+ * @return bool
+ */
+bool MovieMatcher::isConfident() const
+{
+    if (m_scoreList.isEmpty() || m_scoreList.first() < MATCH_ACCEPT_SCORE) {
+
+        return false;
+    }
+
+    return m_scoreList.size() == 1
+            || m_scoreList.at(0) - m_scoreList.at(1) >= MATCH_MIN_MARGIN;
+}
+
+/**
+ * @brief Score of the best of the last ranked candidates, 0 if there is none
+ *
+ * @return double between 0 and 1
+ */
+double MovieMatcher::bestScore() const
+{
+    return m_scoreList.isEmpty() ? 0 : m_scoreList.first();
+}
+
+/**
+ * @brief Splits a title into lower case words.
+ * File names usually go on after the title with the release year and
+ * release tags: they are cut there.
+ *
+ * @param title
+ * @return the words of the title
+ */
+QStringList MovieMatcher::titleTokens(const QString &title)
+{
+    static QStringList s_releaseTags = QStringList()
+            << "1080p" << "720p" << "480p" << "2160p" << "4k"
+            << "bluray" << "bdrip" << "brrip" << "dvdrip" << "webrip" << "hdtv"
+            << "web" << "dvd" << "xvid" << "divx" << "x264" << "x265" << "h264" << "hevc"
+            << "aac" << "ac3" << "dts" << "extended" << "unrated" << "remastered"
+            << "multi" << "vostfr" << "truefrench" << "proper" << "repack";
+
+    QStringList l_tokenList;
+    QStringList l_splittedTitle = title.toLower().split(QRegExp("[\\W_]+"), QString::SkipEmptyParts);
+    QRegExp l_year("(19|20)\\d\\d");
+    foreach (QString l_token, l_splittedTitle) {
+        if (!l_tokenList.isEmpty()
+                && (l_year.exactMatch(l_token) || s_releaseTags.contains(l_token))) {
+            break;
+        }
+        l_tokenList.append(l_token);
+    }
+
+    return l_tokenList;
+}
+
+/**
+ * @brief Finds the release year in a file name.
+ * A year at the very beginning is considered as part of the title
+ * (e.g. "2001 A Space Odyssey").
+ *
+ * @param fileName
+ * @return the year, or 0 if none was found
+ */
+int MovieMatcher::yearFromFileName(const QString &fileName)
+{
+    QRegExp l_year("(^|\\D)((19|20)\\d\\d)(?=\\D|$)");
+    int l_foundYear = 0;
+    int l_position = l_year.indexIn(fileName);
+    while (l_position != -1) {
+        if (l_position + l_year.cap(1).size() > 0) {
+            l_foundYear = l_year.cap(2).toInt();
+        }
+        l_position = l_year.indexIn(fileName, l_position + l_year.matchedLength());
+    }
+
+    return l_foundYear;
+}
+
+/**
+ * @brief Dice coefficient between the words of the local title and of a candidate title
+ *
+ * @param title of the candidate
+ * @return double between 0 and 1
+ */
+double MovieMatcher::titleSimilarity(const QString &title) const
+{
+    QSet<QString> l_localSet = m_tokenList.toSet();
+    QSet<QString> l_candidateSet = titleTokens(title).toSet();
+    if (l_localSet.isEmpty() || l_candidateSet.isEmpty()) {
+
+        return 0;
+    }
+    int l_common = QSet<QString>(l_localSet).intersect(l_candidateSet).size();
+
+    return 2.0 * l_common / (l_localSet.size() + l_candidateSet.size());
+}
+
+/**
+ * @brief Agreement between the year of the file name and the release date of a candidate
+ *
+ * @param candidate
+ * @return 1 for the same year, 0.5 for one year apart or if unknown, else 0
+ */
+double MovieMatcher::yearAgreement(const Movie &candidate) const
+{
+    if (m_year == 0 || !candidate.releaseDate().isValid()) {
+
+        return 0.5;
+    }
+    int l_difference = qAbs(candidate.releaseDate().year() - m_year);
+    if (l_difference == 0) {
+
+        return 1;
+    } else if (l_difference == 1) {
+
+        return 0.5;
+    }
+
+    return 0;
+}
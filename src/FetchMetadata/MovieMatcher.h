@@ -0,0 +1,63 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MOVIEMATCHER_H
+#define MOVIEMATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+
+#include "Entities/Movie.h"
+
+/**
+ * @brief Scores the results of a TMDb search against a local movie.
+ *
+ * The score mixes the similarity of the titles, the agreement of the
+ * release year with the one found in the file name, and the popularity
+ * of the result. The best result is accepted without asking the user only
+ * if it is good enough and clearly ahead of the next one.
+ */
+class MovieMatcher
+{
+    #define MATCH_ACCEPT_SCORE 0.7
+    #define MATCH_MIN_MARGIN 0.1
+
+public:
+    explicit MovieMatcher(const Movie &movie);
+    QList<Movie> rank(const QList<Movie> &candidateList, const QHash<int, double> &popularityHash);
+    bool isConfident() const;
+    double bestScore() const;
+    static QStringList titleTokens(const QString &title);
+    static int yearFromFileName(const QString &fileName);
+
+private:
+    QStringList m_tokenList;
+    int m_year;
+
+    /**
+     * @brief Scores of the last ranked candidates, best first
+     */
+    QList<double> m_scoreList;
+    double titleSimilarity(const QString &title) const;
+    double yearAgreement(const Movie &candidate) const;
+};
+
+#endif // MOVIEMATCHER_H
@@ -38,6 +38,8 @@ RC_ICONS = img/logov0_256.ico
 
 SOURCES += main.cpp \
     Application.cpp \
+    Catalog.cpp \
+    CatalogTask.cpp \
     DatabaseManager.cpp \
     DatabaseManager_getters.cpp \
     DatabaseManager_insert.cpp \
@@ -45,18 +47,32 @@ SOURCES += main.cpp \
     DatabaseManager_delete.cpp \
     MacawDebug.cpp \    
     MainWindow.cpp \    
+    MountPointResolver.cpp \
+    MoviesSearchTask.cpp \
+    SearchIndex.cpp \
+    SearchIndexTask.cpp \
     ServicesManager.cpp \
+    SortKey.cpp \
+    StringPool.cpp \
+    TrashJob.cpp \
     Dialogs/PeopleDialog.cpp \
     Dialogs/MovieDialog.cpp \
+    Dialogs/OrphansDialog.cpp \
     Entities/Movie.cpp \
     Entities/People.cpp \
     Entities/Playlist.cpp \
     Entities/Tag.cpp \
     FetchMetadata/FetchMetadata.cpp \
     FetchMetadata/FetchMetadataDialog.cpp \
+    FetchMetadata/FetchMetadataParser.cpp \
     FetchMetadata/FetchMetadataQuery.cpp \
+    FetchMetadata/MovieMatcher.cpp \
     MainWindowWidgets/LeftPannel.cpp \
     MainWindowWidgets/MoviesPannel.cpp \
+    MainWindowWidgets/MoviesTableModel.cpp \
+    MainWindowWidgets/PosterCache.cpp \
+    MainWindowWidgets/PosterDelegate.cpp \
+    MainWindowWidgets/PosterLoadTask.cpp \
     MainWindowWidgets/MainPannel.cpp \
     MainWindowWidgets/MetadataPannel.cpp \
     Entities/Entity.cpp \
@@ -71,11 +87,21 @@ SOURCES += main.cpp \
 HEADERS  += \
     include_var.h \
     Application.h \
+    Catalog.h \
+    CatalogTask.h \
     DatabaseManager.h \
     MacawDebug.h \
     MainWindow.h \
+    MountPointResolver.h \
+    MoviesSearchTask.h \
+    SearchIndex.h \
+    SearchIndexTask.h \
     ServicesManager.h \
+    SortKey.h \
+    StringPool.h \
+    TrashJob.h \
     Dialogs/MovieDialog.h \
+    Dialogs/OrphansDialog.h \
     Dialogs/PeopleDialog.h \
     Entities/Movie.h \
     Entities/People.h \
@@ -83,9 +109,15 @@ HEADERS  += \
     Entities/Tag.h \
     FetchMetadata/FetchMetadataDialog.h \
     FetchMetadata/FetchMetadata.h \
+    FetchMetadata/FetchMetadataParser.h \
     FetchMetadata/FetchMetadataQuery.h \
+    FetchMetadata/MovieMatcher.h \
     MainWindowWidgets/LeftPannel.h \
     MainWindowWidgets/MoviesPannel.h \
+    MainWindowWidgets/MoviesTableModel.h \
+    MainWindowWidgets/PosterCache.h \
+    MainWindowWidgets/PosterDelegate.h \
+    MainWindowWidgets/PosterLoadTask.h \
     MainWindowWidgets/MainPannel.h \
     MainWindowWidgets/MetadataPannel.h \
     Entities/Entity.h \
@@ -101,6 +133,7 @@ HEADERS  += \
 FORMS    += \
     MainWindow.ui \
     Dialogs/MovieDialog.ui \
+    Dialogs/OrphansDialog.ui \
     Dialogs/PeopleDialog.ui \
     FetchMetadata/FetchMetadataDialog.ui \
     MainWindowWidgets/LeftPannel.ui \
@@ -23,10 +23,12 @@
 #include <QDirIterator>
 #include <QMessageBox>
 #include <QSettings>
+#include <QTimer>
 
 #include "enumerations.h"
 #include "include_var.h"
 
+#include "Catalog.h"
 #include "MacawDebug.h"
 #include "ServicesManager.h"
 #include "Dialogs/SettingsDialog.h"
@@ -68,12 +70,23 @@ MainWindow::MainWindow(QWidget *parent) :
     m_ui->moviesButton->setFlat(true);
     m_ui->moviesButton->setChecked(true);
     m_moviesOrShows = Macaw::movie;
+    m_mainPannelStale = true;
     connect(m_mainPannel, SIGNAL(startFetchingMetadata(QList<Movie>)),
             this, SLOT(onStartFetchingMetadata(QList<Movie>)));
+    connect(m_mainPannel, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)),
+            this, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)));
+
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(SEARCH_DEBOUNCE_DELAY);
+    connect(m_searchTimer, SIGNAL(timeout()),
+            this, SLOT(updatePannels()));
 
     ServicesManager *servicesManager = ServicesManager::instance();
-    connect(servicesManager, SIGNAL(requestPannelsUpdate()),
-            this, SLOT(selfUpdate()));
+    connect(servicesManager, SIGNAL(matchingMoviesChanged(bool)),
+            this, SLOT(onMatchingMoviesChanged(bool)));
+    connect(servicesManager, SIGNAL(requestPannelsUpdate(int)),
+            this, SLOT(selfUpdate(int)));
     connect(servicesManager, SIGNAL(requestTempStatusBarMessage(QString,int)),
             this, SLOT(putTempStatusBarMessage(QString,int)));
     connect(m_leftPannel, SIGNAL(updateMainPannel()),
@@ -145,8 +158,11 @@ void MainWindow::on_moviesButton_clicked()
                 this, SLOT(fillMetadataPannel(Movie)));
         connect(m_mainPannel, SIGNAL(startFetchingMetadata(QList<Movie>)),
                 this, SLOT(onStartFetchingMetadata(QList<Movie>)));
+        connect(m_mainPannel, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)),
+                this, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)));
         m_metadataPannel->hide();
         m_moviesOrShows = Macaw::movie;
+        m_mainPannelStale = true;
 
         this->updatePannels();
     }
@@ -173,9 +189,12 @@ void MainWindow::on_showsButton_clicked()
                 this, SLOT(fillMetadataPannel(Movie)));
         connect(m_mainPannel, SIGNAL(startFetchingMetadata(QList<Movie>)),
                 this, SLOT(onStartFetchingMetadata(QList<Movie>)));
+        connect(m_mainPannel, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)),
+                this, SIGNAL(prioritizeFetchingMetadata(QList<int>,int)));
 
         m_metadataPannel->hide();
         m_moviesOrShows = Macaw::show;
+        m_mainPannelStale = true;
 
         this->updatePannels();
     }
@@ -183,6 +202,7 @@ void MainWindow::on_showsButton_clicked()
 
 /**
  * @brief Returns the movies to display in mainWindow, based on an id and m_typeElement.
+ * They are read from the catalog when it is ready, else from the database.
  *
  * @param id of the leftPannel element
  * @return QList of movies to display
@@ -190,9 +210,24 @@ void MainWindow::on_showsButton_clicked()
 QList<Movie> MainWindow::moviesToDisplay(int id, bool movieOrShow)
 {
     Macaw::DEBUG("[MainWindow] moviesToDisplay()");
-    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+    ServicesManager *servicesManager = ServicesManager::instance();
+    DatabaseManager *databaseManager = servicesManager->databaseManager();
 
     m_leftPannel->setSelectedId(id);
+    const Catalog *l_catalog = servicesManager->catalog();
+    if (l_catalog != 0
+            && (m_leftPannel->selectedId() == 0
+                || m_leftPannel->typeElement() == Macaw::isPeople
+                || m_leftPannel->typeElement() == Macaw::isTag)) {
+        Catalog::Filter l_filter;
+        l_filter.show = movieOrShow;
+        l_filter.typeElement = m_leftPannel->typeElement();
+        l_filter.elementId = m_leftPannel->selectedId();
+        l_filter.peopleType = m_leftPannel->typePeople();
+
+        return l_catalog->movies(l_catalog->select(l_filter));
+    }
+
     if(m_leftPannel->selectedId() == 0) {
 
         return databaseManager->getAllMovies(movieOrShow);
@@ -224,56 +259,103 @@ QList<Movie> MainWindow::moviesToDisplay(int id, bool movieOrShow)
 
 /**
  * @brief Slot triggered when enter pressed in the search field
- * Call `updatePannels()`
+ * Searches at once if the typed text has not been searched yet
  */
 void MainWindow::on_searchEdit_editingFinished()
 {
     Macaw::DEBUG("[MainWindow] editing finished on searchEdit");
-    this->updatePannels();
+    if (m_searchTimer->isActive()) {
+        m_searchTimer->stop();
+        this->updatePannels();
+    }
+}
+
+/**
+ * @brief Slot triggered at each change in the search field.
+ * The search starts when no key has been typed for SEARCH_DEBOUNCE_DELAY ms.
+ */
+void MainWindow::on_searchEdit_textChanged()
+{
+    m_searchTimer->start();
 }
 
 /**
- * @brief Slot triggered when Dialogs are closed in order to update the pannels
- * Call `updatePannels()`
+ * @brief Slot triggered by ServicesManager, once the refresh requests
+ * of the dialogs, of the database... have been merged.
+ * The left pannel also fills the main pannel, so it is refreshed alone.
+ *
+ * @param dirtyPannels: pannels to refresh (Macaw::dirtyPannels flags)
  */
-void MainWindow::selfUpdate()
+void MainWindow::selfUpdate(int dirtyPannels)
 {
     Macaw::DEBUG("[MainWindow] selfUpdate() triggered");
 
-    this->updatePannels();
+    if (dirtyPannels & (Macaw::DirtyLeftPannel | Macaw::DirtyMainPannel)) {
+        m_mainPannelStale = true;
+        this->updatePannels();
+    }
+
+    if (dirtyPannels & Macaw::DirtyMetadataPannel
+            && m_metadataPannel->isVisible()
+            && m_metadataPannel->movieId() != 0) {
+        DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+        m_metadataPannel->fill(databaseManager->getOneMovieById(m_metadataPannel->movieId()));
+    }
 }
 
 /**
- * @brief MainWindow::updateMainPannel
+ * @brief Reads the movies of the element selected in the leftPannel
+ * and fills the main pannel with those matching the search
  */
 void MainWindow::updateMainPannel()
 {
     Macaw::DEBUG("[MainWindow] updateMainWindow triggered");
-    QList<Movie> l_movieList = moviesToDisplay(m_leftPannel->selectedId(), m_moviesOrShows);
-    m_mainPannel->fill(l_movieList);
+    m_pannelMovieList = moviesToDisplay(m_leftPannel->selectedId(), m_moviesOrShows);
+    m_mainPannelStale = false;
+    m_mainPannel->fill(m_pannelMovieList);
 }
 
 /**
- * @brief MainWindow::onStartFetchingMetadata
+ * @brief Slot triggered when ServicesManager found movies matching the search.
+ * The results come by batches: each one is shown in the main pannel,
+ * and the leftPannel is filled with the last one.
+ *
+ * @param finished: true when the search is over
+ */
+void MainWindow::onMatchingMoviesChanged(bool finished)
+{
+    if (m_mainPannelStale) {
+        this->updateMainPannel();
+    } else {
+        m_mainPannel->fill(m_pannelMovieList);
+    }
+
+    if (finished) {
+        m_leftPannel->fill();
+    }
+}
+
+/**
+ * @brief Slot triggered when the user asks for the metadata of some movies.
+ * They are fetched before the others.
  */
 void MainWindow::onStartFetchingMetadata(const QList<Movie> &movieList)
 {
-    emit startFetchingMetadata(movieList);
+    emit startFetchingMetadata(movieList, Macaw::FetchUserRequested);
 }
 
 /**
  * @brief Filter the pannels to follow the requirements of the search field, playlists...
+ * The search runs in another thread, the pannels are filled by
+ * `onMatchingMoviesChanged()`.
  */
 void MainWindow::updatePannels()
 {
-    Macaw::DEBUG_IN("[MainWindow] Enters updatePannels()");
+    Macaw::DEBUG("[MainWindow] updatePannels()");
     QString l_text = m_ui->searchEdit->text();
 
     ServicesManager *servicesManager = ServicesManager::instance();
-    servicesManager->setMatchingMovieList(l_text, m_moviesOrShows);
-
-    m_leftPannel->fill();
-    Macaw::DEBUG_OUT("[MainWindow] Exits updatePannels()");
+    servicesManager->searchMovies(l_text, m_moviesOrShows);
 }
 
 /**
@@ -307,6 +389,9 @@ void MainWindow::addNewMovies()
                            << "m4v";
 
     foreach (PathForMovies l_moviesPath, l_moviesPathList) {
+        // The movies of a folder are inserted in one transaction,
+        // so that they come in one change signal
+        databaseManager->beginTransaction();
         QDirIterator l_file(l_moviesPath.path(),
                             QDir::NoDotAndDotDot | QDir::Files,QDirIterator::Subdirectories);
         while (l_file.hasNext()) {
@@ -339,6 +424,7 @@ void MainWindow::addNewMovies()
                     ServicesManager::instance()->requestTempStatusBarMessage("Movies imported: "
                                                                              +QString::number(l_addedCount));
                     if(l_addedCount == 5) {
+                        m_mainPannelStale = true;
                         this->updatePannels();
                     }
                 } else {
@@ -347,14 +433,15 @@ void MainWindow::addNewMovies()
             }
         }
         databaseManager->setMoviesPathImported(l_moviesPath.path(), true);
+        databaseManager->commitTransaction();
     }
 
     QList<Movie> l_moviesToFetch = databaseManager->getMoviesNotImported();
     if (!l_moviesToFetch.isEmpty()) {
         Macaw::DEBUG("[MainWindow] FetchingMetadata requested");
-        emit startFetchingMetadata(l_moviesToFetch);
+        emit startFetchingMetadata(l_moviesToFetch, Macaw::FetchBackground);
     }
-    this->updatePannels();
+    ServicesManager::instance()->scheduleRefresh(Macaw::DirtyAllPannels);
     Macaw::DEBUG_OUT("[MainWindow] Exit addNewMovies");
 }
 
@@ -446,3 +533,12 @@ void MainWindow::on_actionAbout_triggered()
                             .arg(QT_VERSION_STR)
                        );
 }
+
+/**
+ * @brief Slot triggered when the user wants to choose the metadata
+ * of the movies that could not be matched automatically
+ */
+void MainWindow::on_actionReview_Unmatched_Movies_triggered()
+{
+    emit reviewFetchingMetadata();
+}
@@ -22,6 +22,8 @@
 
 #include <QMainWindow>
 
+class QTimer;
+
 class LeftPannel;
 class MainPannel;
 class MetadataPannel;
@@ -39,6 +41,7 @@ class MainWindow;
  */
 class MainWindow : public QMainWindow
 {
+    #define SEARCH_DEBOUNCE_DELAY 250
     Q_OBJECT
 public:
     explicit MainWindow(QWidget *parent = 0);
@@ -47,11 +50,15 @@ public:
 private slots:
     void on_actionEdit_Settings_triggered();
     void on_toWatchButton_clicked();  
-    void selfUpdate();
+    void selfUpdate(int dirtyPannels);
     void updateMainPannel();
     void addNewMovies();
     void on_searchEdit_editingFinished();
+    void on_searchEdit_textChanged();
+    void onMatchingMoviesChanged(bool finished);
+    void updatePannels();
     void on_actionAbout_triggered();
+    void on_actionReview_Unmatched_Movies_triggered();
     void closeEvent(QCloseEvent *event);
     void fillMetadataPannel(const Movie &movie);
     void putTempStatusBarMessage(QString message, int time);
@@ -60,7 +67,9 @@ private slots:
     void onStartFetchingMetadata(const QList<Movie> &movieList);
 
 signals:
-    void startFetchingMetadata(const QList<Movie>&);
+    void startFetchingMetadata(const QList<Movie>&, int);
+    void prioritizeFetchingMetadata(const QList<int>&, int);
+    void reviewFetchingMetadata();
 
 private:
     Ui::MainWindow *m_ui;
@@ -69,9 +78,21 @@ private:
     MetadataPannel *m_metadataPannel;
     bool m_moviesOrShows;
 
+    /**
+     * @brief Movies of the element selected in the leftPannel, before
+     * the search filter: typing only filters them again.
+     * They are read again when m_mainPannelStale is true.
+     */
+    QList<Movie> m_pannelMovieList;
+    bool m_mainPannelStale;
+
+    /**
+     * @brief Waits for the end of the typing before searching
+     */
+    QTimer *m_searchTimer;
+
     void readSettings();
     QList<Movie> moviesToDisplay(int id, bool movieOrSeries);
-    void updatePannels();
 
 };
 
@@ -20,18 +20,62 @@
 #include "LeftPannel.h"
 #include "ui_LeftPannel.h"
 
+#include <QCollator>
+#include <QHash>
 #include <QMenu>
+#include <QSet>
 
 #include "enumerations.h"
 
+#include "Catalog.h"
 #include "MacawDebug.h"
 #include "ServicesManager.h"
+#include "SortKey.h"
 #include "Dialogs/PeopleDialog.h"
 #include "Entities/Movie.h"
 #include "Entities/People.h"
 #include "Entities/Playlist.h"
 #include "Entities/Tag.h"
 
+/**
+ * @brief Item of the listWidget, sorted on the sort key of its name.
+ * "All" and "Unknown" always come first.
+ */
+class ElementListItem : public QListWidgetItem
+{
+public:
+    explicit ElementListItem(const QString &text) :
+        QListWidgetItem(text)
+    {}
+
+    bool operator<(const QListWidgetItem &other) const
+    {
+        int l_rank = rank(this->data(Macaw::ObjectId).toInt());
+        int l_otherRank = rank(other.data(Macaw::ObjectId).toInt());
+        if (l_rank != l_otherRank) {
+
+            return l_rank < l_otherRank;
+        }
+        static const QCollator s_collator;
+
+        return s_collator.compare(this->data(Macaw::SortKey).toString(),
+                                  other.data(Macaw::SortKey).toString()) < 0;
+    }
+
+private:
+    static int rank(const int objectId)
+    {
+        switch (objectId) {
+        case 0:
+            return 0;
+        case -1:
+            return 1;
+        default:
+            return 2;
+        }
+    }
+};
+
 /**
  * @brief Constructor
  * @author Olivier CHURLAUD <olivier@churlaud.com>
@@ -69,119 +113,169 @@ void LeftPannel::fill()
 {
     Macaw::DEBUG_IN("[LefPannel] Enters fill()");
 
-    this->setElementIdList();
+    this->setElementIdSet();
     this->fillListWidget();
 
     Macaw::DEBUG_OUT("[LefPannel] Exits fill()");
 }
 
 /**
- * @brief Set the ElementIdList, used to fill the listWidget
+ * @brief Set the ElementIdSet, used to fill the listWidget.
+ * The links between the movies and the elements are read at once,
+ * from the catalog when it is ready.
  */
-void LeftPannel::setElementIdList()
+void LeftPannel::setElementIdSet()
 {
-    Macaw::DEBUG_IN("[LeftPannel] Enters setElementIdList()");
+    Macaw::DEBUG_IN("[LeftPannel] Enters setElementIdSet()");
 
-    m_elementIdList.clear();
+    m_elementIdSet.clear();
 
     ServicesManager *servicesManager = ServicesManager::instance();
     DatabaseManager *databaseManager = servicesManager->databaseManager();
 
-    QList<Movie> l_matchingMovieList = servicesManager->matchingMovieList();
+    const Catalog *l_catalog = servicesManager->catalog();
+    if (l_catalog != 0) {
+        m_elementIdSet = l_catalog->elementIds(l_catalog->select(servicesManager->shownMoviesFilter()),
+                                               m_typeElement,
+                                               m_typePeople);
+        Macaw::DEBUG_OUT("[LefPannel] Exits setElementIdSet()");
 
-    foreach(Movie l_movie, l_matchingMovieList) {
-        if( (servicesManager->toWatchState()
-                 && databaseManager->isMovieInPlaylist(l_movie.id(), Playlist::ToWatch)
-                 ) || !servicesManager->toWatchState()
-               ) {
-            switch (m_typeElement)
-            {
-                case Macaw::isPeople:
-                {
-                    QList<People> l_peopleList = databaseManager->getPeopleByMovie(l_movie, m_typePeople);
-                    this->updateElementIdList(l_peopleList);
-                    break;
-                }
-                case Macaw::isTag:
-                {
-                    QList<Tag> l_tagList = l_movie.tagList();
-                    this->updateElementIdList(l_tagList);
-                    break;
-                }
-            }
-        }
+        return;
     }
-    Macaw::DEBUG_OUT("[LefPannel] Exits setElementIdList()");
-}
 
-/**
- * @brief Add/Update the elementIdList
- * @author Olivier CHURLAUD <olivier@churlaud.com>
- *
- * @param list of objects of the movie
- */
-template<typename T> void LeftPannel::updateElementIdList(const QList<T> &entityList)
-{
-    if(entityList.isEmpty()
-       && !m_elementIdList.contains(-1)
-      ) {
-        m_elementIdList.append(-1);
+    QHash<int, QList<int> > l_elementIdHash;
+    switch (m_typeElement)
+    {
+        case Macaw::isPeople:
+            l_elementIdHash = databaseManager->getPeopleIdsByMovieId(m_typePeople);
+            break;
+        case Macaw::isTag:
+            l_elementIdHash = databaseManager->getTagIdsByMovieId();
+            break;
     }
-    foreach(T l_entity, entityList) {
-        if(!m_elementIdList.contains(l_entity.id())) {
-            m_elementIdList.append(l_entity.id());
+
+    foreach(int l_movieId, servicesManager->matchingMovieIdList()) {
+        if(servicesManager->isMovieShown(l_movieId)) {
+            QList<int> l_elementIdList = l_elementIdHash.value(l_movieId);
+            if (l_elementIdList.isEmpty()) {
+                m_elementIdSet.insert(-1);
+            }
+            foreach (int l_elementId, l_elementIdList) {
+                m_elementIdSet.insert(l_elementId);
+            }
         }
     }
+    Macaw::DEBUG_OUT("[LefPannel] Exits setElementIdSet()");
 }
 
 /**
- * @brief fill the listWidget based on m_elementIdList
+ * @brief fill the listWidget based on m_elementIdSet
+ * The names are read from the catalog when there is one.
+ * The shown items are kept and only the differences are applied,
+ * so that the selection does not move.
+ * If the selected element disappeared, "All" is selected and the
+ * Main Pannel is requested to be filled again
+ *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
 void LeftPannel::fillListWidget()
 {
     Macaw::DEBUG_IN("[LeftPannel] Enters fillListWidget()");
 
-    m_ui->listWidget->clear();
-
     DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+    const Catalog *l_catalog = ServicesManager::instance()->catalog();
+    QListWidget *l_listWidget = m_ui->listWidget;
+    l_listWidget->blockSignals(true);
 
+    QSet<int> l_wantedIdSet = m_elementIdSet;
     // Add the "All" element
     if(m_typeElement != Macaw::isPlaylist) {
-        // First space needed for sorting
-        Entity l_entity(" All");
-        l_entity.setId(0);
+        l_wantedIdSet.insert(0);
+    }
 
-        this->addEntityToListWidget(l_entity);
+    // Remove the elements not wanted anymore, or of another type
+    QHash<int, QListWidgetItem*> l_shownItemHash;
+    for (int i = l_listWidget->count() - 1 ; i >= 0 ; i--) {
+        QListWidgetItem *l_item = l_listWidget->item(i);
+        int l_objectId = l_item->data(Macaw::ObjectId).toInt();
+        if (l_wantedIdSet.contains(l_objectId)
+                && l_item->data(Macaw::ObjectType).toInt() == m_typeElement
+                && l_item->data(Macaw::PeopleType).toInt() == m_typePeople) {
+            l_shownItemHash.insert(l_objectId, l_item);
+        } else {
+            delete l_listWidget->takeItem(i);
+        }
     }
 
-    // @TODO: this loop is too long
-    foreach(int l_objectId, m_elementIdList) {
-        if(l_objectId == -1) {
-            // First space needed for sorting
-            Entity l_entity(" Unknown");
+    bool l_needSorting = false;
+    foreach(int l_objectId, l_wantedIdSet) {
+        Entity l_entity;
+        if(l_objectId == 0) {
+            // Kept first by ElementListItem
+            l_entity.setName(" All");
+            l_entity.setId(0);
+        } else if(l_objectId == -1) {
+            // Kept first by ElementListItem
+            l_entity.setName(" Unknown");
             l_entity.setId(-1);
-
-            this->addEntityToListWidget(l_entity);
         } else {
-            Entity l_entity;
             switch (m_typeElement)
             {
             case Macaw::isPeople:
-                l_entity = databaseManager->getOnePeopleById(l_objectId);
+                if (l_catalog != 0) {
+                    l_entity.setId(l_objectId);
+                    l_entity.setName(l_catalog->peopleName(l_objectId));
+                } else {
+                    l_entity = databaseManager->getOnePeopleById(l_objectId);
+                }
                 break;
             case Macaw::isTag:
-                l_entity = databaseManager->getOneTagById(l_objectId);
+                if (l_catalog != 0) {
+                    l_entity.setId(l_objectId);
+                    l_entity.setName(l_catalog->tagName(l_objectId));
+                } else {
+                    l_entity = databaseManager->getOneTagById(l_objectId);
+                }
                 break;
             }
+        }
 
+        QListWidgetItem *l_item = l_shownItemHash.value(l_objectId);
+        if (l_item == NULL) {
             this->addEntityToListWidget(l_entity);
+            l_needSorting = true;
+        } else if (l_item->text() != l_entity.name()) {
+            l_item->setText(l_entity.name());
+            l_item->setData(Macaw::SortKey, SortKey::name(l_entity.name()));
+            l_needSorting = true;
+        }
+    }
+    if (l_needSorting) {
+        l_listWidget->sortItems();
+    }
+
+    // Keep the selected element if it is still there, else select "All"
+    int l_previousSelectedId = m_selectedId;
+    QListWidgetItem *l_selectedItem = NULL;
+    for (int i = 0 ; i < l_listWidget->count() ; i++) {
+        if (l_listWidget->item(i)->data(Macaw::ObjectId).toInt() == m_selectedId) {
+            l_selectedItem = l_listWidget->item(i);
+            break;
         }
     }
-    if(m_ui->listWidget->selectedItems().isEmpty()) {
-        m_ui->listWidget->item(0)->setSelected(true);
+    if (l_selectedItem == NULL && l_listWidget->count() > 0) {
+        l_selectedItem = l_listWidget->item(0);
+        m_selectedId = l_selectedItem->data(Macaw::ObjectId).toInt();
+    }
+    if (l_selectedItem != NULL && !l_selectedItem->isSelected()) {
+        l_listWidget->clearSelection();
+        l_selectedItem->setSelected(true);
+    }
+
+    l_listWidget->blockSignals(false);
+    if (m_selectedId != l_previousSelectedId) {
+        emit updateMainPannel();
     }
-    m_ui->listWidget->sortItems();
 
     Macaw::DEBUG_OUT("[LeftPannel] Exits fillListWidget()");
 }
@@ -194,15 +288,12 @@ void LeftPannel::fillListWidget()
  */
 void LeftPannel::addEntityToListWidget(const Entity &entity)
 {
-    QListWidgetItem *l_item = new QListWidgetItem(entity.name());
+    QListWidgetItem *l_item = new ElementListItem(entity.name());
     l_item->setData(Macaw::ObjectId, entity.id());
+    l_item->setData(Macaw::SortKey, SortKey::name(entity.name()));
     l_item->setData(Macaw::ObjectType, m_typeElement);
     l_item->setData(Macaw::PeopleType, m_typePeople);
 
-    if (m_selectedId == entity.id()) {
-        l_item->setSelected(true);
-    }
-
     m_ui->listWidget->addItem(l_item);
 }
 
@@ -20,6 +20,7 @@
 #ifndef LEFTPANNEL_H
 #define LEFTPANNEL_H
 
+#include <QSet>
 #include <QWidget>
 
 class Entity;
@@ -74,12 +75,11 @@ private:
     int m_selectedId;
 
     /**
-     * @brief QList of ids of the leftPannel
+     * @brief QSet of ids of the leftPannel
      */
-    QList<int> m_elementIdList;
+    QSet<int> m_elementIdSet;
 
-    void setElementIdList();
-    template<typename T> void updateElementIdList(const QList<T> &list);
+    void setElementIdSet();
     void fillListWidget();
     void addEntityToListWidget(const Entity &entity);
 };
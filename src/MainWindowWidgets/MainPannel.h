@@ -22,8 +22,6 @@
 
 #include <QWidget>
 
-class QFile;
-
 class Movie;
 
 /**
@@ -43,16 +41,10 @@ signals:
     void fillMetadataPannel(const Movie&);
     void updatePannels();
     void startFetchingMetadata(const QList<Movie>&);
+    void prioritizeFetchingMetadata(const QList<int>&, int);
 
 protected:
-    bool permanentlyDeleteFile(QFile *movieFileToDelete);
     bool moveFileToTrash(QList<Movie> &movieList);
-
-private:
-    QString unix_findTrashFolder(QString movieFilePath);
-    bool linux_moveFileToTrash(QString movieFilePath);
-    bool windows_moveFileToTrash(QString movieFilePath);
-    bool macosx_moveFileToTrash(QString movieFilePath);
 };
 
 #endif // MAINPANNEL_H
@@ -45,6 +45,7 @@ public:
     explicit MetadataPannel(QWidget *parent = 0);
     ~MetadataPannel();
     void fill(const Movie &movie);
+    int movieId() const { return m_movie.id(); }
     void resizeEvent(QResizeEvent *event);
 
 private:
@@ -26,6 +26,9 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QProcess>
+#include <QScrollBar>
+#include <QSettings>
+#include <QTimer>
 #include <QUrl>
 
 #include "enumerations.h"
@@ -34,6 +37,9 @@
 #include "ServicesManager.h"
 #include "Dialogs/MovieDialog.h"
 #include "Entities/Playlist.h"
+#include "MainWindowWidgets/MoviesTableModel.h"
+#include "MainWindowWidgets/PosterCache.h"
+#include "MainWindowWidgets/PosterDelegate.h"
 
 /**
  * @brief constructor
@@ -46,14 +52,47 @@ MoviesPannel::MoviesPannel(QWidget *parent) :
     m_ui(new Ui::MoviesPannel)
 {
     m_ui->setupUi(this);
-    m_ui->tableWidget->setContentsMargins(0,0,0,0);
-    connect(m_ui->tableWidget, SIGNAL(customContextMenuRequested(QPoint)),
+    m_moviesModel = new MoviesTableModel(this);
+    m_ui->tableView->setModel(m_moviesModel);
+    m_ui->tableView->setContentsMargins(0,0,0,0);
+    connect(m_ui->tableView, SIGNAL(customContextMenuRequested(QPoint)),
                 this, SLOT(on_customContextMenuRequested(QPoint)));
+    connect(m_ui->tableView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            this, SLOT(on_selectionChanged()));
 
     this->setHeaders();
 
-    m_ui->tableWidget->addAction(m_ui->actionDelete);
-    m_ui->tableWidget->addAction(m_ui->actionEdit_mainPannelMetadata);
+    m_ui->tableView->addAction(m_ui->actionDelete);
+    m_ui->tableView->addAction(m_ui->actionEdit_mainPannelMetadata);
+
+    m_visibleRowsTimer = new QTimer(this);
+    m_visibleRowsTimer->setSingleShot(true);
+    m_visibleRowsTimer->setInterval(300);
+    connect(m_visibleRowsTimer, SIGNAL(timeout()),
+            this, SLOT(prioritizeVisibleMovies()));
+    connect(m_ui->tableView->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(on_visibleRowsChanged()));
+
+    // The poster grid shows the same model, with the same selection
+    m_posterCache = new PosterCache(QSize(POSTER_WIDTH, POSTER_HEIGHT), this);
+    m_ui->posterView->setModel(m_moviesModel);
+    QItemSelectionModel *l_posterSelectionModel = m_ui->posterView->selectionModel();
+    m_ui->posterView->setSelectionModel(m_ui->tableView->selectionModel());
+    delete l_posterSelectionModel;
+    m_ui->posterView->setItemDelegate(new PosterDelegate(m_posterCache, this));
+    m_ui->posterView->addAction(m_ui->actionDelete);
+    m_ui->posterView->addAction(m_ui->actionEdit_mainPannelMetadata);
+    connect(m_ui->posterView, SIGNAL(customContextMenuRequested(QPoint)),
+            this, SLOT(on_customContextMenuRequested(QPoint)));
+    connect(m_ui->posterView->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(on_visibleRowsChanged()));
+    connect(m_ui->posterView->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(requestVisiblePosters()));
+    connect(m_posterCache, SIGNAL(posterLoaded(QString)),
+            this, SLOT(repaintPosters()));
+
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    m_ui->actionPoster_View->setChecked(l_settings.value("moviesPannel/posterView", false).toBool());
 }
 
 /**
@@ -65,54 +104,93 @@ MoviesPannel::~MoviesPannel()
 }
 
 /**
- * @brief Set the headers of the tableWidget
+ * @brief Set the headers of the tableView.
+ * All the rows have the same height, so that the view does not need
+ * to measure the rows it does not show.
+ *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
 void MoviesPannel::setHeaders()
 {
-    int l_columnCount = 4;
-    m_ui->tableWidget->setColumnCount(l_columnCount);
-    QHeaderView* l_headerView = m_ui->tableWidget->horizontalHeader();
+    QHeaderView* l_headerView = m_ui->tableView->horizontalHeader();
     l_headerView->setStretchLastSection(true);
     l_headerView->setSectionsMovable(true);
-    QStringList l_headers;
-    l_headers << tr("Title") << tr("Original Title") << tr("Release Date") << tr("Path of the file");
-    m_ui->tableWidget->setHorizontalHeaderLabels(l_headers);
+
+    QHeaderView* l_rowHeaderView = m_ui->tableView->verticalHeader();
+    l_rowHeaderView->setSectionResizeMode(QHeaderView::Fixed);
+    l_rowHeaderView->setDefaultSectionSize(m_ui->tableView->fontMetrics().height() + 6);
+
+    m_ui->tableView->sortByColumn(MoviesTableModel::TitleColumn, Qt::AscendingOrder);
 }
 
 /**
- * @brief Add a new row with a given Movie to the tableWidget
- * @author Olivier CHURLAUD <olivier@churlaud.com>
+ * @brief Returns the view shown: the tableView or the posterView
+ *
+ * @return QAbstractItemView*
+ */
+QAbstractItemView *MoviesPannel::currentView() const
+{
+    if (m_ui->viewStack->currentWidget() == m_ui->posterView) {
+
+        return m_ui->posterView;
+    }
+
+    return m_ui->tableView;
+}
+
+/**
+ * @brief Gives the first and the last rows of the model shown in the current view.
+ * firstRow is -1 if no row is shown.
+ *
+ * @param int firstRow
+ * @param int lastRow
+ */
+void MoviesPannel::visibleRows(int &firstRow, int &lastRow) const
+{
+    int l_rowCount = m_moviesModel->rowCount();
+    if (this->currentView() == m_ui->posterView) {
+        // The cells have the same size and fill the lines from the left
+        QListView *l_view = m_ui->posterView;
+        QModelIndex l_firstIndex = l_view->indexAt(QPoint(1, 1));
+        QModelIndex l_lastLineIndex = l_view->indexAt(QPoint(1, l_view->viewport()->height() - 1));
+        firstRow = l_firstIndex.isValid() ? l_firstIndex.row() : -1;
+        if (firstRow >= 0 && l_lastLineIndex.isValid()) {
+            int l_cellWidth = qMax(1, l_view->visualRect(l_firstIndex).width());
+            int l_cellsPerLine = qMax(1, l_view->viewport()->width() / l_cellWidth);
+            lastRow = qMin(l_rowCount - 1, l_lastLineIndex.row() + l_cellsPerLine - 1);
+        } else {
+            lastRow = l_rowCount - 1;
+        }
+    } else {
+        QTableView *l_table = m_ui->tableView;
+        firstRow = l_table->rowAt(0);
+        lastRow = l_table->rowAt(l_table->viewport()->height() - 1);
+        if (lastRow < 0) {
+            lastRow = l_rowCount - 1;
+        }
+    }
+}
+
+/**
+ * @brief Ids of the selected movies
  *
- * @param movie
+ * @return QList<int>
  */
-void MoviesPannel::addMovieToPannel(const Movie &movie)
+QList<int> MoviesPannel::selectedMovieIds()
 {
-    int l_column = 0;
-    int l_row = m_ui->tableWidget->rowCount();
-    QStringList l_movieData;
-    m_ui->tableWidget->insertRow(l_row);
-
-    l_movieData << movie.title()
-                << movie.originalTitle()
-                << movie.releaseDate().toString("dd MMM yyyy")
-                << movie.fileAbsolutePath();
-    QVector<QTableWidgetItem*> l_itemList(4);
-
-    foreach(QTableWidgetItem *l_item, l_itemList) {
-        l_item = new QTableWidgetItem(l_movieData.at(l_column));
-        l_item->setData(Macaw::ObjectId, movie.id());
-        l_item->setData(Macaw::ObjectType, Macaw::isMovie);
-        m_ui->tableWidget->setItem(l_row, l_column, l_item);
-        l_column++;
+    QList<int> l_idList;
+    foreach (QModelIndex l_index, m_ui->tableView->selectionModel()->selectedRows()) {
+        l_idList.append(l_index.data(Macaw::ObjectId).toInt());
     }
+
+    return l_idList;
 }
 
 /**
  * @brief Fill the Main Pannel.
  *
- * 1. Clear the pannel
- * 2. Fill each cell of the pannel
+ * Only the rows that changed since the last fill are updated,
+ * so the selection and the scroll position are kept.
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  * @param list of movies to show
@@ -121,23 +199,17 @@ void MoviesPannel::fill(const QList<Movie> &movieList)
 {
     Macaw::DEBUG_IN("[MoviesPannel] Enters fill()");
 
-    m_ui->tableWidget->clearContents();
-    m_ui->tableWidget->setRowCount(0);
-
     ServicesManager *servicesManager = ServicesManager::instance();
-    DatabaseManager *databaseManager = servicesManager->databaseManager();
 
-    QList<Movie> l_matchingMovieList = servicesManager->matchingMovieList();
+    QList<Movie> l_shownMovieList;
     foreach (Movie l_movie, movieList) {
-        if(l_matchingMovieList.contains(l_movie)) {
-            if( (servicesManager->toWatchState()
-                 && databaseManager->isMovieInPlaylist(l_movie.id(), Playlist::ToWatch)
-                 ) || !servicesManager->toWatchState()
-               ) {
-                this->addMovieToPannel(l_movie);
-            }
+        if(servicesManager->isMovieShown(l_movie.id())) {
+            l_shownMovieList.append(l_movie);
         }
     }
+    m_moviesModel->setMovies(l_shownMovieList);
+    this->on_visibleRowsChanged();
+    this->requestVisiblePosters();
 
     Macaw::DEBUG_OUT("[MoviesPannel] Exits fill()");
 }
@@ -160,7 +232,7 @@ void MoviesPannel::on_customContextMenuRequested(const QPoint &point)
 
     ServicesManager *servicesManager = ServicesManager::instance();
     QMenu *l_menu = new QMenu(this);
-    if (!m_ui->tableWidget->selectedItems().isEmpty())
+    if (m_ui->tableView->selectionModel()->hasSelection())
     {
         if(servicesManager->toWatchState()) {
             Macaw::DEBUG("[MainWindow] In ToWatch detected");
@@ -180,8 +252,10 @@ void MoviesPannel::on_customContextMenuRequested(const QPoint &point)
         l_menu->addAction(m_ui->actionEdit_mainPannelMetadata);
         l_menu->addAction(m_ui->actionDelete);
         l_menu->addAction(m_ui->actionGet_Metadata);
-        l_menu->exec(m_ui->tableWidget->mapToGlobal(point));
+        l_menu->addSeparator();
     }
+    l_menu->addAction(m_ui->actionPoster_View);
+    l_menu->exec(this->currentView()->viewport()->mapToGlobal(point));
 }
 
 /**
@@ -193,8 +267,8 @@ void MoviesPannel::on_customContextMenuRequested(const QPoint &point)
 void MoviesPannel::on_actionEdit_mainPannelMetadata_triggered()
 {
     Macaw::DEBUG("[MoviesPannel] actionEdit_mainPannelMetadata_triggered()");
-    if(!m_ui->tableWidget->selectedItems().isEmpty()) {
-        int l_id = m_ui->tableWidget->selectedItems().at(0)->data(Macaw::ObjectId).toInt();
+    if(!this->selectedMovieIds().isEmpty()) {
+        int l_id = this->selectedMovieIds().first();
 
         MovieDialog *l_movieDialog = new MovieDialog(l_id);
 
@@ -216,9 +290,8 @@ void MoviesPannel::on_actionDelete_triggered()
     DatabaseManager *databaseManager = servicesManager->databaseManager();
 
     QList<Movie> l_movieList;
-    foreach (QTableWidgetItem *l_item, m_ui->tableWidget->selectedItems())
+    foreach (int l_movieId, this->selectedMovieIds())
     {
-        int l_movieId = l_item->data(Macaw::ObjectId).toInt();
         l_movieList.append(databaseManager->getOneMovieById(l_movieId));
     }
 
@@ -263,15 +336,15 @@ void MoviesPannel::removeMovieFromPlaylist(const QList<Movie> &movieList, Playli
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  *
- * @param item which was double clicked
+ * @param index which was double clicked
  */
-void MoviesPannel::on_tableWidget_itemDoubleClicked(QTableWidgetItem *item)
+void MoviesPannel::on_tableView_doubleClicked(const QModelIndex &index)
 {
     Macaw::DEBUG("[MoviesPannel] itemDoubleClicked on mainPannel");
 
     DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
-    int l_movieId = item->data(Macaw::ObjectId).toInt();
+    int l_movieId = index.data(Macaw::ObjectId).toInt();
     Movie l_movie = databaseManager->getOneMovieById(l_movieId);
 
     Macaw::DEBUG("[MoviesPannel.startMovie()] Opened movie: " + l_movie.fileAbsolutePath());
@@ -301,25 +374,126 @@ void MoviesPannel::on_tableWidget_itemDoubleClicked(QTableWidgetItem *item)
 }
 
 /**
- * @brief Slot triggered when a movie of the tableWidget is selected
+ * @brief Slot triggered when a poster of the posterView is double clicked.
+ * Start the movie in the default player
+ *
+ * @param index which was double clicked
+ */
+void MoviesPannel::on_posterView_doubleClicked(const QModelIndex &index)
+{
+    this->on_tableView_doubleClicked(index);
+}
+
+/**
+ * @brief Slot triggered when a movie of the tableView is selected
  * Call `fillMetadataPannel` to fill the pannel with the selected Movie data
  *
  * @author Olivier CHURLAUD <olivier@churlaud.com>
  */
-void MoviesPannel::on_tableWidget_itemSelectionChanged()
+void MoviesPannel::on_selectionChanged()
 {
     Macaw::DEBUG("[MoviesPannel] mainPannel selected");
     DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
     Movie l_movie;
-    if (!m_ui->tableWidget->selectedItems().isEmpty()) {
-        QTableWidgetItem *l_item = m_ui->tableWidget->selectedItems().first();
-
-        int l_idMovie = l_item->data(Macaw::ObjectId).toInt();
-        l_movie = databaseManager->getOneMovieById(l_idMovie);
+    QList<int> l_idList = this->selectedMovieIds();
+    if (!l_idList.isEmpty()) {
+        l_movie = databaseManager->getOneMovieById(l_idList.first());
     }
 
     emit fillMetadataPannel(l_movie);
+    emit prioritizeFetchingMetadata(l_idList, Macaw::FetchSelected);
+}
+
+/**
+ * @brief Slot triggered when the rows shown in the tableView may have changed.
+ * The visible movies are sent once the scrolling stopped.
+ */
+void MoviesPannel::on_visibleRowsChanged()
+{
+    m_visibleRowsTimer->start();
+}
+
+/**
+ * @brief Asks for the metadata of the visible movies to be fetched first
+ */
+void MoviesPannel::prioritizeVisibleMovies()
+{
+    QList<int> l_idList;
+
+    int l_firstRow, l_lastRow;
+    this->visibleRows(l_firstRow, l_lastRow);
+    if (l_firstRow >= 0) {
+        for (int l_row = l_firstRow ; l_row <= l_lastRow ; l_row++) {
+            l_idList.append(m_moviesModel->movieId(l_row));
+        }
+    }
+
+    emit prioritizeFetchingMetadata(l_idList, Macaw::FetchVisible);
+}
+
+/**
+ * @brief Asks for the posters of the visible cells of the posterView,
+ * then for those of the next and the previous screens.
+ * The requests for the posters scrolled away are cancelled.
+ */
+void MoviesPannel::requestVisiblePosters()
+{
+    if (this->currentView() != m_ui->posterView) {
+
+        return;
+    }
+
+    int l_firstRow, l_lastRow;
+    this->visibleRows(l_firstRow, l_lastRow);
+    m_posterCache->cancelRequests();
+    if (l_firstRow < 0) {
+
+        return;
+    }
+
+    int l_rowCount = m_moviesModel->rowCount();
+    int l_visibleCount = l_lastRow - l_firstRow + 1;
+    QList<int> l_rowList;
+    for (int l_row = l_firstRow ; l_row <= l_lastRow ; l_row++) {
+        l_rowList.append(l_row);
+    }
+    for (int l_row = l_lastRow + 1 ; l_row < qMin(l_rowCount, l_lastRow + 1 + l_visibleCount) ; l_row++) {
+        l_rowList.append(l_row);
+    }
+    for (int l_row = l_firstRow - 1 ; l_row >= qMax(0, l_firstRow - l_visibleCount) ; l_row--) {
+        l_rowList.append(l_row);
+    }
+
+    foreach (int l_row, l_rowList) {
+        m_posterCache->requestPoster(m_moviesModel->index(l_row, 0).data(Macaw::PosterPath).toString());
+    }
+}
+
+/**
+ * @brief Slot triggered when a poster is loaded.
+ * The repaints are merged by Qt, and only the visible cells are painted.
+ */
+void MoviesPannel::repaintPosters()
+{
+    m_ui->posterView->viewport()->update();
+}
+
+/**
+ * @brief Slot triggered when the poster view is switched on or off.
+ * The choice is kept in the settings.
+ *
+ * @param checked: true to show the posters
+ */
+void MoviesPannel::on_actionPoster_View_toggled(bool checked)
+{
+    m_ui->viewStack->setCurrentWidget(checked ? (QWidget *) m_ui->posterView
+                                              : (QWidget *) m_ui->tableView);
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    l_settings.setValue("moviesPannel/posterView", checked);
+
+    this->on_visibleRowsChanged();
+    this->requestVisiblePosters();
 }
 
 /**
@@ -335,8 +509,8 @@ void MoviesPannel::addPlaylistMenu_triggered(QAction* action)
     DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
 
     int l_actionId = action->data().toInt();
-    if (!m_ui->tableWidget->selectedItems().isEmpty() && l_actionId != 0) {
-        int l_movieId = m_ui->tableWidget->selectedItems().at(0)->data(Macaw::ObjectId).toInt();
+    if (!this->selectedMovieIds().isEmpty() && l_actionId != 0) {
+        int l_movieId = this->selectedMovieIds().first();
         Movie l_movie = databaseManager->getOneMovieById(l_movieId);
         Playlist l_playlist = databaseManager->getOnePlaylistById(l_actionId);
         l_playlist.addMovie(l_movie);
@@ -354,10 +528,8 @@ void MoviesPannel::on_actionGet_Metadata_triggered()
     Macaw::DEBUG("[MoviesPannel] actionGet_Metadata triggered");
     QList<Movie> l_movieList;
     DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
-    foreach (QTableWidgetItem *l_item, m_ui->tableWidget->selectedItems()) {
-        if (l_item->column() == 0) {
-            l_movieList.append(databaseManager->getOneMovieById(l_item->data(Macaw::ObjectId).toInt()));
-        }
+    foreach (int l_movieId, this->selectedMovieIds()) {
+        l_movieList.append(databaseManager->getOneMovieById(l_movieId));
     }
     if (!l_movieList.isEmpty()) {
         emit startFetchingMetadata(l_movieList);
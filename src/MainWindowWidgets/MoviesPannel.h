@@ -22,11 +22,15 @@
 
 #include "MainWindowWidgets/MainPannel.h"
 
+class QAbstractItemView;
 class QFile;
-class QTableWidgetItem;
+class QModelIndex;
+class QTimer;
 
 class Movie;
+class MoviesTableModel;
 class Playlist;
+class PosterCache;
 
 namespace Ui {
 class MoviesPannel;
@@ -39,6 +43,8 @@ class MoviesPannel;
  */
 class MoviesPannel : public MainPannel
 {
+    #define POSTER_WIDTH 120
+    #define POSTER_HEIGHT 180
     Q_OBJECT
 
 public:
@@ -50,15 +56,34 @@ private slots:
     void on_customContextMenuRequested(const QPoint &point);
     void on_actionEdit_mainPannelMetadata_triggered();
     void on_actionDelete_triggered();
-    void on_tableWidget_itemDoubleClicked(QTableWidgetItem *item);
-    void on_tableWidget_itemSelectionChanged();
+    void on_tableView_doubleClicked(const QModelIndex &index);
+    void on_posterView_doubleClicked(const QModelIndex &index);
+    void on_actionPoster_View_toggled(bool checked);
+    void on_selectionChanged();
     void addPlaylistMenu_triggered(QAction* action);
     void on_actionGet_Metadata_triggered();
+    void on_visibleRowsChanged();
+    void prioritizeVisibleMovies();
+    void requestVisiblePosters();
+    void repaintPosters();
 
 private:
     Ui::MoviesPannel *m_ui;
+    MoviesTableModel *m_moviesModel;
+
+    /**
+     * @brief Waits for the scrolling to stop before sending the visible movies
+     */
+    QTimer *m_visibleRowsTimer;
+
+    /**
+     * @brief Thumbnails of the posterView
+     */
+    PosterCache *m_posterCache;
     void setHeaders();
-    void addMovieToPannel(const Movie &movie);
+    QAbstractItemView *currentView() const;
+    void visibleRows(int &firstRow, int &lastRow) const;
+    QList<int> selectedMovieIds();
     void removeMovieFromPlaylist(const QList<Movie> &movieList, Playlist &playlist);
 };
 
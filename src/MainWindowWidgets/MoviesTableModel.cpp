@@ -0,0 +1,377 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MoviesTableModel.h"
+
+#include <QCollator>
+#include <QHash>
+#include <QSet>
+#include <QtAlgorithms>
+
+#include "enumerations.h"
+
+#include "SortKey.h"
+#include "Entities/Movie.h"
+
+/**
+ * @brief Orders the rows on a column
+ */
+class MovieRowLessThan
+{
+public:
+    MovieRowLessThan(const int column, const Qt::SortOrder order) :
+        m_column(column),
+        m_order(order)
+    {}
+
+    bool operator()(const MoviesTableModel::MovieRow &left, const MoviesTableModel::MovieRow &right) const
+    {
+        return m_order == Qt::AscendingOrder ? lessThan(left, right) : lessThan(right, left);
+    }
+
+private:
+    int m_column;
+    Qt::SortOrder m_order;
+    QCollator m_collator;
+
+    bool lessThan(const MoviesTableModel::MovieRow &left, const MoviesTableModel::MovieRow &right) const
+    {
+        switch (m_column) {
+        case MoviesTableModel::OriginalTitleColumn:
+            return QString::localeAwareCompare(left.originalTitle, right.originalTitle) < 0;
+        case MoviesTableModel::ReleaseDateColumn:
+            return left.releaseDate < right.releaseDate;
+        case MoviesTableModel::FilePathColumn:
+            return QString::localeAwareCompare(left.filePath, right.filePath) < 0;
+        default:
+            return m_collator.compare(left.titleSort, right.titleSort) < 0;
+        }
+    }
+};
+
+/**
+ * @brief Orders the rows on precomputed collation keys
+ */
+class SortKeyLessThan
+{
+public:
+    SortKeyLessThan(const QList<QCollatorSortKey> *keyList, const Qt::SortOrder order) :
+        m_keyList(keyList),
+        m_order(order)
+    {}
+
+    bool operator()(const int left, const int right) const
+    {
+        return m_order == Qt::AscendingOrder
+                ? m_keyList->at(left).compare(m_keyList->at(right)) < 0
+                : m_keyList->at(right).compare(m_keyList->at(left)) < 0;
+    }
+
+private:
+    const QList<QCollatorSortKey> *m_keyList;
+    Qt::SortOrder m_order;
+};
+
+MoviesTableModel::MoviesTableModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+    m_sortColumn = -1;
+    m_sortOrder = Qt::AscendingOrder;
+}
+
+int MoviesTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int MoviesTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant MoviesTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+
+        return QVariant();
+    }
+
+    const MovieRow &l_row = m_rows.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TitleColumn:
+            return l_row.title;
+        case OriginalTitleColumn:
+            return l_row.originalTitle;
+        case ReleaseDateColumn:
+            return l_row.releaseDate.toString("dd MMM yyyy");
+        case FilePathColumn:
+            return l_row.filePath;
+        }
+    } else if (role == Macaw::ObjectId) {
+        return l_row.id;
+    } else if (role == Macaw::ObjectType) {
+        return Macaw::isMovie;
+    } else if (role == Macaw::PosterPath) {
+        return l_row.posterPath;
+    }
+
+    return QVariant();
+}
+
+QVariant MoviesTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+
+        return QVariant();
+    }
+
+    switch (section) {
+    case TitleColumn:
+        return tr("Title");
+    case OriginalTitleColumn:
+        return tr("Original Title");
+    case ReleaseDateColumn:
+        return tr("Release Date");
+    case FilePathColumn:
+        return tr("Path of the file");
+    }
+
+    return QVariant();
+}
+
+/**
+ * @brief Sorts the rows, asked by the view when a header is clicked.
+ * The selection follows its movies.
+ *
+ * @param column
+ * @param order
+ */
+void MoviesTableModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrder = order;
+    if (this->isSorted()) {
+
+        return;
+    }
+
+    emit layoutAboutToBeChanged();
+    QModelIndexList l_oldIndexList = this->persistentIndexList();
+    QList<int> l_oldIdList;
+    foreach (QModelIndex l_index, l_oldIndexList) {
+        l_oldIdList.append(movieId(l_index.row()));
+    }
+
+    this->sortRows();
+
+    QHash<int, int> l_rowById;
+    for (int i = 0 ; i < m_rows.size() ; i++) {
+        l_rowById.insert(m_rows.at(i).id, i);
+    }
+    QModelIndexList l_newIndexList;
+    for (int i = 0 ; i < l_oldIndexList.size() ; i++) {
+        l_newIndexList.append(this->index(l_rowById.value(l_oldIdList.at(i)),
+                                          l_oldIndexList.at(i).column()));
+    }
+    this->changePersistentIndexList(l_oldIndexList, l_newIndexList);
+    emit layoutChanged();
+}
+
+/**
+ * @brief Replaces the movies shown.
+ * The new list is compared to the shown rows, by movie id: only the rows
+ * of removed, changed or new movies are signaled to the view, so that it
+ * keeps its selection and its scroll position, and repaints what changed.
+ *
+ * @param movieList
+ */
+void MoviesTableModel::setMovies(const QList<Movie> &movieList)
+{
+    QList<int> l_newIdList;
+    QHash<int, MovieRow> l_newRowHash;
+    foreach (Movie l_movie, movieList) {
+        if (!l_newRowHash.contains(l_movie.id())) {
+            l_newIdList.append(l_movie.id());
+            l_newRowHash.insert(l_movie.id(), this->rowFromMovie(l_movie));
+        }
+    }
+
+    // Nothing to keep: a reset is cheaper than one insertion per row
+    if (m_rows.size() < l_newIdList.size() / 2) {
+        this->beginResetModel();
+        m_rows.clear();
+        m_rows.reserve(l_newIdList.size());
+        foreach (int l_id, l_newIdList) {
+            m_rows.append(l_newRowHash.value(l_id));
+        }
+        this->sortRows();
+        this->endResetModel();
+
+        return;
+    }
+
+    // Removed movies, by ranges of contiguous rows, from the bottom
+    int l_row = m_rows.size() - 1;
+    while (l_row >= 0) {
+        if (l_newRowHash.contains(m_rows.at(l_row).id)) {
+            l_row--;
+        } else {
+            int l_lastRow = l_row;
+            while (l_row >= 0 && !l_newRowHash.contains(m_rows.at(l_row).id)) {
+                l_row--;
+            }
+            this->beginRemoveRows(QModelIndex(), l_row + 1, l_lastRow);
+            m_rows.remove(l_row + 1, l_lastRow - l_row);
+            this->endRemoveRows();
+        }
+    }
+
+    // Changed movies
+    QSet<int> l_shownIdSet;
+    bool l_changed = false;
+    for (int i = 0 ; i < m_rows.size() ; i++) {
+        const MovieRow &l_newRow = l_newRowHash[m_rows.at(i).id];
+        l_shownIdSet.insert(l_newRow.id);
+        if (!(m_rows.at(i) == l_newRow)) {
+            m_rows[i] = l_newRow;
+            l_changed = true;
+            emit dataChanged(this->index(i, 0), this->index(i, ColumnCount - 1));
+        }
+    }
+    if (l_changed) {
+        this->sort(m_sortColumn, m_sortOrder);
+    }
+
+    // New movies, at their place in the sorted rows
+    foreach (int l_id, l_newIdList) {
+        if (!l_shownIdSet.contains(l_id)) {
+            const MovieRow &l_newRow = l_newRowHash[l_id];
+            int l_newRowIndex = this->insertionRow(l_newRow);
+            this->beginInsertRows(QModelIndex(), l_newRowIndex, l_newRowIndex);
+            m_rows.insert(l_newRowIndex, l_newRow);
+            this->endInsertRows();
+        }
+    }
+}
+
+/**
+ * @brief Id of the movie shown at a row
+ *
+ * @param row
+ * @return the id, 0 if the row does not exist
+ */
+int MoviesTableModel::movieId(const int row) const
+{
+    if (row < 0 || row >= m_rows.size()) {
+
+        return 0;
+    }
+
+    return m_rows.at(row).id;
+}
+
+/**
+ * @brief Sorts the rows on m_sortColumn.
+ * The titles are compared through their collation keys, computed once per row.
+ */
+void MoviesTableModel::sortRows()
+{
+    if (m_sortColumn < 0) {
+
+        return;
+    }
+    if (m_sortColumn != TitleColumn) {
+        qStableSort(m_rows.begin(), m_rows.end(), MovieRowLessThan(m_sortColumn, m_sortOrder));
+
+        return;
+    }
+
+    QCollator l_collator;
+    QList<QCollatorSortKey> l_keyList;
+    l_keyList.reserve(m_rows.size());
+    QVector<int> l_order(m_rows.size());
+    for (int i = 0 ; i < m_rows.size() ; i++) {
+        l_keyList.append(l_collator.sortKey(m_rows.at(i).titleSort));
+        l_order[i] = i;
+    }
+    qStableSort(l_order.begin(), l_order.end(), SortKeyLessThan(&l_keyList, m_sortOrder));
+
+    QVector<MovieRow> l_rows;
+    l_rows.reserve(m_rows.size());
+    foreach (int i, l_order) {
+        l_rows.append(m_rows.at(i));
+    }
+    m_rows = l_rows;
+}
+
+/**
+ * @brief Tells if the rows already follow the asked sorting
+ *
+ * @return bool
+ */
+bool MoviesTableModel::isSorted() const
+{
+    if (m_sortColumn < 0) {
+
+        return true;
+    }
+
+    MovieRowLessThan l_lessThan(m_sortColumn, m_sortOrder);
+    for (int i = 1 ; i < m_rows.size() ; i++) {
+        if (l_lessThan(m_rows.at(i), m_rows.at(i-1))) {
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Row where a new movie should be inserted to keep the sorting
+ *
+ * @param row of the new movie
+ * @return int
+ */
+int MoviesTableModel::insertionRow(const MovieRow &row) const
+{
+    if (m_sortColumn < 0) {
+
+        return m_rows.size();
+    }
+
+    return qUpperBound(m_rows.begin(), m_rows.end(), row,
+                       MovieRowLessThan(m_sortColumn, m_sortOrder)) - m_rows.begin();
+}
+
+MoviesTableModel::MovieRow MoviesTableModel::rowFromMovie(const Movie &movie) const
+{
+    MovieRow l_row;
+    l_row.id = movie.id();
+    l_row.title = movie.title();
+    l_row.titleSort = SortKey::title(movie.title());
+    l_row.originalTitle = movie.originalTitle();
+    l_row.releaseDate = movie.releaseDate();
+    l_row.filePath = movie.fileAbsolutePath();
+    l_row.posterPath = movie.posterPath();
+
+    return l_row;
+}
@@ -0,0 +1,96 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MOVIESTABLEMODEL_H
+#define MOVIESTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QDate>
+#include <QVector>
+
+class Movie;
+
+/**
+ * @brief Model of the movies shown by MoviesPannel.
+ *
+ * Only the shown fields of each movie are kept, in a vector of rows,
+ * and the view asks for the visible cells only.
+ */
+class MoviesTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum columns {
+        TitleColumn,
+        OriginalTitleColumn,
+        ReleaseDateColumn,
+        FilePathColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Fields of a movie shown in the table
+     */
+    struct MovieRow {
+        int id;
+        QString title;
+        QString titleSort;
+        QString originalTitle;
+        QDate releaseDate;
+        QString filePath;
+        QString posterPath;
+
+        bool operator==(const MovieRow &other) const
+        {
+            return id == other.id
+                    && title == other.title
+                    && originalTitle == other.originalTitle
+                    && releaseDate == other.releaseDate
+                    && filePath == other.filePath
+                    && posterPath == other.posterPath;
+        }
+    };
+
+    explicit MoviesTableModel(QObject *parent = 0);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
+    void setMovies(const QList<Movie> &movieList);
+    int movieId(const int row) const;
+
+private:
+    QVector<MovieRow> m_rows;
+
+    /**
+     * @brief Sorting asked by the view, kept when the movies change.
+     * -1 keeps the order of the database.
+     */
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+    void sortRows();
+    bool isSorted() const;
+    int insertionRow(const MovieRow &row) const;
+    MovieRow rowFromMovie(const Movie &movie) const;
+};
+
+#endif // MOVIESTABLEMODEL_H
@@ -0,0 +1,103 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PosterCache.h"
+
+#include <QApplication>
+#include <QThreadPool>
+
+#include "MainWindowWidgets/PosterLoadTask.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param posterSize: size in which the thumbnails must fit
+ * @param parent
+ */
+PosterCache::PosterCache(const QSize posterSize, QObject *parent) :
+    QObject(parent),
+    m_posterSize(posterSize)
+{
+    m_posterCache.setMaxCost(POSTER_CACHE_SIZE);
+    m_threadPool = new QThreadPool(this);
+    m_threadPool->setMaxThreadCount(POSTER_LOAD_THREADS);
+}
+
+/**
+ * @brief Returns the thumbnail of a poster if it is loaded, 0 else.
+ * A poster which could not be read gives a null pixmap.
+ *
+ * @param QString path of the poster, as saved in the database
+ * @return QPixmap*, owned by the cache
+ */
+QPixmap *PosterCache::poster(const QString posterPath)
+{
+    return m_posterCache.object(posterPath);
+}
+
+/**
+ * @brief Asks for a poster to be loaded, unless it is loaded or asked already.
+ * The requests are served in order; posterLoaded() is sent for each one.
+ *
+ * @param QString path of the poster, as saved in the database
+ */
+void PosterCache::requestPoster(const QString posterPath)
+{
+    if (posterPath.isEmpty()
+            || m_requestedPathSet.contains(posterPath)
+            || m_posterCache.contains(posterPath)) {
+
+        return;
+    }
+
+    m_requestedPathSet.insert(posterPath);
+    PosterLoadTask *l_task = new PosterLoadTask(posterPath,
+                                                qApp->property("postersPath").toString() + posterPath,
+                                                m_posterSize);
+    connect(l_task, SIGNAL(posterLoaded(QString,QImage)),
+            this, SLOT(on_posterLoaded(QString,QImage)));
+    m_threadPool->start(l_task);
+}
+
+/**
+ * @brief Forgets the requests which have not started yet,
+ * typically because their posters are not visible anymore
+ */
+void PosterCache::cancelRequests()
+{
+    m_threadPool->clear();
+    m_requestedPathSet.clear();
+}
+
+/**
+ * @brief Slot triggered when a poster is decoded.
+ * Its cost is its size in KB.
+ *
+ * @param posterPath: path of the poster, as saved in the database
+ * @param poster: thumbnail, null if it could not be read
+ */
+void PosterCache::on_posterLoaded(const QString posterPath, const QImage &poster)
+{
+    m_requestedPathSet.remove(posterPath);
+    int l_cost = qMax(1, poster.byteCount() / 1024);
+    m_posterCache.insert(posterPath, new QPixmap(QPixmap::fromImage(poster)), l_cost);
+
+    emit posterLoaded(posterPath);
+}
@@ -0,0 +1,70 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef POSTERCACHE_H
+#define POSTERCACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+
+class QThreadPool;
+
+/**
+ * @brief Thumbnails of the posters, shared by the views of the pannels.
+ *
+ * The posters are decoded on demand by PosterLoadTask in a small thread pool,
+ * and the thumbnails are kept in a cache bounded to POSTER_CACHE_SIZE KB,
+ * the least recently used being dropped first.
+ */
+class PosterCache : public QObject
+{
+    #define POSTER_CACHE_SIZE 65536
+    #define POSTER_LOAD_THREADS 2
+    Q_OBJECT
+
+public:
+    explicit PosterCache(const QSize posterSize, QObject *parent = 0);
+    QSize posterSize() const { return m_posterSize; }
+    QPixmap *poster(const QString posterPath);
+    void requestPoster(const QString posterPath);
+    void cancelRequests();
+
+signals:
+    void posterLoaded(QString posterPath);
+
+private slots:
+    void on_posterLoaded(const QString posterPath, const QImage &poster);
+
+private:
+    QSize m_posterSize;
+    QCache<QString, QPixmap> m_posterCache;
+
+    /**
+     * @brief Posters asked to m_threadPool and not loaded yet
+     */
+    QSet<QString> m_requestedPathSet;
+    QThreadPool *m_threadPool;
+};
+
+#endif // POSTERCACHE_H
@@ -0,0 +1,92 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PosterDelegate.h"
+
+#include <QPainter>
+
+#include "enumerations.h"
+
+#include "MainWindowWidgets/PosterCache.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param posterCache: cache of the thumbnails
+ * @param parent
+ */
+PosterDelegate::PosterDelegate(PosterCache *posterCache, QObject *parent) :
+    QStyledItemDelegate(parent),
+    m_posterCache(posterCache)
+{
+}
+
+/**
+ * @brief Paints the poster, or a placeholder, with the title below
+ */
+void PosterDelegate::paint(QPainter *painter,
+                           const QStyleOptionViewItem &option,
+                           const QModelIndex &index) const
+{
+    painter->save();
+
+    bool l_selected = option.state & QStyle::State_Selected;
+    if (l_selected) {
+        painter->fillRect(option.rect, option.palette.highlight());
+    }
+
+    QRect l_posterRect(option.rect.topLeft() + QPoint(POSTER_MARGIN, POSTER_MARGIN),
+                       m_posterCache->posterSize());
+    QString l_posterPath = index.data(Macaw::PosterPath).toString();
+    QPixmap *l_poster = m_posterCache->poster(l_posterPath);
+    if (l_poster != 0 && !l_poster->isNull()) {
+        QRect l_pixmapRect(QPoint(0, 0), l_poster->size());
+        l_pixmapRect.moveCenter(l_posterRect.center());
+        painter->drawPixmap(l_pixmapRect.topLeft(), *l_poster);
+    } else {
+        painter->fillRect(l_posterRect, option.palette.mid());
+        if (l_poster == 0) {
+            m_posterCache->requestPoster(l_posterPath);
+        }
+    }
+
+    QRect l_titleRect(l_posterRect.left(), l_posterRect.bottom() + POSTER_MARGIN,
+                      l_posterRect.width(), option.fontMetrics.height());
+    QString l_title = option.fontMetrics.elidedText(index.data(Qt::DisplayRole).toString(),
+                                                    Qt::ElideRight,
+                                                    l_titleRect.width());
+    painter->setPen(option.palette.color(l_selected ? QPalette::HighlightedText
+                                                    : QPalette::Text));
+    painter->drawText(l_titleRect, Qt::AlignCenter, l_title);
+
+    painter->restore();
+}
+
+/**
+ * @brief All the cells have the same size, so that the view
+ * does not need to measure them
+ */
+QSize PosterDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
+{
+    QSize l_posterSize = m_posterCache->posterSize();
+
+    return QSize(l_posterSize.width() + 2 * POSTER_MARGIN,
+                 l_posterSize.height() + 3 * POSTER_MARGIN + option.fontMetrics.height());
+}
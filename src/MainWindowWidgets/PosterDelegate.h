@@ -0,0 +1,49 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef POSTERDELEGATE_H
+#define POSTERDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class PosterCache;
+
+/**
+ * @brief Paints a movie as its poster and its title, in the poster grid
+ * of MoviesPannel.
+ *
+ * The posters come from PosterCache; a missing one is asked for
+ * and a placeholder is painted until it is loaded.
+ */
+class PosterDelegate : public QStyledItemDelegate
+{
+    #define POSTER_MARGIN 4
+    Q_OBJECT
+
+public:
+    explicit PosterDelegate(PosterCache *posterCache, QObject *parent = 0);
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+
+private:
+    PosterCache *m_posterCache;
+};
+
+#endif // POSTERDELEGATE_H
@@ -0,0 +1,66 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PosterLoadTask.h"
+
+#include <QImageReader>
+
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param posterPath: path of the poster, as saved in the database
+ * @param fileName: absolute path of the poster file
+ * @param posterSize: size in which the poster must fit
+ */
+PosterLoadTask::PosterLoadTask(const QString posterPath,
+                               const QString fileName,
+                               const QSize posterSize) :
+    m_posterPath(posterPath),
+    m_fileName(fileName),
+    m_posterSize(posterSize)
+{
+}
+
+/**
+ * @brief Reads the poster. The decoder scales it down by itself when it can,
+ * which is much faster than reading it in full size.
+ */
+void PosterLoadTask::run()
+{
+    QImageReader l_reader(m_fileName);
+    QSize l_size = l_reader.size();
+    if (l_size.isValid()) {
+        l_size.scale(m_posterSize, Qt::KeepAspectRatio);
+        l_reader.setScaledSize(l_size);
+    }
+
+    QImage l_poster = l_reader.read();
+    if (l_poster.isNull()) {
+        Macaw::DEBUG("[PosterLoadTask] Cannot read " + m_fileName
+                     + ": " + l_reader.errorString());
+    } else if (l_poster.width() > m_posterSize.width()
+               || l_poster.height() > m_posterSize.height()) {
+        l_poster = l_poster.scaled(m_posterSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    emit posterLoaded(m_posterPath, l_poster);
+}
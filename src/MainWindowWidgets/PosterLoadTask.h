@@ -0,0 +1,53 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef POSTERLOADTASK_H
+#define POSTERLOADTASK_H
+
+#include <QImage>
+#include <QObject>
+#include <QRunnable>
+#include <QSize>
+
+/**
+ * @brief Decodes a poster at the size of a thumbnail,
+ * in a thread of the QThreadPool of PosterCache.
+ * A poster which cannot be read is sent as a null image.
+ */
+class PosterLoadTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit PosterLoadTask(const QString posterPath,
+                            const QString fileName,
+                            const QSize posterSize);
+    void run();
+
+signals:
+    void posterLoaded(QString posterPath, QImage poster);
+
+private:
+    QString m_posterPath;
+    QString m_fileName;
+    QSize m_posterSize;
+};
+
+#endif // POSTERLOADTASK_H
@@ -47,19 +47,17 @@ void ShowsPannel::fill(const QList<Movie> &movieList)
     DatabaseManager *databaseManager = servicesManager->databaseManager();
 
     QList<Episode> l_episodeList = databaseManager->getEpisodesByMovies(movieList);
-    QList<Movie> l_matchingMovieList = servicesManager->matchingMovieList();
 
+    // The tree is built aside and added at once
     foreach (Episode l_episode, l_episodeList) {
-        if(l_matchingMovieList.contains(l_episode.movie())) {
-            if( (servicesManager->toWatchState()
-                 && databaseManager->isMovieInPlaylist(l_episode.movie().id(),
-                                                       Playlist::ToWatch)
-                 ) || !servicesManager->toWatchState()
-               ) {
-                this->addEpisodeToPannel(l_episode);
-            }
+        if(servicesManager->isMovieShown(l_episode.movie().id())) {
+            this->addEpisodeToPannel(l_episode);
         }
     }
+    m_ui->treeWidget->addTopLevelItems(m_showItemList);
+    m_showItemList.clear();
+    m_showItemHash.clear();
+    m_seasonItemHash.clear();
     Macaw::DEBUG_OUT("[ShowsPannel] Exits fill()");
 }
 
@@ -68,33 +66,23 @@ void ShowsPannel::addEpisodeToPannel(const Episode &episode)
     QStringList l_textValues (QString::number(episode.number()) + "- " + episode.movie().title());
     QTreeWidgetItem *l_episodeItem = new QTreeWidgetItem(l_textValues);
 
-    QList<QTreeWidgetItem*> l_showItemList = m_ui->treeWidget->findItems(episode.show().name(),
-                                                                           Qt::MatchFixedString);
-    if (!l_showItemList.isEmpty()) {
-        QTreeWidgetItem* l_showItem = l_showItemList.at(0);
-        bool l_seasonExists(false);
-        for (int i = 0 ; i < l_showItem->childCount() ; i++) {
-            if (l_showItem->child(i)->text(0) == QString::number(episode.season())) {
-                l_showItem->child(i)->addChild(l_episodeItem);
-                l_seasonExists = true;
-                break;
-            }
-        }
-        if (!l_seasonExists) {
-            QTreeWidgetItem *l_seasonItem = new QTreeWidgetItem();
-            l_seasonItem->setText(0, QString::number(episode.season()));
-            l_seasonItem->addChild(l_episodeItem);
-            l_showItem->addChild(l_seasonItem);
-        }
-    } else {
-        QTreeWidgetItem *l_showItem = new QTreeWidgetItem();
+    int l_showId = episode.show().id();
+    QTreeWidgetItem *l_showItem = m_showItemHash.value(l_showId);
+    if (l_showItem == NULL) {
+        l_showItem = new QTreeWidgetItem();
         l_showItem->setText(0, episode.show().name());
-        QTreeWidgetItem *l_seasonItem = new QTreeWidgetItem();
-        l_seasonItem->setText(0, QString::number(episode.season()));
+        m_showItemHash.insert(l_showId, l_showItem);
+        m_showItemList.append(l_showItem);
+    }
 
-        m_ui->treeWidget->addTopLevelItem(l_showItem);
+    QPair<int, int> l_seasonKey(l_showId, episode.season());
+    QTreeWidgetItem *l_seasonItem = m_seasonItemHash.value(l_seasonKey);
+    if (l_seasonItem == NULL) {
+        l_seasonItem = new QTreeWidgetItem();
+        l_seasonItem->setText(0, QString::number(episode.season()));
+        m_seasonItemHash.insert(l_seasonKey, l_seasonItem);
         l_showItem->addChild(l_seasonItem);
-        l_seasonItem->addChild(l_episodeItem);
-
     }
+
+    l_seasonItem->addChild(l_episodeItem);
 }
@@ -22,6 +22,11 @@
 
 #include "MainPannel.h"
 
+#include <QHash>
+#include <QPair>
+
+class QTreeWidgetItem;
+
 class Episode;
 
 namespace Ui {
@@ -44,6 +49,13 @@ public:
 
 private:
     Ui::ShowsPannel *m_ui;
+
+    /**
+     * @brief Nodes of the tree being built, by show id and by (show id, season)
+     */
+    QHash<int, QTreeWidgetItem*> m_showItemHash;
+    QHash<QPair<int, int>, QTreeWidgetItem*> m_seasonItemHash;
+    QList<QTreeWidgetItem*> m_showItemList;
     void addEpisodeToPannel(const Episode &episode);
 };
 
@@ -0,0 +1,254 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MountPointResolver.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MacawDebug.h"
+
+Q_GLOBAL_STATIC(MountPointResolver, mountPointResolver)
+
+static bool mountPointLongerThan(const QString &left, const QString &right)
+{
+    return left.size() > right.size();
+}
+
+/**
+ * @brief Decodes the octal escapes (\040 for a space...) of the mount table
+ *
+ * @param QString field of the mount table
+ * @return QString
+ */
+static QString unescapeMountField(const QString &field)
+{
+    QString l_unescaped;
+    for (int i = 0 ; i < field.size() ; i++) {
+        if (field.at(i) == '\\' && i + 3 < field.size()) {
+            bool l_ok;
+            int l_code = field.mid(i + 1, 3).toInt(&l_ok, 8);
+            if (l_ok) {
+                l_unescaped.append(QChar(l_code));
+                i += 3;
+                continue;
+            }
+        }
+        l_unescaped.append(field.at(i));
+    }
+
+    return l_unescaped;
+}
+
+/**
+ * @brief Constructor.
+ * The kernel flags /proc/self/mountinfo as exceptional when the mount table
+ * changes, which is watched with a QSocketNotifier.
+ */
+MountPointResolver::MountPointResolver(QObject *parent) : QObject(parent)
+{
+    m_mountInfoNotifier = 0;
+    m_mountTableRead = false;
+    m_mountInfoFile.setFileName("/proc/self/mountinfo");
+    if (m_mountInfoFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_mountInfoNotifier = new QSocketNotifier(m_mountInfoFile.handle(),
+                                                  QSocketNotifier::Exception,
+                                                  this);
+        connect(m_mountInfoNotifier, SIGNAL(activated(int)),
+                this, SLOT(on_mountTableChanged()));
+    } else {
+        Macaw::DEBUG("[MountPointResolver] Cannot open the mount table, / is the only mount point");
+    }
+}
+
+MountPointResolver *MountPointResolver::instance()
+{
+    return mountPointResolver;
+}
+
+/**
+ * @brief Returns the mount point containing a path
+ *
+ * @param QString absolute path
+ * @return QString
+ */
+QString MountPointResolver::mountPoint(const QString path)
+{
+    if (!m_mountTableRead) {
+        this->readMountTable();
+    }
+
+    QString l_path = QFileInfo(path).canonicalFilePath();
+    if (l_path.isEmpty()) {
+        l_path = QDir::cleanPath(path);
+    }
+
+    foreach (QString l_mountPoint, m_mountPointList) {
+        if (l_mountPoint == "/"
+                || l_path == l_mountPoint
+                || l_path.startsWith(l_mountPoint + '/')) {
+
+            return l_mountPoint;
+        }
+    }
+
+    return "/";
+}
+
+/**
+ * @brief Returns the trash folder of a file, as in the XDG trash specification:
+ *  - the home trash if the file is on the same mount point,
+ *  - else $topdir/.Trash/$uid if $topdir/.Trash is a sticky folder,
+ *  - else $topdir/.Trash-$uid.
+ * The `files` and `info` subfolders are created if needed.
+ *
+ * @param QString absolute path of the file
+ * @return QString the trash folder, or an empty string if there is none usable
+ */
+QString MountPointResolver::trashFolder(const QString path)
+{
+    QString l_homeTrashFolder = this->homeTrashFolder();
+    QString l_topDir = this->mountPoint(path);
+    if (QDir(l_homeTrashFolder).exists() || QDir().mkpath(l_homeTrashFolder)) {
+        if (this->mountPoint(l_homeTrashFolder) == l_topDir) {
+
+            return makeTrashFolder(l_homeTrashFolder) ? l_homeTrashFolder : QString();
+        }
+    }
+
+    return this->topDirTrashFolder(l_topDir);
+}
+
+/**
+ * @brief Slot triggered when the mount table changed.
+ * Reading it again also clears the notification of the kernel.
+ */
+void MountPointResolver::on_mountTableChanged()
+{
+    Macaw::DEBUG("[MountPointResolver] Mount table changed");
+    this->readMountTable();
+}
+
+/**
+ * @brief Reads the mount points of /proc/self/mountinfo.
+ * The fifth field of each line is the mount point.
+ */
+void MountPointResolver::readMountTable()
+{
+    m_mountPointList.clear();
+    m_mountTableRead = true;
+    if (!m_mountInfoFile.isOpen()) {
+
+        return;
+    }
+
+    // The file is generated when read from its start
+    m_mountInfoFile.seek(0);
+    QByteArray l_mountTable = m_mountInfoFile.readAll();
+    foreach (QByteArray l_line, l_mountTable.split('\n')) {
+        QList<QByteArray> l_fieldList = l_line.split(' ');
+        if (l_fieldList.size() > 4) {
+            m_mountPointList.append(unescapeMountField(QString::fromLocal8Bit(l_fieldList.at(4))));
+        }
+    }
+    qSort(m_mountPointList.begin(), m_mountPointList.end(), mountPointLongerThan);
+}
+
+/**
+ * @brief Returns $XDG_DATA_HOME/Trash, $XDG_DATA_HOME being ~/.local/share by default
+ *
+ * @return QString
+ */
+QString MountPointResolver::homeTrashFolder() const
+{
+    QString l_dataHome = QString::fromLocal8Bit(qgetenv("XDG_DATA_HOME"));
+    if (l_dataHome.isEmpty()) {
+        l_dataHome = QDir::homePath() + "/.local/share";
+    }
+
+    return l_dataHome + "/Trash";
+}
+
+/**
+ * @brief Returns the trash folder of a mount point other than the home one
+ *
+ * @param QString mount point
+ * @return QString the trash folder, or an empty string if there is none usable
+ */
+QString MountPointResolver::topDirTrashFolder(const QString topDir) const
+{
+#ifdef Q_OS_UNIX
+    QString l_topDir = topDir.endsWith('/') ? topDir : topDir + '/';
+    QString l_uid = QString::number(getuid());
+
+    // An administrator may have created a shared sticky .Trash,
+    // which must not be a symbolic link
+    QString l_sharedTrash = l_topDir + ".Trash";
+    struct stat l_stat;
+    if (lstat(QFile::encodeName(l_sharedTrash).constData(), &l_stat) == 0) {
+        if (S_ISDIR(l_stat.st_mode) && (l_stat.st_mode & S_ISVTX)) {
+            QString l_trashFolder = l_sharedTrash + '/' + l_uid;
+            if (makeTrashFolder(l_trashFolder)) {
+
+                return l_trashFolder;
+            }
+        } else {
+            Macaw::DEBUG("[MountPointResolver] " + l_sharedTrash + " is not a sticky folder, ignored");
+        }
+    }
+
+    QString l_trashFolder = l_topDir + ".Trash-" + l_uid;
+    if (makeTrashFolder(l_trashFolder)) {
+
+        return l_trashFolder;
+    }
+#endif
+    Macaw::DEBUG("[MountPointResolver] No trash folder usable on " + topDir);
+
+    return QString();
+}
+
+/**
+ * @brief Creates a trash folder with its `files` and `info` subfolders.
+ * A new trash folder is readable by the user only.
+ *
+ * @param QString trash folder
+ * @return bool true if it is usable
+ */
+bool MountPointResolver::makeTrashFolder(const QString trashFolder)
+{
+    QDir l_dir;
+    bool l_existed = l_dir.exists(trashFolder);
+    if (!l_dir.mkpath(trashFolder + "/files") || !l_dir.mkpath(trashFolder + "/info")) {
+
+        return false;
+    }
+    if (!l_existed) {
+        QFile::setPermissions(trashFolder, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+    }
+
+    return true;
+}
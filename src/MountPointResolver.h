@@ -0,0 +1,66 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MOUNTPOINTRESOLVER_H
+#define MOUNTPOINTRESOLVER_H
+
+#include <QFile>
+#include <QObject>
+#include <QStringList>
+
+class QSocketNotifier;
+
+/**
+ * @brief Finds the mount point of a path, and the trash folder to use for it
+ * according to the XDG trash specification, without spawning any process.
+ *
+ * The mount table is read from /proc/self/mountinfo once, and read again
+ * only when the kernel tells that it changed.
+ */
+class MountPointResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MountPointResolver(QObject *parent = 0);
+    static MountPointResolver* instance();
+    QString mountPoint(const QString path);
+    QString trashFolder(const QString path);
+
+private slots:
+    void on_mountTableChanged();
+
+private:
+    QFile m_mountInfoFile;
+    QSocketNotifier *m_mountInfoNotifier;
+
+    /**
+     * @brief Mount points, the longest first so that the first one
+     * containing a path is its own
+     */
+    QStringList m_mountPointList;
+    bool m_mountTableRead;
+    void readMountTable();
+    QString homeTrashFolder() const;
+    QString topDirTrashFolder(const QString topDir) const;
+    static bool makeTrashFolder(const QString trashFolder);
+};
+
+#endif // MOUNTPOINTRESOLVER_H
@@ -0,0 +1,113 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MoviesSearchTask.h"
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "DatabaseManager.h"
+#include "MacawDebug.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param databasePath: file of the database
+ * @param text to search
+ * @param show: true to search the shows, false for the movies
+ * @param generation of this search
+ * @param latestGeneration: generation of the latest search asked
+ */
+MoviesSearchTask::MoviesSearchTask(const QString databasePath,
+                                   const QString text,
+                                   const bool show,
+                                   const int generation,
+                                   const QAtomicInt *latestGeneration) :
+    m_databasePath(databasePath),
+    m_text(text),
+    m_show(show),
+    m_generation(generation),
+    m_latestGeneration(latestGeneration)
+{
+}
+
+/**
+ * @brief Runs the search and sends the ids found, by batches of SEARCH_BATCH_SIZE
+ */
+void MoviesSearchTask::run()
+{
+    if (this->isSuperseded()) {
+
+        return;
+    }
+
+    QString l_connectionName = "search_" + QString::number(m_generation);
+    bool l_finished = false;
+    {
+        QSqlDatabase l_db = QSqlDatabase::addDatabase("QSQLITE", l_connectionName);
+        l_db.setDatabaseName(m_databasePath);
+        l_db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=1000");
+
+        if (!l_db.open()) {
+            Macaw::DEBUG("In MoviesSearchTask::run():");
+            Macaw::DEBUG(l_db.lastError().text());
+        } else {
+            QSqlQuery l_query(l_db);
+            l_query.setForwardOnly(true);
+            DatabaseManager::prepareMoviesByAny(l_query, "m.id ", m_text, m_show, "title_sort");
+
+            if (!l_query.exec()) {
+                Macaw::DEBUG("In MoviesSearchTask::run():");
+                Macaw::DEBUG(l_query.lastError().text());
+            }
+
+            QList<int> l_movieIdList;
+            l_finished = true;
+            while (l_query.next()) {
+                l_movieIdList.append(l_query.value(0).toInt());
+                if (l_movieIdList.size() == SEARCH_BATCH_SIZE) {
+                    if (this->isSuperseded()) {
+                        l_finished = false;
+                        break;
+                    }
+                    emit moviesFound(m_generation, l_movieIdList, false);
+                    l_movieIdList.clear();
+                }
+            }
+            if (l_finished) {
+                emit moviesFound(m_generation, l_movieIdList, true);
+            }
+        }
+        l_db.close();
+    }
+    QSqlDatabase::removeDatabase(l_connectionName);
+}
+
+/**
+ * @brief Tells if another search has been asked since this one
+ *
+ * @return bool
+ */
+bool MoviesSearchTask::isSuperseded() const
+{
+    return m_latestGeneration->load() != m_generation;
+}
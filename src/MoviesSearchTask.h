@@ -0,0 +1,63 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MOVIESSEARCHTASK_H
+#define MOVIESSEARCHTASK_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QObject>
+#include <QRunnable>
+
+/**
+ * @brief Searches the movies matching a text in a thread of a QThreadPool,
+ * on its own connection to the database, so that typing in the search field
+ * never waits for the request.
+ *
+ * Each search has a generation number: a task which is not the latest one
+ * anymore gives up, and its results are ignored by ServicesManager.
+ * The ids are given back by batches, through a queued signal.
+ */
+class MoviesSearchTask : public QObject, public QRunnable
+{
+    #define SEARCH_BATCH_SIZE 5000
+    Q_OBJECT
+
+public:
+    explicit MoviesSearchTask(const QString databasePath,
+                              const QString text,
+                              const bool show,
+                              const int generation,
+                              const QAtomicInt *latestGeneration);
+    void run();
+
+signals:
+    void moviesFound(int generation, const QList<int> &movieIdList, bool finished);
+
+private:
+    QString m_databasePath;
+    QString m_text;
+    bool m_show;
+    int m_generation;
+    const QAtomicInt *m_latestGeneration;
+    bool isSuperseded() const;
+};
+
+#endif // MOVIESSEARCHTASK_H
@@ -0,0 +1,780 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <QBitArray>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include "MacawDebug.h"
+
+/**
+ * @brief Returns the distinct trigrams of a text, each packed in an integer
+ *
+ * @param QString text
+ * @return QSet<quint64>
+ */
+static QSet<quint64> trigramsOf(const QString &text)
+{
+    QSet<quint64> l_trigramSet;
+    for (int i = 0 ; i + 2 < text.size() ; i++) {
+        l_trigramSet.insert((quint64)text.at(i).unicode() << 32
+                            | (quint64)text.at(i + 1).unicode() << 16
+                            | (quint64)text.at(i + 2).unicode());
+    }
+
+    return l_trigramSet;
+}
+
+/**
+ * @brief Inserts an id in a sorted list, if it is not there yet.
+ * Appending is the common case while loading, as the ids come in order.
+ */
+static void insertSorted(QVector<int> &idVector, const int id)
+{
+    if (idVector.isEmpty() || idVector.last() < id) {
+        idVector.append(id);
+
+        return;
+    }
+
+    QVector<int>::iterator l_it = qLowerBound(idVector.begin(), idVector.end(), id);
+    if (*l_it != id) {
+        idVector.insert(l_it, id);
+    }
+}
+
+/**
+ * @brief Removes an id from a sorted list
+ */
+static void removeSorted(QVector<int> &idVector, const int id)
+{
+    QVector<int>::iterator l_it = qBinaryFind(idVector.begin(), idVector.end(), id);
+    if (l_it != idVector.end()) {
+        idVector.erase(l_it);
+    }
+}
+
+/**
+ * @brief Intersects two sorted lists.
+ * Each id of the shortest list is searched in the remaining part of the other,
+ * which is fast when their sizes are very different.
+ *
+ * @return QVector<int> sorted intersection
+ */
+static QVector<int> intersectSorted(const QVector<int> &left, const QVector<int> &right)
+{
+    if (left.size() > right.size()) {
+
+        return intersectSorted(right, left);
+    }
+
+    QVector<int> l_idVector;
+    QVector<int>::const_iterator l_from = right.constBegin();
+    foreach (int l_id, left) {
+        l_from = qLowerBound(l_from, right.constEnd(), l_id);
+        if (l_from == right.constEnd()) {
+            break;
+        }
+        if (*l_from == l_id) {
+            l_idVector.append(l_id);
+        }
+    }
+
+    return l_idVector;
+}
+
+static bool postingSizeLessThan(const QVector<int> *left, const QVector<int> *right)
+{
+    return left->size() < right->size();
+}
+
+/**
+ * @brief Returns the condition selecting some ids, or nothing to select all of them.
+ * The ids are integers, so they can be written in the query.
+ *
+ * @param QString column of the ids
+ * @param QList<int> ids to select
+ * @return QString
+ */
+static QString idCondition(const QString column, const QList<int> &idList)
+{
+    if (idList.isEmpty()) {
+
+        return QString();
+    }
+
+    QStringList l_idList;
+    foreach (int l_id, idList) {
+        l_idList.append(QString::number(l_id));
+    }
+
+    return "WHERE " + column + " IN (" + l_idList.join(",") + ") ";
+}
+
+/**
+ * @brief Adds or replaces the text of an element
+ *
+ * @param int id of the element
+ * @param QString text, already in lower case
+ */
+void SearchIndex::TrigramTable::insert(const int id, const QString &text)
+{
+    QHash<int, QString>::const_iterator l_known = m_texts.constFind(id);
+    if (l_known != m_texts.constEnd()) {
+        if (l_known.value() == text) {
+
+            return;
+        }
+        this->remove(id);
+    }
+
+    m_texts.insert(id, text);
+    foreach (quint64 l_trigram, trigramsOf(text)) {
+        insertSorted(m_postings[l_trigram], id);
+    }
+}
+
+/**
+ * @brief Removes the text of an element
+ *
+ * @param int id of the element
+ */
+void SearchIndex::TrigramTable::remove(const int id)
+{
+    if (!m_texts.contains(id)) {
+
+        return;
+    }
+
+    foreach (quint64 l_trigram, trigramsOf(m_texts.take(id))) {
+        QHash<quint64, QVector<int> >::iterator l_posting = m_postings.find(l_trigram);
+        if (l_posting == m_postings.end()) {
+            continue;
+        }
+        removeSorted(l_posting.value(), id);
+        if (l_posting.value().isEmpty()) {
+            m_postings.erase(l_posting);
+        }
+    }
+}
+
+/**
+ * @brief Returns the sorted ids of the elements whose text contains a word.
+ * The words shorter than a trigram are searched in all the texts.
+ *
+ * @param QString word, already in lower case
+ * @return QVector<int>
+ */
+QVector<int> SearchIndex::TrigramTable::find(const QString &word) const
+{
+    QVector<int> l_idVector;
+    if (word.size() < 3) {
+        QHash<int, QString>::const_iterator l_it;
+        for (l_it = m_texts.constBegin() ; l_it != m_texts.constEnd() ; ++l_it) {
+            if (l_it.value().contains(word)) {
+                l_idVector.append(l_it.key());
+            }
+        }
+        qSort(l_idVector);
+
+        return l_idVector;
+    }
+
+    QList<const QVector<int> *> l_postingList;
+    foreach (quint64 l_trigram, trigramsOf(word)) {
+        QHash<quint64, QVector<int> >::const_iterator l_posting = m_postings.constFind(l_trigram);
+        if (l_posting == m_postings.constEnd()) {
+
+            return l_idVector;
+        }
+        l_postingList.append(&l_posting.value());
+    }
+    qSort(l_postingList.begin(), l_postingList.end(), postingSizeLessThan);
+
+    QVector<int> l_candidateVector = *l_postingList.first();
+    for (int i = 1 ; i < l_postingList.size() && !l_candidateVector.isEmpty() ; i++) {
+        l_candidateVector = intersectSorted(l_candidateVector, *l_postingList.at(i));
+    }
+    if (word.size() == 3) {
+
+        return l_candidateVector;
+    }
+
+    // The trigrams are all there, but maybe not one after the other
+    foreach (int l_id, l_candidateVector) {
+        if (m_texts.value(l_id).contains(word)) {
+            l_idVector.append(l_id);
+        }
+    }
+
+    return l_idVector;
+}
+
+bool SearchIndex::TitleLessThan::operator()(const int left, const int right) const
+{
+    int l_compare = QString::compare(m_movies->value(left).titleSort,
+                                     m_movies->value(right).titleSort);
+    if (l_compare != 0) {
+
+        return l_compare < 0;
+    }
+
+    return left < right;
+}
+
+/**
+ * @brief Constructor of an empty index
+ */
+SearchIndex::SearchIndex()
+{
+}
+
+/**
+ * @brief Loads the whole index from the database.
+ * It is meant to run once, in another thread, on its own connection.
+ *
+ * @param QSqlDatabase connection to read
+ * @return bool
+ */
+bool SearchIndex::load(QSqlDatabase db)
+{
+    return this->loadMovies(db, QList<int>())
+            && this->loadPeople(db, QList<int>())
+            && this->loadTags(db, QList<int>());
+}
+
+/**
+ * @brief Reads again some movies, with their people and tags.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the movies
+ * @return bool
+ */
+bool SearchIndex::reloadMovies(QSqlDatabase db, const QList<int> &movieIdList)
+{
+    if (movieIdList.isEmpty()) {
+
+        return true;
+    }
+
+    return this->loadMovies(db, movieIdList);
+}
+
+/**
+ * @brief Reads again the names of some people.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the people
+ * @return bool
+ */
+bool SearchIndex::reloadPeople(QSqlDatabase db, const QList<int> &peopleIdList)
+{
+    if (peopleIdList.isEmpty()) {
+
+        return true;
+    }
+
+    return this->loadPeople(db, peopleIdList);
+}
+
+/**
+ * @brief Reads again the names of some tags.
+ * The ones not in the database anymore are removed.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the tags
+ * @return bool
+ */
+bool SearchIndex::reloadTags(QSqlDatabase db, const QList<int> &tagIdList)
+{
+    if (tagIdList.isEmpty()) {
+
+        return true;
+    }
+
+    return this->loadTags(db, tagIdList);
+}
+
+/**
+ * @brief Removes a movie and its links to people and tags
+ *
+ * @param int id of the movie
+ */
+void SearchIndex::removeMovie(const int movieId)
+{
+    this->removeFromOrder(movieId);
+    m_movies.remove(movieId);
+    m_movieTexts.remove(movieId);
+    setMovieLinks(movieId, QVector<int>(), m_peopleByMovie, m_moviesByPeople);
+    setMovieLinks(movieId, QVector<int>(), m_tagsByMovie, m_moviesByTag);
+}
+
+/**
+ * @brief Removes a person and its links to the movies
+ *
+ * @param int id of the person
+ */
+void SearchIndex::removePeople(const int peopleId)
+{
+    m_peopleTexts.remove(peopleId);
+    removeElementLinks(peopleId, m_peopleByMovie, m_moviesByPeople);
+}
+
+/**
+ * @brief Removes a tag and its links to the movies
+ *
+ * @param int id of the tag
+ */
+void SearchIndex::removeTag(const int tagId)
+{
+    m_tagTexts.remove(tagId);
+    removeElementLinks(tagId, m_tagsByMovie, m_moviesByTag);
+}
+
+/**
+ * @brief Returns the ids of the movies matching a text, ordered by title.
+ * As in DatabaseManager::prepareMoviesByAny(), each word of the text must be
+ * in the title, the original title, the name of a person or of a tag.
+ *
+ * @param QString text
+ * @param bool show: true to search the shows, false for the movies
+ * @return QList<int>
+ */
+QList<int> SearchIndex::search(const QString text, const bool show) const
+{
+    const QVector<int> &l_order = m_movieOrder[show ? 1 : 0];
+    QStringList l_wordList = text.toLower().split(' ', QString::SkipEmptyParts);
+    if (l_wordList.isEmpty()) {
+
+        return l_order.toList();
+    }
+
+    QVector<int> l_matchingIdVector;
+    for (int i = 0 ; i < l_wordList.size() ; i++) {
+        QVector<int> l_idVector = this->findMovies(l_wordList.at(i));
+        if (i == 0) {
+            l_matchingIdVector = l_idVector;
+        } else {
+            l_matchingIdVector = intersectSorted(l_matchingIdVector, l_idVector);
+        }
+        if (l_matchingIdVector.isEmpty()) {
+
+            return QList<int>();
+        }
+    }
+
+    QList<int> l_movieIdList;
+    if (l_matchingIdVector.size() * 32 < l_order.size()) {
+        // Few results: sorting them is cheaper than walking all the movies
+        foreach (int l_id, l_matchingIdVector) {
+            QHash<int, IndexedMovie>::const_iterator l_movie = m_movies.constFind(l_id);
+            if (l_movie != m_movies.constEnd() && l_movie.value().show == show) {
+                l_movieIdList.append(l_id);
+            }
+        }
+        qSort(l_movieIdList.begin(), l_movieIdList.end(), TitleLessThan(&m_movies));
+
+        return l_movieIdList;
+    }
+
+    // Walks the movies in order, through a bitset of the matching ones
+    QBitArray l_matchingBits(l_matchingIdVector.last() + 1);
+    foreach (int l_id, l_matchingIdVector) {
+        l_matchingBits.setBit(l_id);
+    }
+    foreach (int l_id, l_order) {
+        if (l_id < l_matchingBits.size() && l_matchingBits.testBit(l_id)) {
+            l_movieIdList.append(l_id);
+        }
+    }
+
+    return l_movieIdList;
+}
+
+/**
+ * @brief Reads movies and their links, by batches of SEARCH_INDEX_BATCH_SIZE.
+ * When the index is empty, the movies are only appended
+ * and sorted at the end.
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the movies, or an empty list for all of them
+ * @return bool
+ */
+bool SearchIndex::loadMovies(QSqlDatabase db, const QList<int> &movieIdList)
+{
+    bool l_bulk = m_movies.isEmpty();
+    QSet<int> l_foundIdSet;
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        QList<int> l_batchIdList = movieIdList.mid(i, SEARCH_INDEX_BATCH_SIZE);
+        l_query.prepare("SELECT id, title, original_title, show, title_sort "
+                        "FROM movies "
+                        + idCondition("id", l_batchIdList) +
+                        "ORDER BY id");
+
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In SearchIndex::loadMovies():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+
+        while (l_query.next()) {
+            int l_id = l_query.value(0).toInt();
+            l_foundIdSet.insert(l_id);
+            this->setMovie(l_id,
+                           l_query.value(1).toString(),
+                           l_query.value(2).toString(),
+                           l_query.value(4).toString(),
+                           l_query.value(3).toBool(),
+                           l_bulk);
+        }
+        i += SEARCH_INDEX_BATCH_SIZE;
+    } while (i < movieIdList.size());
+
+    if (l_bulk) {
+        qSort(m_movieOrder[0].begin(), m_movieOrder[0].end(), TitleLessThan(&m_movies));
+        qSort(m_movieOrder[1].begin(), m_movieOrder[1].end(), TitleLessThan(&m_movies));
+    }
+    foreach (int l_id, movieIdList) {
+        if (!l_foundIdSet.contains(l_id)) {
+            this->removeMovie(l_id);
+        }
+    }
+
+    return this->loadLinks(db, "movies_people", "id_people", movieIdList,
+                           m_peopleByMovie, m_moviesByPeople)
+            && this->loadLinks(db, "movies_tags", "id_tag", movieIdList,
+                               m_tagsByMovie, m_moviesByTag);
+}
+
+/**
+ * @brief Reads the names of people, by batches of SEARCH_INDEX_BATCH_SIZE
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the people, or an empty list for all of them
+ * @return bool
+ */
+bool SearchIndex::loadPeople(QSqlDatabase db, const QList<int> &peopleIdList)
+{
+    QSet<int> l_foundIdSet;
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        QList<int> l_batchIdList = peopleIdList.mid(i, SEARCH_INDEX_BATCH_SIZE);
+        l_query.prepare("SELECT id, name "
+                        "FROM people "
+                        + idCondition("id", l_batchIdList) +
+                        "ORDER BY id");
+
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In SearchIndex::loadPeople():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+
+        while (l_query.next()) {
+            int l_id = l_query.value(0).toInt();
+            l_foundIdSet.insert(l_id);
+            m_peopleTexts.insert(l_id, m_stringPool.intern(l_query.value(1).toString().toLower()));
+        }
+        i += SEARCH_INDEX_BATCH_SIZE;
+    } while (i < peopleIdList.size());
+
+    foreach (int l_id, peopleIdList) {
+        if (!l_foundIdSet.contains(l_id)) {
+            this->removePeople(l_id);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads the names of tags, by batches of SEARCH_INDEX_BATCH_SIZE
+ *
+ * @param QSqlDatabase connection to read
+ * @param QList<int> ids of the tags, or an empty list for all of them
+ * @return bool
+ */
+bool SearchIndex::loadTags(QSqlDatabase db, const QList<int> &tagIdList)
+{
+    QSet<int> l_foundIdSet;
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        QList<int> l_batchIdList = tagIdList.mid(i, SEARCH_INDEX_BATCH_SIZE);
+        l_query.prepare("SELECT id, name "
+                        "FROM tags "
+                        + idCondition("id", l_batchIdList) +
+                        "ORDER BY id");
+
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In SearchIndex::loadTags():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+
+        while (l_query.next()) {
+            int l_id = l_query.value(0).toInt();
+            l_foundIdSet.insert(l_id);
+            m_tagTexts.insert(l_id, m_stringPool.intern(l_query.value(1).toString().toLower()));
+        }
+        i += SEARCH_INDEX_BATCH_SIZE;
+    } while (i < tagIdList.size());
+
+    foreach (int l_id, tagIdList) {
+        if (!l_foundIdSet.contains(l_id)) {
+            this->removeTag(l_id);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads the links between movies and people or tags,
+ * by batches of SEARCH_INDEX_BATCH_SIZE movies
+ *
+ * @param QSqlDatabase connection to read
+ * @param QString table of the links
+ * @param QString column of the linked elements
+ * @param QList<int> ids of the movies, or an empty list for all of them
+ * @param QHash<int, QVector<int> > elementsByMovie to update
+ * @param QHash<int, QVector<int> > moviesByElement to update
+ * @return bool
+ */
+bool SearchIndex::loadLinks(QSqlDatabase db,
+                            const QString table,
+                            const QString column,
+                            const QList<int> &movieIdList,
+                            QHash<int, QVector<int> > &elementsByMovie,
+                            QHash<int, QVector<int> > &moviesByElement)
+{
+    QSqlQuery l_query(db);
+    l_query.setForwardOnly(true);
+    int i = 0;
+    do {
+        QList<int> l_batchIdList = movieIdList.mid(i, SEARCH_INDEX_BATCH_SIZE);
+        l_query.prepare("SELECT id_movie, " + column + " "
+                        "FROM " + table + " "
+                        + idCondition("id_movie", l_batchIdList) +
+                        "ORDER BY id_movie, " + column);
+
+        if (!l_query.exec()) {
+            Macaw::DEBUG("In SearchIndex::loadLinks():");
+            Macaw::DEBUG(l_query.lastError().text());
+
+            return false;
+        }
+
+        QSet<int> l_linkedIdSet;
+        int l_movieId = 0;
+        QVector<int> l_elementIdVector;
+        while (l_query.next()) {
+            int l_rowMovieId = l_query.value(0).toInt();
+            int l_elementId = l_query.value(1).toInt();
+            if (l_rowMovieId != l_movieId) {
+                if (l_movieId != 0) {
+                    setMovieLinks(l_movieId, l_elementIdVector, elementsByMovie, moviesByElement);
+                }
+                l_movieId = l_rowMovieId;
+                l_linkedIdSet.insert(l_movieId);
+                l_elementIdVector.clear();
+            }
+            // The same person can have several roles in a movie
+            if (l_elementIdVector.isEmpty() || l_elementIdVector.last() != l_elementId) {
+                l_elementIdVector.append(l_elementId);
+            }
+        }
+        if (l_movieId != 0) {
+            setMovieLinks(l_movieId, l_elementIdVector, elementsByMovie, moviesByElement);
+        }
+        foreach (int l_id, l_batchIdList) {
+            if (!l_linkedIdSet.contains(l_id)) {
+                setMovieLinks(l_id, QVector<int>(), elementsByMovie, moviesByElement);
+            }
+        }
+        i += SEARCH_INDEX_BATCH_SIZE;
+    } while (i < movieIdList.size());
+
+    return true;
+}
+
+/**
+ * @brief Adds or replaces a movie
+ *
+ * @param int id of the movie
+ * @param QString title
+ * @param QString original title
+ * @param QString sort key of the title
+ * @param bool show
+ * @param bool bulk: true to append the movie, the orders being sorted later
+ */
+void SearchIndex::setMovie(const int id,
+                           const QString &title,
+                           const QString &originalTitle,
+                           const QString &titleSort,
+                           const bool show,
+                           const bool bulk)
+{
+    QString l_text = title.toLower();
+    if (!originalTitle.isEmpty() && originalTitle != title) {
+        l_text += '\n' + originalTitle.toLower();
+    }
+    m_movieTexts.insert(id, m_stringPool.intern(l_text));
+
+    QHash<int, IndexedMovie>::const_iterator l_known = m_movies.constFind(id);
+    if (l_known != m_movies.constEnd()) {
+        if (l_known.value().titleSort == titleSort && l_known.value().show == show) {
+
+            return;
+        }
+        this->removeFromOrder(id);
+    }
+
+    IndexedMovie l_movie;
+    l_movie.titleSort = m_stringPool.intern(titleSort);
+    l_movie.show = show;
+    m_movies.insert(id, l_movie);
+
+    QVector<int> &l_order = m_movieOrder[show ? 1 : 0];
+    if (bulk) {
+        l_order.append(id);
+    } else {
+        l_order.insert(qLowerBound(l_order.begin(), l_order.end(), id, TitleLessThan(&m_movies)), id);
+    }
+}
+
+/**
+ * @brief Removes a movie from the title order, before its title changes
+ *
+ * @param int id of the movie
+ */
+void SearchIndex::removeFromOrder(const int movieId)
+{
+    QHash<int, IndexedMovie>::const_iterator l_known = m_movies.constFind(movieId);
+    if (l_known == m_movies.constEnd()) {
+
+        return;
+    }
+
+    QVector<int> &l_order = m_movieOrder[l_known.value().show ? 1 : 0];
+    QVector<int>::iterator l_it = qLowerBound(l_order.begin(), l_order.end(),
+                                              movieId, TitleLessThan(&m_movies));
+    if (l_it != l_order.end() && *l_it == movieId) {
+        l_order.erase(l_it);
+    }
+}
+
+/**
+ * @brief Returns the sorted ids of the movies having a word in their titles,
+ * people or tags
+ *
+ * @param QString word, already in lower case
+ * @return QVector<int>
+ */
+QVector<int> SearchIndex::findMovies(const QString &word) const
+{
+    QVector<int> l_movieIdVector = m_movieTexts.find(word);
+    foreach (int l_peopleId, m_peopleTexts.find(word)) {
+        l_movieIdVector += m_moviesByPeople.value(l_peopleId);
+    }
+    foreach (int l_tagId, m_tagTexts.find(word)) {
+        l_movieIdVector += m_moviesByTag.value(l_tagId);
+    }
+    qSort(l_movieIdVector);
+    l_movieIdVector.erase(std::unique(l_movieIdVector.begin(), l_movieIdVector.end()),
+                          l_movieIdVector.end());
+
+    return l_movieIdVector;
+}
+
+/**
+ * @brief Replaces the people or the tags linked to a movie
+ *
+ * @param int id of the movie
+ * @param QVector<int> sorted ids of the linked elements
+ * @param QHash<int, QVector<int> > elementsByMovie to update
+ * @param QHash<int, QVector<int> > moviesByElement to update
+ */
+void SearchIndex::setMovieLinks(const int movieId,
+                                const QVector<int> &elementIdVector,
+                                QHash<int, QVector<int> > &elementsByMovie,
+                                QHash<int, QVector<int> > &moviesByElement)
+{
+    foreach (int l_elementId, elementsByMovie.value(movieId)) {
+        if (qBinaryFind(elementIdVector, l_elementId) != elementIdVector.constEnd()) {
+            continue;
+        }
+        QHash<int, QVector<int> >::iterator l_movies = moviesByElement.find(l_elementId);
+        if (l_movies != moviesByElement.end()) {
+            removeSorted(l_movies.value(), movieId);
+            if (l_movies.value().isEmpty()) {
+                moviesByElement.erase(l_movies);
+            }
+        }
+    }
+    foreach (int l_elementId, elementIdVector) {
+        insertSorted(moviesByElement[l_elementId], movieId);
+    }
+
+    if (elementIdVector.isEmpty()) {
+        elementsByMovie.remove(movieId);
+    } else {
+        elementsByMovie.insert(movieId, elementIdVector);
+    }
+}
+
+/**
+ * @brief Removes all the links of a person or a tag
+ *
+ * @param int id of the person or the tag
+ * @param QHash<int, QVector<int> > elementsByMovie to update
+ * @param QHash<int, QVector<int> > moviesByElement to update
+ */
+void SearchIndex::removeElementLinks(const int elementId,
+                                     QHash<int, QVector<int> > &elementsByMovie,
+                                     QHash<int, QVector<int> > &moviesByElement)
+{
+    foreach (int l_movieId, moviesByElement.take(elementId)) {
+        QHash<int, QVector<int> >::iterator l_elements = elementsByMovie.find(l_movieId);
+        if (l_elements != elementsByMovie.end()) {
+            removeSorted(l_elements.value(), elementId);
+            if (l_elements.value().isEmpty()) {
+                elementsByMovie.erase(l_elements);
+            }
+        }
+    }
+}
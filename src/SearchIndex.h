@@ -0,0 +1,139 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+#include "StringPool.h"
+
+/**
+ * @brief In-memory trigram index over the titles, original titles,
+ * people names and tag names, answering the same searches as
+ * DatabaseManager::prepareMoviesByAny() without going through SQLite.
+ *
+ * Each text is cut in trigrams, and each trigram points to the sorted list
+ * of the ids containing it. A word is looked up by intersecting the lists
+ * of its trigrams, then the candidates are checked against the text.
+ *
+ * The index is loaded once with load() and then kept up to date with
+ * the reload*() and remove*() functions. It is not thread safe.
+ */
+class SearchIndex
+{
+    #define SEARCH_INDEX_BATCH_SIZE 500
+public:
+    SearchIndex();
+    bool load(QSqlDatabase db);
+    bool reloadMovies(QSqlDatabase db, const QList<int> &movieIdList);
+    bool reloadPeople(QSqlDatabase db, const QList<int> &peopleIdList);
+    bool reloadTags(QSqlDatabase db, const QList<int> &tagIdList);
+    void removeMovie(const int movieId);
+    void removePeople(const int peopleId);
+    void removeTag(const int tagId);
+    QList<int> search(const QString text, const bool show) const;
+
+private:
+    /**
+     * @brief Texts of one kind of element and their trigram posting lists
+     */
+    class TrigramTable
+    {
+    public:
+        void insert(const int id, const QString &text);
+        void remove(const int id);
+        QVector<int> find(const QString &word) const;
+
+    private:
+        QHash<int, QString> m_texts;
+        QHash<quint64, QVector<int> > m_postings;
+    };
+
+    struct IndexedMovie {
+        QString titleSort;
+        bool show;
+    };
+
+    /**
+     * @brief Orders the ids of the movies like the database does
+     * with `ORDER BY title_sort`
+     */
+    class TitleLessThan
+    {
+    public:
+        explicit TitleLessThan(const QHash<int, IndexedMovie> *movies) : m_movies(movies) {}
+        bool operator()(const int left, const int right) const;
+
+    private:
+        const QHash<int, IndexedMovie> *m_movies;
+    };
+
+    bool loadMovies(QSqlDatabase db, const QList<int> &movieIdList);
+    bool loadPeople(QSqlDatabase db, const QList<int> &peopleIdList);
+    bool loadTags(QSqlDatabase db, const QList<int> &tagIdList);
+    bool loadLinks(QSqlDatabase db,
+                   const QString table,
+                   const QString column,
+                   const QList<int> &movieIdList,
+                   QHash<int, QVector<int> > &elementsByMovie,
+                   QHash<int, QVector<int> > &moviesByElement);
+    void setMovie(const int id,
+                  const QString &title,
+                  const QString &originalTitle,
+                  const QString &titleSort,
+                  const bool show,
+                  const bool bulk);
+    void removeFromOrder(const int movieId);
+    QVector<int> findMovies(const QString &word) const;
+    static void setMovieLinks(const int movieId,
+                              const QVector<int> &elementIdVector,
+                              QHash<int, QVector<int> > &elementsByMovie,
+                              QHash<int, QVector<int> > &moviesByElement);
+    static void removeElementLinks(const int elementId,
+                                   QHash<int, QVector<int> > &elementsByMovie,
+                                   QHash<int, QVector<int> > &moviesByElement);
+
+    QHash<int, IndexedMovie> m_movies;
+
+    /**
+     * @brief Shares the equal texts and sort keys, as the titles of remakes
+     */
+    StringPool m_stringPool;
+
+    /**
+     * @brief Ids of the movies (0) and of the shows (1), ordered by title
+     */
+    QVector<int> m_movieOrder[2];
+
+    TrigramTable m_movieTexts;
+    TrigramTable m_peopleTexts;
+    TrigramTable m_tagTexts;
+    QHash<int, QVector<int> > m_peopleByMovie;
+    QHash<int, QVector<int> > m_moviesByPeople;
+    QHash<int, QVector<int> > m_tagsByMovie;
+    QHash<int, QVector<int> > m_moviesByTag;
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,70 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "SearchIndexTask.h"
+
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+
+#include "MacawDebug.h"
+#include "SearchIndex.h"
+
+/**
+ * @brief Constructor
+ *
+ * @param databasePath: file of the database
+ * @param index to load
+ */
+SearchIndexTask::SearchIndexTask(const QString databasePath, SearchIndex *index) :
+    m_databasePath(databasePath),
+    m_index(index)
+{
+}
+
+/**
+ * @brief Loads the index and tells if it succeeded
+ */
+void SearchIndexTask::run()
+{
+    QString l_connectionName = "search_index";
+    bool l_succeeded = false;
+    {
+        QSqlDatabase l_db = QSqlDatabase::addDatabase("QSQLITE", l_connectionName);
+        l_db.setDatabaseName(m_databasePath);
+        l_db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=1000");
+
+        if (!l_db.open()) {
+            Macaw::DEBUG("In SearchIndexTask::run():");
+            Macaw::DEBUG(l_db.lastError().text());
+        } else {
+            QElapsedTimer l_timer;
+            l_timer.start();
+            l_succeeded = m_index->load(l_db);
+            Macaw::DEBUG("[SearchIndexTask] Index loaded in "
+                         + QString::number(l_timer.elapsed()) + " ms");
+        }
+        l_db.close();
+    }
+    QSqlDatabase::removeDatabase(l_connectionName);
+
+    emit indexBuilt(l_succeeded);
+}
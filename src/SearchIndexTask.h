@@ -0,0 +1,53 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef SEARCHINDEXTASK_H
+#define SEARCHINDEXTASK_H
+
+#include <QObject>
+#include <QRunnable>
+
+class SearchIndex;
+
+/**
+ * @brief Loads a SearchIndex in a thread of a QThreadPool,
+ * on its own connection to the database.
+ *
+ * The index belongs to the caller, which must not use it
+ * before indexBuilt() is received.
+ */
+class SearchIndexTask : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit SearchIndexTask(const QString databasePath, SearchIndex *index);
+    void run();
+
+signals:
+    void indexBuilt(bool succeeded);
+
+private:
+    QString m_databasePath;
+    SearchIndex *m_index;
+};
+
+#endif // SEARCHINDEXTASK_H
@@ -19,14 +19,103 @@
 
 #include "ServicesManager.h"
 
+#include <QApplication>
+#include <QSettings>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "enumerations.h"
+
+#include "CatalogTask.h"
 #include "DatabaseManager.h"
+#include "MacawDebug.h"
+#include "MoviesSearchTask.h"
+#include "SearchIndex.h"
+#include "SearchIndexTask.h"
 #include "Entities/Movie.h"
+#include "Entities/Playlist.h"
 
 Q_GLOBAL_STATIC(ServicesManager, servicesManager)
 
 ServicesManager::ServicesManager(QObject *parent) : QObject(parent)
 {
     m_databaseManager = new DatabaseManager;
+    m_toWatchState = false;
+    m_dirtyPannels = 0;
+
+    m_searchThreadPool = new QThreadPool(this);
+    m_searchThreadPool->setMaxThreadCount(1);
+    m_shownSearchGeneration = 0;
+
+    m_searchIndex = 0;
+    m_searchIndexReady = false;
+    QSettings l_settings("Macaw-Movies", "Macaw-Movies");
+    if (l_settings.value("search/inMemoryIndex", true).toBool()) {
+        m_searchIndex = new SearchIndex;
+        SearchIndexTask *l_task = new SearchIndexTask(m_databaseManager->databasePath(),
+                                                      m_searchIndex);
+        connect(l_task, SIGNAL(indexBuilt(bool)),
+                this, SLOT(on_searchIndexBuilt(bool)));
+        QThreadPool::globalInstance()->start(l_task);
+    }
+
+    m_catalog = 0;
+    m_loadingCatalog = 0;
+    m_catalogStalePaths = false;
+    m_catalogSnapshotTimer = new QTimer(this);
+    m_catalogSnapshotTimer->setSingleShot(true);
+    m_catalogSnapshotTimer->setInterval(CATALOG_SNAPSHOT_DELAY);
+    connect(m_catalogSnapshotTimer, SIGNAL(timeout()),
+            this, SLOT(saveCatalogSnapshot()));
+    if (l_settings.value("catalog/inMemory", true).toBool()) {
+        // The snapshot of the last session is shown at once,
+        // and checked against the database in the background
+        int l_snapshotDataVersion = -1;
+        Catalog *l_snapshot = new Catalog;
+        if (l_snapshot->loadSnapshot(this->catalogSnapshotPath(), l_snapshotDataVersion)) {
+            m_catalog = l_snapshot;
+        } else {
+            delete l_snapshot;
+        }
+
+        m_loadingCatalog = new Catalog;
+        CatalogTask *l_task = new CatalogTask(m_databaseManager->databasePath(),
+                                              m_loadingCatalog,
+                                              l_snapshotDataVersion);
+        connect(l_task, SIGNAL(catalogBuilt(bool)),
+                this, SLOT(on_catalogBuilt(bool)));
+        connect(l_task, SIGNAL(catalogUpToDate()),
+                this, SLOT(on_catalogUpToDate()));
+        QThreadPool::globalInstance()->start(l_task);
+    }
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, SIGNAL(timeout()),
+            this, SLOT(refreshPannels()));
+
+    connect(m_databaseManager, SIGNAL(moviesChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(on_moviesChanged()));
+    connect(m_databaseManager, SIGNAL(moviesPathsChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(on_moviesChanged()));
+    connect(m_databaseManager, SIGNAL(peopleChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(on_peopleOrTagsChanged()));
+    connect(m_databaseManager, SIGNAL(tagsChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(on_peopleOrTagsChanged()));
+    connect(m_databaseManager, SIGNAL(playlistsChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(on_playlistsChanged()));
+
+    connect(m_databaseManager, SIGNAL(moviesChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(updateIndexedMovies(QList<int>,QList<int>,QList<int>)));
+    connect(m_databaseManager, SIGNAL(peopleChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(updateIndexedPeople(QList<int>,QList<int>,QList<int>)));
+    connect(m_databaseManager, SIGNAL(tagsChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(updateIndexedTags(QList<int>,QList<int>,QList<int>)));
+    connect(m_databaseManager, SIGNAL(moviesPathsChanged(QList<int>,QList<int>,QList<int>)),
+            this, SLOT(updateCatalogPaths()));
+
+    connect(qApp, SIGNAL(aboutToQuit()),
+            m_databaseManager, SLOT(logStatistics()));
 }
 
 ServicesManager *ServicesManager::instance()
@@ -34,14 +123,437 @@ ServicesManager *ServicesManager::instance()
     return servicesManager;
 }
 
-void ServicesManager::setMatchingMovieList(QString pattern, bool shows)
+/**
+ * @brief Starts the search of the movies matching a pattern.
+ * When the search index is ready, it answers at once, as the catalog does
+ * for an empty pattern; else the search runs in another thread. The results come through `on_moviesFound()` either way;
+ * the older searches still running are given up.
+ *
+ * @param pattern to search
+ * @param shows: true to search the shows, false for the movies
+ */
+void ServicesManager::searchMovies(const QString pattern, const bool shows)
+{
+    int l_generation = m_searchGeneration.fetchAndAddOrdered(1) + 1;
+    if (m_searchIndexReady) {
+        this->on_moviesFound(l_generation, m_searchIndex->search(pattern, shows), true);
+
+        return;
+    }
+    this->refreshCatalog();
+    if (pattern.isEmpty() && m_catalog != 0) {
+        Catalog::Filter l_filter;
+        l_filter.show = shows;
+        this->on_moviesFound(l_generation, m_catalog->ids(m_catalog->select(l_filter)), true);
+
+        return;
+    }
+
+    MoviesSearchTask *l_task = new MoviesSearchTask(m_databaseManager->databasePath(),
+                                                    pattern,
+                                                    shows,
+                                                    l_generation,
+                                                    &m_searchGeneration);
+    connect(l_task, SIGNAL(moviesFound(int,QList<int>,bool)),
+            this, SLOT(on_moviesFound(int,QList<int>,bool)));
+    m_searchThreadPool->start(l_task);
+}
+
+/**
+ * @brief Slot triggered when a search sends a batch of matching movies.
+ * The first batch of a search replaces the results of the previous one,
+ * the next ones are added; the batches of an old search are ignored.
+ *
+ * @param generation of the search
+ * @param movieIdList: ids of the batch
+ * @param finished: true for the last batch
+ */
+void ServicesManager::on_moviesFound(int generation, const QList<int> &movieIdList, bool finished)
+{
+    if (generation != m_searchGeneration.load()) {
+
+        return;
+    }
+
+    if (generation != m_shownSearchGeneration) {
+        m_shownSearchGeneration = generation;
+        m_matchingMovieIdList.clear();
+        m_matchingMovieIdSet.clear();
+        if (m_toWatchState) {
+            m_toWatchMovieIdSet = m_databaseManager->getMovieIdsByPlaylist(Playlist::ToWatch);
+        } else {
+            m_toWatchMovieIdSet.clear();
+        }
+    }
+    m_matchingMovieIdList.append(movieIdList);
+    foreach (int l_id, movieIdList) {
+        m_matchingMovieIdSet.insert(l_id);
+    }
+
+    emit matchingMoviesChanged(finished);
+}
+
+/**
+ * @brief Slot triggered when the search index is loaded.
+ * The elements changed meanwhile are read again before it is used.
+ *
+ * @param succeeded: false if the index could not be loaded
+ */
+void ServicesManager::on_searchIndexBuilt(bool succeeded)
+{
+    if (!succeeded) {
+        Macaw::DEBUG("[ServicesManager] The search index could not be loaded");
+        delete m_searchIndex;
+        m_searchIndex = 0;
+
+        return;
+    }
+
+    m_searchIndexReady = true;
+    this->refreshSearchIndex();
+}
+
+/**
+ * @brief Slot triggered when movies changed in the database,
+ * or their links to people and tags
+ */
+void ServicesManager::updateIndexedMovies(const QList<int> &inserted,
+                                          const QList<int> &updated,
+                                          const QList<int> &deleted)
+{
+    QSet<int> l_changedIdSet = (inserted + updated + deleted).toSet();
+    if (m_searchIndex != 0) {
+        m_staleMovieIdSet.unite(l_changedIdSet);
+        if (m_searchIndexReady) {
+            this->refreshSearchIndex();
+        }
+    }
+
+    if (m_catalog != 0 || m_loadingCatalog != 0) {
+        m_catalogStaleMovieIdSet.unite(l_changedIdSet);
+    }
+}
+
+/**
+ * @brief Slot triggered when people changed in the database
+ */
+void ServicesManager::updateIndexedPeople(const QList<int> &inserted,
+                                          const QList<int> &updated,
+                                          const QList<int> &deleted)
 {
-    m_matchingMovieList = m_databaseManager->getMoviesByAny(pattern, shows);
+    if (m_searchIndex != 0) {
+        m_stalePeopleIdSet.unite((inserted + updated + deleted).toSet());
+        if (m_searchIndexReady) {
+            this->refreshSearchIndex();
+        }
+    }
+
+    if (m_catalog != 0 || m_loadingCatalog != 0) {
+        m_catalogStalePeopleIdSet.unite((inserted + updated).toSet());
+        m_catalogDeletedPeopleIdSet.unite(deleted.toSet());
+    }
+}
+
+/**
+ * @brief Slot triggered when tags changed in the database
+ */
+void ServicesManager::updateIndexedTags(const QList<int> &inserted,
+                                        const QList<int> &updated,
+                                        const QList<int> &deleted)
+{
+    if (m_searchIndex != 0) {
+        m_staleTagIdSet.unite((inserted + updated + deleted).toSet());
+        if (m_searchIndexReady) {
+            this->refreshSearchIndex();
+        }
+    }
+
+    if (m_catalog != 0 || m_loadingCatalog != 0) {
+        m_catalogStaleTagIdSet.unite((inserted + updated).toSet());
+        m_catalogDeletedTagIdSet.unite(deleted.toSet());
+    }
+}
+
+/**
+ * @brief Slot triggered when the folders of the movies changed in the database.
+ * Their movies come through updateIndexedMovies().
+ */
+void ServicesManager::updateCatalogPaths()
+{
+    if (m_catalog == 0 && m_loadingCatalog == 0) {
+
+        return;
+    }
+
+    m_catalogStalePaths = true;
+}
+
+/**
+ * @brief Reads again the stale elements of the search index.
+ * If it fails, the index is dropped and the searches go through the database.
+ */
+void ServicesManager::refreshSearchIndex()
+{
+    QSqlDatabase l_db = m_databaseManager->database();
+    bool l_succeeded = m_searchIndex->reloadMovies(l_db, m_staleMovieIdSet.toList())
+            && m_searchIndex->reloadPeople(l_db, m_stalePeopleIdSet.toList())
+            && m_searchIndex->reloadTags(l_db, m_staleTagIdSet.toList());
+    m_staleMovieIdSet.clear();
+    m_stalePeopleIdSet.clear();
+    m_staleTagIdSet.clear();
+
+    if (!l_succeeded) {
+        Macaw::DEBUG("[ServicesManager] The search index is dropped");
+        delete m_searchIndex;
+        m_searchIndex = 0;
+        m_searchIndexReady = false;
+    }
+}
+
+/**
+ * @brief Slot triggered when the catalog is loaded.
+ * It replaces the snapshot, if one was shown, and the changes
+ * received meanwhile are applied before it is used.
+ *
+ * @param succeeded: false if the catalog could not be loaded
+ */
+void ServicesManager::on_catalogBuilt(bool succeeded)
+{
+    bool l_snapshotShown = m_catalog != 0;
+    delete m_catalog;
+    m_catalog = m_loadingCatalog;
+    m_loadingCatalog = 0;
+
+    if (!succeeded) {
+        Macaw::DEBUG("[ServicesManager] The catalog could not be loaded");
+        delete m_catalog;
+        m_catalog = 0;
+    }
+
+    this->refreshCatalog();
+    if (m_catalog != 0) {
+        m_catalogSnapshotTimer->start();
+    }
+    if (l_snapshotShown) {
+        this->scheduleRefresh(Macaw::DirtyAllPannels);
+    }
+}
+
+/**
+ * @brief Slot triggered when the shown snapshot of the catalog
+ * is found up to date: the loading catalog is not needed.
+ */
+void ServicesManager::on_catalogUpToDate()
+{
+    delete m_loadingCatalog;
+    m_loadingCatalog = 0;
+
+    // The changes received meanwhile are already in the snapshot
+    bool l_changed = !m_catalogStaleMovieIdSet.isEmpty()
+            || !m_catalogStalePeopleIdSet.isEmpty()
+            || !m_catalogDeletedPeopleIdSet.isEmpty()
+            || !m_catalogStaleTagIdSet.isEmpty()
+            || !m_catalogDeletedTagIdSet.isEmpty()
+            || m_catalogStalePaths;
+    if (m_catalog != 0 && l_changed) {
+        m_catalogSnapshotTimer->start();
+    }
+    m_catalogStaleMovieIdSet.clear();
+    m_catalogStalePeopleIdSet.clear();
+    m_catalogDeletedPeopleIdSet.clear();
+    m_catalogStaleTagIdSet.clear();
+    m_catalogDeletedTagIdSet.clear();
+    m_catalogStalePaths = false;
+}
+
+/**
+ * @brief Applies the pending changes to the catalog.
+ * The change slots only record them: they are applied before the pannels
+ * are refreshed, so that the transactions of a burst are applied at once.
+ * They are kept while a catalog is loading, as it may have read the
+ * database before them. If it fails, the catalog is dropped and the pannels
+ * use the database.
+ */
+void ServicesManager::refreshCatalog()
+{
+    bool l_changed = !m_catalogStaleMovieIdSet.isEmpty()
+            || !m_catalogStalePeopleIdSet.isEmpty()
+            || !m_catalogDeletedPeopleIdSet.isEmpty()
+            || !m_catalogStaleTagIdSet.isEmpty()
+            || !m_catalogDeletedTagIdSet.isEmpty()
+            || m_catalogStalePaths;
+    bool l_succeeded = true;
+    if (m_catalog != 0 && l_changed) {
+        foreach (int l_id, m_catalogDeletedPeopleIdSet) {
+            m_catalog->removePeople(l_id);
+        }
+        foreach (int l_id, m_catalogDeletedTagIdSet) {
+            m_catalog->removeTag(l_id);
+        }
+
+        QSqlDatabase l_db = m_databaseManager->database();
+        l_succeeded = (!m_catalogStalePaths || m_catalog->reloadPaths(l_db))
+                && m_catalog->reloadPeople(l_db, m_catalogStalePeopleIdSet.toList())
+                && m_catalog->reloadTags(l_db, m_catalogStaleTagIdSet.toList())
+                && m_catalog->reloadMovies(l_db, m_catalogStaleMovieIdSet.toList());
+    }
+
+    if (m_loadingCatalog == 0) {
+        m_catalogStaleMovieIdSet.clear();
+        m_catalogStalePeopleIdSet.clear();
+        m_catalogDeletedPeopleIdSet.clear();
+        m_catalogStaleTagIdSet.clear();
+        m_catalogDeletedTagIdSet.clear();
+        m_catalogStalePaths = false;
+    }
+
+    if (!l_succeeded) {
+        Macaw::DEBUG("[ServicesManager] The catalog is dropped");
+        delete m_catalog;
+        m_catalog = 0;
+    } else if (m_catalog != 0 && l_changed) {
+        m_catalogSnapshotTimer->start();
+    }
+}
+
+/**
+ * @brief Slot triggered by m_catalogSnapshotTimer: writes the snapshot
+ * of the catalog, shown at the next start.
+ * Nothing is written while the catalog is being checked or loaded.
+ */
+void ServicesManager::saveCatalogSnapshot()
+{
+    if (m_catalog == 0 || m_loadingCatalog != 0) {
+
+        return;
+    }
+
+    int l_dataVersion = m_databaseManager->getDataVersion();
+    if (l_dataVersion >= 0) {
+        m_catalog->saveSnapshot(this->catalogSnapshotPath(), l_dataVersion);
+    }
+}
+
+/**
+ * @brief Returns the path of the snapshot of the catalog
+ *
+ * @return QString
+ */
+QString ServicesManager::catalogSnapshotPath() const
+{
+    return qApp->property("filesPath").toString() + "catalog.snapshot";
+}
+
+/**
+ * @brief Returns the catalog of the movies, or 0 if there is none yet:
+ * the movies must then be read from the database.
+ *
+ * @return const Catalog*
+ */
+const Catalog *ServicesManager::catalog() const
+{
+    return m_catalog;
+}
+
+/**
+ * @brief Returns the filter of the catalog selecting the movies
+ * that pass the filters of the pannels, as isMovieShown() does
+ *
+ * @return Catalog::Filter
+ */
+Catalog::Filter ServicesManager::shownMoviesFilter() const
+{
+    Catalog::Filter l_filter;
+    l_filter.matchingIdSet = &m_matchingMovieIdSet;
+    if (m_toWatchState) {
+        l_filter.toWatchIdSet = &m_toWatchMovieIdSet;
+    }
+
+    return l_filter;
+}
+
+/**
+ * @brief Tells if a movie passes the filters of the pannels:
+ * it matches the search and is to watch if only those are shown.
+ * The sets are filled by `on_moviesFound()`.
+ *
+ * @param int id of the movie
+ * @return bool
+ */
+bool ServicesManager::isMovieShown(const int movieId) const
+{
+    return m_matchingMovieIdSet.contains(movieId)
+            && (!m_toWatchState || m_toWatchMovieIdSet.contains(movieId));
 }
 
 void ServicesManager::pannelsUpdate()
 {
-    emit requestPannelsUpdate();
+    this->scheduleRefresh(Macaw::DirtyAllPannels);
+}
+
+/**
+ * @brief Asks for the refresh of some pannels.
+ * The requests are merged until the refresh is done, and the refreshes
+ * are spaced by at least REFRESH_MIN_INTERVAL ms, so that a burst of
+ * requests leads to one refresh only.
+ *
+ * @param dirtyPannels: pannels to refresh (Macaw::dirtyPannels flags)
+ */
+void ServicesManager::scheduleRefresh(const int dirtyPannels)
+{
+    m_dirtyPannels |= dirtyPannels;
+    if (m_refreshTimer->isActive()) {
+
+        return;
+    }
+
+    int l_delay = 0;
+    if (m_lastRefreshTimer.isValid()) {
+        l_delay = qMax(0, REFRESH_MIN_INTERVAL - (int)m_lastRefreshTimer.elapsed());
+    }
+    m_refreshTimer->start(l_delay);
+}
+
+/**
+ * @brief Slot triggered by m_refreshTimer: brings the catalog up to date
+ * and sends the merged refresh request
+ */
+void ServicesManager::refreshPannels()
+{
+    int l_dirtyPannels = m_dirtyPannels;
+    m_dirtyPannels = 0;
+    m_lastRefreshTimer.start();
+    this->refreshCatalog();
+
+    if (l_dirtyPannels != 0) {
+        emit requestPannelsUpdate(l_dirtyPannels);
+    }
+}
+
+/**
+ * @brief Slot triggered when movies or paths changed in the database.
+ * Their people and tags may have changed too.
+ */
+void ServicesManager::on_moviesChanged()
+{
+    this->scheduleRefresh(Macaw::DirtyAllPannels);
+}
+
+/**
+ * @brief Slot triggered when people or tags changed in the database
+ */
+void ServicesManager::on_peopleOrTagsChanged()
+{
+    this->scheduleRefresh(Macaw::DirtyLeftPannel | Macaw::DirtyMetadataPannel);
+}
+
+/**
+ * @brief Slot triggered when playlists changed in the database.
+ * The content of ToWatch filters both the left and the main pannels.
+ */
+void ServicesManager::on_playlistsChanged()
+{
+    this->scheduleRefresh(Macaw::DirtyLeftPannel | Macaw::DirtyMainPannel);
 }
 
 /**
@@ -20,13 +20,21 @@
 #ifndef SERVICESMANAGER_H
 #define SERVICESMANAGER_H
 
+#include <QAtomicInt>
+#include <QElapsedTimer>
 #include <QObject>
+#include <QSet>
 
+#include "Catalog.h"
 #include "DatabaseManager.h"
 #include "Entities/Movie.h"
 
+class QThreadPool;
+class QTimer;
+
 class DatabaseManager;
 class Movie;
+class SearchIndex;
 
 /**
  * @brief The ServicesManager class
@@ -34,28 +42,117 @@ class Movie;
  */
 class ServicesManager : public QObject
 {
+    #define REFRESH_MIN_INTERVAL 200
+    #define CATALOG_SNAPSHOT_DELAY 2000
     Q_OBJECT
 public:
     explicit ServicesManager(QObject *parent = 0);
     static ServicesManager* instance();
-    QList<Movie> matchingMovieList() const { return m_matchingMovieList; }
-    void setMatchingMovieList(const QString pattern, bool shows);
+    QList<int> matchingMovieIdList() const { return m_matchingMovieIdList; }
+    void searchMovies(const QString pattern, const bool shows);
+    bool isMovieShown(const int movieId) const;
     bool toWatchState() const { return m_toWatchState; }
     void setToWatchState(const bool state) { m_toWatchState = state; }
     DatabaseManager* databaseManager() { return m_databaseManager; }
+    void scheduleRefresh(const int dirtyPannels);
+    const Catalog *catalog() const;
+    Catalog::Filter shownMoviesFilter() const;
 
 signals:
-    void requestPannelsUpdate();
+    void matchingMoviesChanged(bool finished);
+    void requestPannelsUpdate(int dirtyPannels);
     void requestTempStatusBarMessage(QString message, int time = 0);
 
 public slots:
     void pannelsUpdate();
     void showTempStatusBarMessage(QString message, int time);
 
+private slots:
+    void refreshPannels();
+    void on_moviesFound(int generation, const QList<int> &movieIdList, bool finished);
+    void on_searchIndexBuilt(bool succeeded);
+    void on_catalogBuilt(bool succeeded);
+    void on_catalogUpToDate();
+    void saveCatalogSnapshot();
+    void updateIndexedMovies(const QList<int> &inserted,
+                             const QList<int> &updated,
+                             const QList<int> &deleted);
+    void updateIndexedPeople(const QList<int> &inserted,
+                             const QList<int> &updated,
+                             const QList<int> &deleted);
+    void updateIndexedTags(const QList<int> &inserted,
+                           const QList<int> &updated,
+                           const QList<int> &deleted);
+    void updateCatalogPaths();
+    void on_moviesChanged();
+    void on_peopleOrTagsChanged();
+    void on_playlistsChanged();
+
 private:
-    QList<Movie> m_matchingMovieList;
+    /**
+     * @brief Ids of the movies matching the search, in a list to keep
+     * the order of the database and in a set for the lookups,
+     * and ids of the movies to watch when the toWatch filter is on
+     */
+    QList<int> m_matchingMovieIdList;
+    QSet<int> m_matchingMovieIdSet;
+    QSet<int> m_toWatchMovieIdSet;
     DatabaseManager *m_databaseManager;
     bool m_toWatchState;
+
+    /**
+     * @brief The searches run one at a time in m_searchThreadPool.
+     * m_searchGeneration is the generation of the latest search asked,
+     * m_shownSearchGeneration the one of the shown results.
+     */
+    QThreadPool *m_searchThreadPool;
+    QAtomicInt m_searchGeneration;
+    int m_shownSearchGeneration;
+
+    /**
+     * @brief Optional in-memory index answering the searches at once
+     * (setting "search/inMemoryIndex"). It is loaded in another thread:
+     * until it is ready, the changed elements are kept in the stale sets
+     * and the searches go through the database.
+     */
+    SearchIndex *m_searchIndex;
+    bool m_searchIndexReady;
+    QSet<int> m_staleMovieIdSet;
+    QSet<int> m_stalePeopleIdSet;
+    QSet<int> m_staleTagIdSet;
+    void refreshSearchIndex();
+
+    /**
+     * @brief Optional in-memory catalog filtering the movies of the pannels
+     * (setting "catalog/inMemory"). m_catalog is the one in use, read from
+     * the snapshot of the last session at startup; m_loadingCatalog is loaded
+     * in another thread unless the snapshot is up to date. Until then, the
+     * changes are kept aside. Without a catalog, the pannels use the database.
+     * The snapshot is written CATALOG_SNAPSHOT_DELAY ms after the last change.
+     */
+    Catalog *m_catalog;
+    Catalog *m_loadingCatalog;
+    QSet<int> m_catalogStaleMovieIdSet;
+    QSet<int> m_catalogStalePeopleIdSet;
+    QSet<int> m_catalogDeletedPeopleIdSet;
+    QSet<int> m_catalogStaleTagIdSet;
+    QSet<int> m_catalogDeletedTagIdSet;
+    bool m_catalogStalePaths;
+    QTimer *m_catalogSnapshotTimer;
+    void refreshCatalog();
+    QString catalogSnapshotPath() const;
+
+    /**
+     * @brief Coalesces the refresh requests:
+     * at most one refresh every REFRESH_MIN_INTERVAL ms
+     */
+    QTimer *m_refreshTimer;
+    QElapsedTimer m_lastRefreshTimer;
+
+    /**
+     * @brief Pannels to refresh (Macaw::dirtyPannels flags)
+     */
+    int m_dirtyPannels;
 };
 
 #endif // SERVICESMANAGER_H
@@ -0,0 +1,82 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SortKey.h"
+
+/**
+ * @brief Leading articles ignored by the sort, once in lower case
+ */
+static const char *const s_articles[] = {
+    "the ", "a ", "an ",
+    "le ", "la ", "les ", "l'", "un ", "une ",
+    "der ", "die ", "das ", "ein ", "eine ",
+    "el ", "los ", "las ", "il ", "lo ", "gli ",
+    0
+};
+
+/**
+ * @brief Returns the sort key of a title
+ *
+ * @param QString title
+ * @return QString
+ */
+QString SortKey::title(const QString &title)
+{
+    QString l_key = folded(title);
+    for (int i = 0 ; s_articles[i] != 0 ; i++) {
+        QLatin1String l_article(s_articles[i]);
+        if (l_key.startsWith(l_article) && l_key.size() > l_article.size()) {
+            l_key.remove(0, l_article.size());
+            break;
+        }
+    }
+
+    return l_key.trimmed();
+}
+
+/**
+ * @brief Returns the sort key of the name of a person
+ *
+ * @param QString name
+ * @return QString
+ */
+QString SortKey::name(const QString &name)
+{
+    return folded(name);
+}
+
+/**
+ * @brief Returns a text in lower case and without accents
+ *
+ * @param QString text
+ * @return QString
+ */
+QString SortKey::folded(const QString &text)
+{
+    QString l_decomposed = text.trimmed().toLower().normalized(QString::NormalizationForm_KD);
+    QString l_key;
+    l_key.reserve(l_decomposed.size());
+    foreach (QChar l_char, l_decomposed) {
+        if (l_char.category() != QChar::Mark_NonSpacing) {
+            l_key.append(l_char);
+        }
+    }
+
+    return l_key;
+}
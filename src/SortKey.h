@@ -0,0 +1,45 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SORTKEY_H
+#define SORTKEY_H
+
+#include <QString>
+
+/**
+ * @brief Keys the titles and the names are sorted on.
+ *
+ * The key of a text is in lower case and without accents. The leading
+ * article of a title is dropped too, so that "L'Été meurtrier" comes with
+ * the E and "The Thing" with the T, but not the one of a name: "Les Paul"
+ * stays with the L. It is stored next to the text in the database
+ * (movies.title_sort, people.name_sort), where it is indexed, and compared
+ * with a QCollator for the sorts made in memory.
+ */
+class SortKey
+{
+public:
+    static QString title(const QString &title);
+    static QString name(const QString &name);
+
+private:
+    static QString folded(const QString &text);
+};
+
+#endif // SORTKEY_H
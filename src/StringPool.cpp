@@ -0,0 +1,76 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StringPool.h"
+
+/**
+ * @brief Constructor of an empty pool
+ */
+StringPool::StringPool() :
+    m_releasedBytes(0)
+{
+}
+
+/**
+ * @brief Returns a string equal to `string`, sharing the data of the one
+ * already in the pool if there is one
+ *
+ * @param QString
+ * @return QString
+ */
+QString StringPool::intern(const QString &string)
+{
+    if (string.isEmpty()) {
+
+        return string;
+    }
+
+    QSet<QString>::const_iterator l_iterator = m_strings.constFind(string);
+    if (l_iterator != m_strings.constEnd()) {
+        m_releasedBytes += string.size() * sizeof(QChar);
+
+        return *l_iterator;
+    }
+
+    QString l_string = string;
+    l_iterator = m_previousStrings.constFind(string);
+    if (l_iterator != m_previousStrings.constEnd()) {
+        // Still in use: kept in the current generation
+        m_releasedBytes += string.size() * sizeof(QChar);
+        l_string = *l_iterator;
+        m_previousStrings.remove(l_string);
+    }
+
+    if (m_strings.size() >= STRING_POOL_GENERATION_SIZE) {
+        m_previousStrings.swap(m_strings);
+        m_strings.clear();
+    }
+    m_strings.insert(l_string);
+
+    return l_string;
+}
+
+/**
+ * @brief Empties the pool. The strings already returned stay valid.
+ */
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_previousStrings.clear();
+}
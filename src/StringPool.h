@@ -0,0 +1,59 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief Shares the strings read many times, such as the countries,
+ * the formats or the names of the people: the copies returned by intern()
+ * point to the same data.
+ *
+ * The strings are kept in two generations of at most STRING_POOL_GENERATION_SIZE
+ * strings: when the current one is full, it becomes the previous one and the
+ * strings of the previous one that were not used again are dropped. The pool
+ * does not keep growing, and the strings in use stay in it.
+ * It is not thread safe.
+ */
+class StringPool
+{
+    #define STRING_POOL_GENERATION_SIZE 50000
+public:
+    StringPool();
+    QString intern(const QString &string);
+    void clear();
+    int size() const { return m_strings.size() + m_previousStrings.size(); }
+    qint64 releasedBytes() const { return m_releasedBytes; }
+
+private:
+    QSet<QString> m_strings;
+    QSet<QString> m_previousStrings;
+
+    /**
+     * @brief Estimated memory released since the pool was created:
+     * the size of the copies given to intern() and replaced by a pooled string,
+     * which can be freed
+     */
+    qint64 m_releasedBytes;
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,394 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TrashJob.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QThreadPool>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <shellapi.h>
+#endif
+
+#include "MacawDebug.h"
+#include "MountPointResolver.h"
+#include "ServicesManager.h"
+#include "Entities/Movie.h"
+
+/**
+ * @brief Constructor. The trash folders are found here, in the GUI thread;
+ * the files on a same mount point share the same one.
+ *
+ * @param movieList: movies to delete
+ * @param dialogParent: window of the dialogs shown by the job
+ */
+TrashJob::TrashJob(const QList<Movie> &movieList, QWidget *dialogParent) :
+    m_dialogParent(dialogParent),
+    m_progressDialog(0)
+{
+    this->setAutoDelete(false);
+
+    QHash<QString, QString> l_trashFolderHash;
+    foreach (Movie l_movie, movieList) {
+        QString l_filePath = l_movie.fileAbsolutePath();
+        QString l_trashFolder;
+#ifdef Q_OS_LINUX
+        QString l_mountPoint = MountPointResolver::instance()->mountPoint(l_filePath);
+        if (!l_trashFolderHash.contains(l_mountPoint)) {
+            l_trashFolderHash.insert(l_mountPoint, findTrashFolder(l_filePath));
+        }
+        l_trashFolder = l_trashFolderHash.value(l_mountPoint);
+#else
+        l_trashFolder = findTrashFolder(l_filePath);
+#endif
+        m_movieIdList.append(l_movie.id());
+        m_filePathList.append(l_filePath);
+        m_trashFolderList.append(l_trashFolder);
+    }
+}
+
+/**
+ * @brief Shows the progress and starts moving the files
+ */
+void TrashJob::start()
+{
+    m_progressDialog = new QProgressDialog(tr("Moving the movies to the trash..."),
+                                           tr("Cancel"),
+                                           0, m_movieIdList.size(),
+                                           m_dialogParent);
+    m_progressDialog->setWindowModality(Qt::WindowModal);
+    m_progressDialog->setMinimumDuration(500);
+    connect(this, SIGNAL(progressed(int)),
+            m_progressDialog, SLOT(setValue(int)));
+    connect(m_progressDialog, SIGNAL(canceled()),
+            this, SLOT(cancel()));
+    connect(this, SIGNAL(filesMoved()),
+            this, SLOT(on_filesMoved()));
+
+    QThreadPool::globalInstance()->start(this);
+}
+
+/**
+ * @brief Moves the files, until the job is canceled
+ */
+void TrashJob::run()
+{
+    for (int i = 0 ; i < m_movieIdList.size() ; i++) {
+        if (m_canceled.load() != 0) {
+            break;
+        }
+
+        QString l_filePath = m_filePathList.at(i);
+        if (!QFileInfo(l_filePath).exists()) {
+            Macaw::DEBUG("[TrashJob] File doesn't exist: " + l_filePath);
+            m_trashedIndexList.append(i);
+        } else if (moveFileToTrash(l_filePath, m_trashFolderList.at(i))) {
+            m_trashedIndexList.append(i);
+        } else {
+            m_failedIndexList.append(i);
+        }
+        emit progressed(i + 1);
+    }
+
+    emit filesMoved();
+}
+
+/**
+ * @brief Slot triggered when the progress dialog is canceled.
+ * The file being moved is finished, the next ones are kept.
+ */
+void TrashJob::cancel()
+{
+    m_canceled.store(1);
+}
+
+/**
+ * @brief Slot triggered in the GUI thread once the files are moved.
+ *
+ * 1. Ask once if the files which could not be moved must be deleted
+ * 2. Delete the movies whose file is gone, in one transaction
+ * 3. Delete the job
+ */
+void TrashJob::on_filesMoved()
+{
+    delete m_progressDialog;
+    m_progressDialog = 0;
+
+    QList<int> l_deletedIdList;
+    foreach (int l_index, m_trashedIndexList) {
+        l_deletedIdList.append(m_movieIdList.at(l_index));
+    }
+
+    if (!m_failedIndexList.isEmpty()) {
+        QStringList l_failedPathList;
+        foreach (int l_index, m_failedIndexList) {
+            l_failedPathList.append(m_filePathList.at(l_index));
+        }
+
+        QMessageBox l_msgBox(QMessageBox::Warning, tr("Error moving file to trash"),
+                             tr("%1 file(s) could not be moved to the trash. "
+                                "Do you want to permanently delete them instead?")
+                             .arg(m_failedIndexList.size()),
+                             QMessageBox::Yes|QMessageBox::No, m_dialogParent);
+        l_msgBox.setDetailedText(l_failedPathList.join("\n"));
+        l_msgBox.setDefaultButton(QMessageBox::No);
+
+        if (l_msgBox.exec() == QMessageBox::Yes) {
+            int l_errorCount = 0;
+            foreach (int l_index, m_failedIndexList) {
+                Macaw::DEBUG("[TrashJob] Permanently deleting file");
+                if (QFile::remove(m_filePathList.at(l_index))) {
+                    l_deletedIdList.append(m_movieIdList.at(l_index));
+                } else {
+                    l_errorCount++;
+                }
+            }
+            if (l_errorCount != 0) {
+                QMessageBox::critical(m_dialogParent, tr("Error deleting"),
+                                      tr("Error deleting %1 file(s).").arg(l_errorCount));
+            }
+        }
+    }
+
+    DatabaseManager *databaseManager = ServicesManager::instance()->databaseManager();
+    if (!l_deletedIdList.isEmpty() && !databaseManager->deleteMovies(l_deletedIdList)) {
+        QMessageBox::critical(m_dialogParent, tr("Error deleting"),
+                              tr("Error deleting the movies from the database."));
+    }
+
+    this->deleteLater();
+}
+
+/**
+ * @brief searches and returns the right trash folder for GNU/Linux and OSX platforms
+ *
+ * On GNU/Linux, MountPointResolver finds it as in the XDG trash specification.
+ * If an error occurred an empty string is returned (and a debug message is sent if debug is on).
+ *
+ * @param filePath the path to the movie's file to be moved to trash
+ * @return QString the right trash folder or an empty string on errors
+ */
+QString TrashJob::findTrashFolder(const QString filePath)
+{
+    if(filePath.left(1) != "/" || filePath.size() < 6)
+    {
+        Macaw::DEBUG("[TrashJob - findTrashFolder] The path to the movie is either too short or not an absolute one");
+        return "";
+    }
+
+#ifdef Q_OS_LINUX
+    return MountPointResolver::instance()->trashFolder(filePath);
+#endif
+#ifdef Q_OS_OSX
+    if(filePath.left(8) == "/Volumes") {
+        int l_volumeNameSize = filePath.indexOf("/", 9);
+        return filePath.left(l_volumeNameSize+1).append(".Trashes/");
+    }
+    return QDir::home().path().append(QDir::separator()).append(".Trash/");
+#endif
+    return "";
+}
+
+/**
+ * @brief Moves a file to the trash of the platform.
+ * Runs in the thread of the job: no dialog is shown.
+ *
+ * @param filePath the path to the movie's file
+ * @param trashFolder found by findTrashFolder()
+ * @return bool true if the file have been successfully moved to trash
+ */
+bool TrashJob::moveFileToTrash(const QString filePath, const QString trashFolder)
+{
+#ifdef Q_OS_LINUX
+    return linux_moveFileToTrash(filePath, trashFolder);
+#endif
+#ifdef Q_OS_WIN
+    return windows_moveFileToTrash(filePath);
+#endif
+#ifdef Q_OS_OSX
+    return macosx_moveFileToTrash(filePath, trashFolder);
+#endif
+    return false;
+}
+
+/**
+ * @brief Moves a movie file to trash bin for Linux.
+ *
+ * Moving a file to trash on GNU/Linux is made moving the file in a <trash folder>/files directory
+ * and creating and info file in <trash folder>/info
+ *
+ * @param filePath the path to the movie's file
+ * @param trashFolder the root folder of the trash
+ * @return bool true if the file have been successfully moved to trash
+ */
+bool TrashJob::linux_moveFileToTrash(const QString filePath, const QString trashFolder)
+{
+    if (trashFolder.isEmpty()) {
+
+        return false;
+    }
+
+    QDir l_dir;
+    QFileInfo l_movieFileInfo(filePath);
+    QString l_trashFilesPath(trashFolder + "/files/");    //folder to put the deleted file
+    QString l_trashInfoPath(trashFolder + "/info/");      //folder to put the info about deleted file
+
+    QString l_trashName = l_movieFileInfo.fileName();
+    QFileInfo l_targetMovieFileInfo(l_trashInfoPath + l_trashName + ".trashinfo");
+    QFileInfo l_targetMovieFileFiles(l_trashFilesPath + l_trashName);
+    int l_count = 0;
+    while(l_targetMovieFileInfo.exists() || l_targetMovieFileFiles.exists()) {
+        l_count++;
+
+        //Change the filename of "movie.suffix" to "movie(i).suffix"
+        l_trashName = (l_movieFileInfo.completeBaseName().isEmpty() ? "" : l_movieFileInfo.completeBaseName())
+                + '(' + QString::number(l_count) + ')' +
+                (l_movieFileInfo.suffix().isEmpty() ? "" : '.' + l_movieFileInfo.suffix());
+
+        l_targetMovieFileInfo = QFileInfo(l_trashInfoPath + l_trashName + ".trashinfo");
+        l_targetMovieFileFiles = QFileInfo(l_trashFilesPath + l_trashName);
+    }
+
+    QFile l_trashInfoFile(l_targetMovieFileInfo.absoluteFilePath());  //file containing the info about deleted file
+
+    Macaw::DEBUG("[TrashJob] Trash folder found here: " + trashFolder);
+    Macaw::DEBUG("[TrashJob] Trash name for the file: "+l_trashName);
+
+    if(!l_movieFileInfo.isFile()) {
+        Macaw::DEBUG("[TrashJob] Not a file, it cannot be deleted: " + filePath);
+        return false;
+    }
+
+    if(l_trashInfoFile.open(QIODevice::WriteOnly)) {
+        Macaw::DEBUG("[TrashJob] Moving file FROM: "+filePath+" TO: " + l_targetMovieFileFiles.absoluteFilePath());
+        bool moveFile = l_dir.rename(filePath, l_targetMovieFileFiles.absoluteFilePath());
+
+        if(moveFile) {
+            l_trashInfoFile.write("[Trash Info]\n");
+            QString l_path = "Path=" + filePath + '\n';
+            QString l_deletionDate = "DeletionDate=" + QDateTime::currentDateTime().toString(Qt::ISODate) + '\n';
+
+            l_trashInfoFile.write(l_path.toUtf8());
+            l_trashInfoFile.write(l_deletionDate.toUtf8());
+            l_trashInfoFile.close();
+
+            return true;
+        }
+        else {
+            Macaw::DEBUG("[TrashJob] Failled to move file to trash");
+            l_trashInfoFile.close();
+            l_trashInfoFile.remove();
+        }
+    }
+    else {
+        Macaw::DEBUG("[TrashJob] Failled to create and open the file's' trash info");
+    }
+
+    return false;
+}
+
+/**
+ * @brief Moves a movie file to trash bin for MS Windows.
+ *
+ * This function is highly inspired from one of the answers on Stackoverflow:
+ * http://stackoverflow.com/questions/17964439/move-files-to-trash-recycle-bin-in-qt
+ *
+ * @param filePath the path to the movie's file
+ * @return bool true if the file have been successfully moved to trash
+ */
+#ifdef Q_OS_WIN
+bool TrashJob::windows_moveFileToTrash(const QString filePath)
+{
+    QFileInfo fileinfo( filePath );
+
+    WCHAR from[ MAX_PATH ];
+    memset( from, 0, sizeof( from ));
+    int l = fileinfo.absoluteFilePath().toWCharArray( from );
+    Q_ASSERT( 0 <= l && l < MAX_PATH );
+    from[ l ] = '\0';
+    SHFILEOPSTRUCT fileop;
+    memset( &fileop, 0, sizeof( fileop ) );
+    fileop.wFunc = FO_DELETE;
+    fileop.pFrom = from;
+    fileop.fFlags = FOF_ALLOWUNDO | FOF_NOCONFIRMATION | FOF_NOERRORUI | FOF_SILENT;
+    int rv = SHFileOperation( &fileop );
+
+    if( rv != 0 ){
+        Macaw::DEBUG("[TrashJob] Moving file to trash failed with: " + QString::number(rv));
+        return false;
+    }
+
+    return true;
+}
+#else
+bool TrashJob::windows_moveFileToTrash(const QString filePath) {(void)filePath;return false;}
+#endif
+
+/**
+ * @brief Moves a movie file to trash bin for Mac OSX.
+ *
+ * Moving a file to trash on Mac OSX is made moving the file in <User's home>/.Trash directory
+ * This function do not allow to restore file as it do not uses the Apple API
+ *
+ * @param filePath the path to the movie's file
+ * @param trashFolder the trash folder
+ * @return bool true if the file have been successfully moved to trash
+ */
+bool TrashJob::macosx_moveFileToTrash(const QString filePath, const QString trashFolder)
+{
+    QDir l_dir;
+    QFileInfo l_movieFileInfo(filePath);
+
+    QString l_trashName = l_movieFileInfo.fileName();
+    QFileInfo l_targetMovieFileFiles(trashFolder + l_trashName);
+    int l_count = 0;
+    while(l_targetMovieFileFiles.exists()) {
+        l_count++;
+
+        //Change the filename of "movie.suffix" to "movie(i).suffix"
+        l_trashName = (l_movieFileInfo.completeBaseName().isEmpty() ? "" : l_movieFileInfo.completeBaseName())
+                + '(' + QString::number(l_count) + ')' +
+                (l_movieFileInfo.suffix().isEmpty() ? "" : '.' + l_movieFileInfo.suffix());
+
+        l_targetMovieFileFiles = QFileInfo(trashFolder + l_trashName);
+    }
+
+    Macaw::DEBUG("[TrashJob] Trash name for the file: "+l_trashName);
+
+    if(!l_movieFileInfo.isFile()) {
+        Macaw::DEBUG("[TrashJob] Not a file, it cannot be deleted: " + filePath);
+        return false;
+    }
+
+    Macaw::DEBUG("[TrashJob] Moving file FROM: "+filePath+" TO: " + l_targetMovieFileFiles.absoluteFilePath());
+    if(l_dir.rename(filePath, l_targetMovieFileFiles.absoluteFilePath())) {
+        return true;
+    }
+    Macaw::DEBUG("[TrashJob] Failled to move file to trash");
+
+    return false;
+}
@@ -0,0 +1,84 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRASHJOB_H
+#define TRASHJOB_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QObject>
+#include <QRunnable>
+#include <QStringList>
+
+class QProgressDialog;
+class QWidget;
+
+class Movie;
+
+/**
+ * @brief Moves the files of several movies to the trash, then deletes the movies.
+ *
+ * The trash folders are found in the GUI thread, the files are moved in a thread
+ * of the global QThreadPool while a QProgressDialog shows the progress,
+ * then the movies are removed from the database in one transaction.
+ * The files which could not be moved are reported together at the end.
+ *
+ * The job deletes itself once done.
+ */
+class TrashJob : public QObject, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    explicit TrashJob(const QList<Movie> &movieList, QWidget *dialogParent);
+    void start();
+    void run();
+
+signals:
+    void progressed(int movedCount);
+    void filesMoved();
+
+private slots:
+    void on_filesMoved();
+    void cancel();
+
+private:
+    QWidget *m_dialogParent;
+    QProgressDialog *m_progressDialog;
+    QAtomicInt m_canceled;
+    QList<int> m_movieIdList;
+    QStringList m_filePathList;
+    QStringList m_trashFolderList;
+
+    /**
+     * @brief Filled by run(): indexes in m_movieIdList of the movies whose
+     * file is in the trash (or was already gone), and of the failures
+     */
+    QList<int> m_trashedIndexList;
+    QList<int> m_failedIndexList;
+
+    static QString findTrashFolder(const QString filePath);
+    static bool moveFileToTrash(const QString filePath, const QString trashFolder);
+    static bool linux_moveFileToTrash(const QString filePath, const QString trashFolder);
+    static bool windows_moveFileToTrash(const QString filePath);
+    static bool macosx_moveFileToTrash(const QString filePath, const QString trashFolder);
+};
+
+#endif // TRASHJOB_H
@@ -25,14 +25,17 @@ namespace Macaw
     enum fields {
         ObjectId = Qt::UserRole,
         ObjectType = Qt::UserRole+1,
-        PeopleType = Qt::UserRole+2
+        PeopleType = Qt::UserRole+2,
+        PosterPath = Qt::UserRole+3,
+        SortKey = Qt::UserRole+4
     };
     enum typeElement {
         None,
         isMovie,
         isPeople,
         isTag,
-        isPlaylist
+        isPlaylist,
+        isMoviesPath
     };
     enum movieOrShow {
         movie = 0,
@@ -42,6 +45,28 @@ namespace Macaw
         hasMovies = 0b01,
         hasShows = 0b10
     };
+    enum fetchJobState {
+        FetchPending = 0,
+        FetchFailed = 1,
+        FetchReview = 2
+    };
+    enum fetchPriority {
+        FetchBackground = 0,
+        FetchVisible = 1,
+        FetchSelected = 2,
+        FetchUserRequested = 3
+    };
+    enum dirtyPannels {
+        DirtyLeftPannel = 0b001,
+        DirtyMainPannel = 0b010,
+        DirtyMetadataPannel = 0b100,
+        DirtyAllPannels = 0b111
+    };
+    enum changeType {
+        Inserted = 0,
+        Updated = 1,
+        Deleted = 2
+    };
 
 }
 
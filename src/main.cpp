@@ -57,6 +57,17 @@ int main(int argv, char **args)
     // --DEBUG option
     const QCommandLineOption l_debug(QStringList() << QStringLiteral("debug"), QApplication::tr("Define the debug mode"));
     l_parser.addOption(l_debug);
+    // --tmdb-url option
+    const QCommandLineOption l_tmdbUrl(QStringList() << QStringLiteral("tmdb-url"),
+                                       QApplication::tr("Use another server for the TMDb API (e.g. tools/tmdb-mock)"),
+                                       QStringLiteral("url"));
+    l_parser.addOption(l_tmdbUrl);
+    // --benchmark option
+    const QCommandLineOption l_benchmark(QStringList() << QStringLiteral("benchmark"),
+                                         QApplication::tr("Fetch the metadata of n movies in a temporary database, "
+                                                          "print the movies per minute and quit (see tools/fetch-bench)"),
+                                         QStringLiteral("n"));
+    l_parser.addOption(l_benchmark);
 
     /**
      * do the command line parsing
@@ -83,6 +94,19 @@ int main(int argv, char **args)
         Macaw::DEBUG("[Macaw-Movies] Debug starts here");
 #endif
     }
+    if (l_parser.isSet(l_tmdbUrl))
+    {
+        QString l_url = l_parser.value(l_tmdbUrl);
+        while (l_url.endsWith('/'))
+        {
+            l_url.chop(1);
+        }
+        l_app.setTmdbUrl(l_url);
+    }
+    if (l_parser.isSet(l_benchmark))
+    {
+        l_app.setBenchmarkSize(qMax(l_parser.value(l_benchmark).toInt(), 1));
+    }
 
     return l_app.exec();
 }
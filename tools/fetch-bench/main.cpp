@@ -0,0 +1,96 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QHostAddress>
+#include <QProcess>
+
+#include "TmdbMockServer.h"
+
+/**
+ * Benchmark of the metadata fetching: starts the TMDb stand-in server,
+ * then runs `macaw-movies --benchmark <n>` against it, which prints the
+ * number of movies fetched per minute.
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication l_app(argc, argv);
+    l_app.setApplicationName("fetch-bench");
+
+    QCommandLineParser l_parser;
+    l_parser.setApplicationDescription("Measures the throughput of the metadata fetching "
+                                       "of Macaw-Movies against a local TMDb stand-in");
+    l_parser.addHelpOption();
+
+    const QCommandLineOption l_movies(QStringList() << "movies",
+                                      "Number of movies to fetch (default: 200)", "n", "200");
+    l_parser.addOption(l_movies);
+    const QCommandLineOption l_appPath(QStringList() << "app",
+                                        "Path of macaw-movies (default: next to fetch-bench)", "path",
+                                        QDir(QCoreApplication::applicationDirPath()).filePath("macaw-movies"));
+    l_parser.addOption(l_appPath);
+    const QCommandLineOption l_fixtures(QStringList() << "fixtures",
+                                        "Folder of the recorded responses", "path", TMDB_MOCK_FIXTURES);
+    l_parser.addOption(l_fixtures);
+    const QCommandLineOption l_latency(QStringList() << "latency",
+                                       "Delay before each response, in ms", "ms", "0");
+    l_parser.addOption(l_latency);
+    const QCommandLineOption l_rateLimit(QStringList() << "rate-limit-every",
+                                         "Rate limit every n-th request (status_code 25)", "n", "0");
+    l_parser.addOption(l_rateLimit);
+    const QCommandLineOption l_error(QStringList() << "error-every",
+                                     "Fail every n-th request with a server error", "n", "0");
+    l_parser.addOption(l_error);
+
+    l_parser.process(l_app);
+
+    TmdbMockServer l_server(l_parser.value(l_fixtures));
+    l_server.setLatency(l_parser.value(l_latency).toInt());
+    l_server.setRateLimitEvery(l_parser.value(l_rateLimit).toInt());
+    l_server.setErrorEvery(l_parser.value(l_error).toInt());
+
+    // Any free port, so that several benchmarks can run at once
+    if (!l_server.listen(QHostAddress::LocalHost)) {
+        qCritical("Cannot listen: %s", qPrintable(l_server.errorString()));
+
+        return 1;
+    }
+
+    QProcess l_process;
+    l_process.setProcessChannelMode(QProcess::ForwardedChannels);
+    QObject::connect(&l_process, SIGNAL(finished(int)),
+                     &l_app, SLOT(quit()));
+    l_process.start(l_parser.value(l_appPath),
+                    QStringList() << "-platform" << "offscreen"
+                                  << "--tmdb-url" << QString("http://127.0.0.1:%1/3").arg(l_server.serverPort())
+                                  << "--benchmark" << l_parser.value(l_movies));
+    if (!l_process.waitForStarted()) {
+        qCritical("Cannot start %s: %s",
+                  qPrintable(l_parser.value(l_appPath)),
+                  qPrintable(l_process.errorString()));
+
+        return 1;
+    }
+    l_app.exec();
+
+    return l_process.exitCode();
+}
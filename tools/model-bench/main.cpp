@@ -0,0 +1,145 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QCoreApplication>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include <cstdlib>
+#include <new>
+
+#include "Entities/Movie.h"
+#include "Entities/People.h"
+#include "Entities/Tag.h"
+#include "MainWindowWidgets/MoviesTableModel.h"
+
+/**
+ * Benchmark of the copies of the entities during a refresh of the movies
+ * pannel: the movies are filtered as in MoviesPannel::fill(), then given
+ * to a MoviesTableModel. The calls to operator new are counted: the data
+ * of the entities and the nodes of the lists of entities are allocated
+ * with it, the buffers of QString and QList with malloc.
+ */
+
+static bool s_counting = false;
+static qint64 s_allocations = 0;
+
+void *operator new(std::size_t size)
+{
+    if (s_counting) {
+        s_allocations++;
+    }
+    void *l_pointer = std::malloc(size > 0 ? size : 1);
+    if (l_pointer == 0) {
+        throw std::bad_alloc();
+    }
+
+    return l_pointer;
+}
+
+void operator delete(void *pointer) Q_DECL_NOTHROW
+{
+    std::free(pointer);
+}
+
+/**
+ * @brief Movies as DatabaseManager hydrates them, with their people and tags
+ */
+static QList<Movie> hydratedMovies(const int size)
+{
+    QList<Movie> l_movieList;
+    for (int i = 1 ; i <= size ; i++) {
+        Movie l_movie;
+        l_movie.setId(i);
+        l_movie.setTitle("Movie " + QString::number(i));
+        l_movie.setOriginalTitle("Original movie " + QString::number(i));
+        l_movie.setReleaseDate(QDate(1950 + i % 70, 1 + i % 12, 1 + i % 28));
+        l_movie.setCountry("France");
+        l_movie.setSynopsis("Synopsis of the movie " + QString::number(i));
+        l_movie.setFileRelativePath("movies/movie-" + QString::number(i) + ".mkv");
+        l_movie.setFormat("Matroska");
+        l_movie.setSuffix("mkv");
+        for (int j = 0 ; j < 4 ; j++) {
+            People l_people("People " + QString::number((i + j) % 500));
+            l_people.setId((i + j) % 500 + 1);
+            l_people.setType(j == 0 ? People::Director : People::Actor);
+            l_movie.addPeople(l_people);
+        }
+        for (int j = 0 ; j < 2 ; j++) {
+            Tag l_tag("Tag " + QString::number((i + j) % 20));
+            l_tag.setId((i + j) % 20 + 1);
+            l_movie.addTag(l_tag);
+        }
+        l_movieList.append(l_movie);
+    }
+
+    return l_movieList;
+}
+
+/**
+ * @brief One refresh of the movies pannel, as in MoviesPannel::fill()
+ */
+static void refresh(MoviesTableModel &model, const QList<Movie> &movieList)
+{
+    QList<Movie> l_shownMovieList;
+    foreach (Movie l_movie, movieList) {
+        if (l_movie.id() % 10 != 0) {
+            l_shownMovieList.append(l_movie);
+        }
+    }
+    model.setMovies(l_shownMovieList);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication l_app(argc, argv);
+    l_app.setApplicationName("model-bench");
+
+    QStringList l_arguments = l_app.arguments();
+    int l_size = l_arguments.size() > 1 ? qMax(l_arguments.at(1).toInt(), 1) : 5000;
+    int l_refreshCount = l_arguments.size() > 2 ? qMax(l_arguments.at(2).toInt(), 1) : 20;
+
+    QList<Movie> l_movieList = hydratedMovies(l_size);
+    QTextStream l_out(stdout);
+    l_out << l_size << " movies, " << l_refreshCount << " refreshes" << endl;
+
+    // The first refresh resets the model, the next ones keep its rows
+    MoviesTableModel l_model;
+    for (int i = 0 ; i < 2 ; i++) {
+        int l_count = i == 0 ? 1 : l_refreshCount;
+        QElapsedTimer l_timer;
+        s_allocations = 0;
+        s_counting = true;
+        l_timer.start();
+        for (int j = 0 ; j < l_count ; j++) {
+            refresh(l_model, l_movieList);
+        }
+        qint64 l_elapsed = l_timer.nsecsElapsed();
+        s_counting = false;
+
+        l_out << (i == 0 ? "First fill: " : "Refresh:    ")
+              << s_allocations / l_count << " allocations, "
+              << QString::number(l_elapsed / 1000000.0 / l_count, 'f', 2) << " ms" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TmdbMockServer.h"
+
+#include <QFile>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QtDebug>
+
+/**
+ * @brief Constructor
+ *
+ * @param fixturesPath: folder containing the recorded responses
+ * @param parent
+ */
+TmdbMockServer::TmdbMockServer(const QString &fixturesPath, QObject *parent) :
+    QTcpServer(parent),
+    m_fixtures(fixturesPath)
+{
+    m_latency = 0;
+    m_rateLimitEvery = 0;
+    m_errorEvery = 0;
+    m_requestCount = 0;
+
+    connect(this, SIGNAL(newConnection()),
+            this, SLOT(on_newConnection()));
+}
+
+void TmdbMockServer::on_newConnection()
+{
+    while (this->hasPendingConnections()) {
+        QTcpSocket *l_socket = this->nextPendingConnection();
+        connect(l_socket, SIGNAL(readyRead()),
+                this, SLOT(on_readyRead()));
+        connect(l_socket, SIGNAL(disconnected()),
+                l_socket, SLOT(deleteLater()));
+    }
+}
+
+/**
+ * @brief Reads the request until its headers are complete, then answers
+ * after the configured latency
+ */
+void TmdbMockServer::on_readyRead()
+{
+    QTcpSocket *l_socket = qobject_cast<QTcpSocket *>(sender());
+    if (l_socket == NULL) {
+
+        return;
+    }
+
+    QByteArray l_request = l_socket->property("request").toByteArray() + l_socket->readAll();
+    l_socket->setProperty("request", l_request);
+    if (!l_request.contains("\r\n\r\n")) {
+
+        return;
+    }
+    l_socket->setProperty("request", QByteArray());
+
+    QByteArray l_requestLine = l_request.left(l_request.indexOf("\r\n"));
+    if (m_latency > 0) {
+        QTimer *l_timer = new QTimer(l_socket);
+        l_timer->setSingleShot(true);
+        l_timer->setProperty("requestLine", l_requestLine);
+        connect(l_timer, SIGNAL(timeout()),
+                this, SLOT(on_latencyElapsed()));
+        l_timer->start(m_latency);
+    } else {
+        this->respond(l_socket, l_requestLine);
+    }
+}
+
+/**
+ * @brief Answers a request once its latency elapsed
+ */
+void TmdbMockServer::on_latencyElapsed()
+{
+    QTimer *l_timer = qobject_cast<QTimer *>(sender());
+    QTcpSocket *l_socket = qobject_cast<QTcpSocket *>(l_timer->parent());
+
+    this->respond(l_socket, l_timer->property("requestLine").toByteArray());
+    l_timer->deleteLater();
+}
+
+/**
+ * @brief Routes a request like the TMDb API does
+ *
+ * @param socket of the client
+ * @param requestLine: e.g. "GET /3/movie/603?api_key=... HTTP/1.1"
+ */
+void TmdbMockServer::respond(QTcpSocket *socket, const QByteArray &requestLine)
+{
+    qDebug("%s", requestLine.constData());
+    QList<QByteArray> l_requestParts = requestLine.split(' ');
+    QUrl l_url("http://localhost" + QString::fromLatin1(l_requestParts.value(1)));
+    QString l_path = l_url.path();
+    QStringList l_pathParts = l_path.split('/', QString::SkipEmptyParts);
+
+    if (l_path.startsWith("/images/")) {
+        QFile l_poster(m_fixtures.filePath("poster.png"));
+        l_poster.open(QIODevice::ReadOnly);
+        this->send(socket, 200, "image/png", l_poster.readAll());
+
+        return;
+    }
+
+    m_requestCount++;
+    if (m_rateLimitEvery > 0 && m_requestCount % m_rateLimitEvery == 0) {
+        this->send(socket, 429, "application/json",
+                   "{\"status_code\":25,\"status_message\":\"Your request count is over the allowed limit of 40.\"}");
+
+        return;
+    }
+    if (m_errorEvery > 0 && m_requestCount % m_errorEvery == 0) {
+        this->send(socket, 500, "application/json",
+                   "{\"status_code\":11,\"status_message\":\"Internal error: Something went wrong, contact TMDb.\"}");
+
+        return;
+    }
+
+    QByteArray l_body;
+    if (l_pathParts.size() == 2 && l_pathParts.at(1) == "configuration") {
+        l_body = this->fixture("configuration", QString(), QString());
+    } else if (l_pathParts.size() == 3 && l_pathParts.at(1) == "search") {
+        QString l_query = QUrlQuery(l_url).queryItemValue("query", QUrl::FullyDecoded);
+        l_body = this->fixture("search", QString(), l_query);
+    } else if (l_pathParts.size() == 3 && l_pathParts.at(1) == "movie") {
+        l_body = this->fixture("movie", l_pathParts.at(2), QString());
+    } else if (l_pathParts.size() == 3 && l_pathParts.at(1) == "person") {
+        l_body = this->fixture("person", l_pathParts.at(2), QString());
+    }
+
+    if (l_body.isEmpty()) {
+        this->send(socket, 404, "application/json",
+                   "{\"status_code\":34,\"status_message\":\"The resource you requested could not be found.\"}");
+    } else {
+        this->send(socket, 200, "application/json", l_body);
+    }
+}
+
+/**
+ * @brief Reads a recorded response.
+ * `<name>/<id>.json` is used if it exists, else `<name>.json`.
+ * The placeholders {{id}}, {{query}}, {{query_id}} and {{base_url}} are replaced.
+ *
+ * @param name of the fixture
+ * @param id requested
+ * @param query searched
+ * @return the body, empty if there is no fixture
+ */
+QByteArray TmdbMockServer::fixture(const QString &name, const QString &id, const QString &query)
+{
+    QFile l_file(m_fixtures.filePath(name + '/' + id + ".json"));
+    if (id.isEmpty() || !l_file.exists()) {
+        l_file.setFileName(m_fixtures.filePath(name + ".json"));
+    }
+    if (!l_file.open(QIODevice::ReadOnly)) {
+
+        return QByteArray();
+    }
+
+    QString l_escapedQuery = query;
+    l_escapedQuery.replace('\\', "\\\\").replace('"', "\\\"");
+    QString l_body = QString::fromUtf8(l_file.readAll());
+    l_body.replace("{{id}}", id);
+    l_body.replace("{{query}}", l_escapedQuery);
+    // Each title gets its own movie
+    l_body.replace("{{query_id}}", QString::number(qHash(query) % 1000000 + 1));
+    l_body.replace("{{base_url}}", "http://127.0.0.1:" + QString::number(this->serverPort()) + "/images/");
+
+    return l_body.toUtf8();
+}
+
+/**
+ * @brief Sends the response and closes the connection
+ */
+void TmdbMockServer::send(QTcpSocket *socket, const int statusCode, const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray l_reason = statusCode == 200 ? "OK"
+                        : statusCode == 404 ? "Not Found"
+                        : statusCode == 429 ? "Too Many Requests"
+                        : "Internal Server Error";
+
+    socket->write("HTTP/1.1 " + QByteArray::number(statusCode) + ' ' + l_reason + "\r\n"
+                  "Content-Type: " + contentType + "\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n"
+                  "\r\n");
+    socket->write(body);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,76 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TMDBMOCKSERVER_H
+#define TMDBMOCKSERVER_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+/**
+ * @brief HTTP server answering like the TMDb API, from recorded fixtures.
+ *
+ * Serves `/3/configuration`, `/3/search/movie`, `/3/movie/<id>`,
+ * `/3/person/<id>` and the posters. The latency, the rate-limit responses
+ * (status_code 25) and the server errors can be injected, to check how the
+ * metadata fetching behaves and to measure its throughput.
+ */
+class TmdbMockServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit TmdbMockServer(const QString &fixturesPath, QObject *parent = 0);
+    void setLatency(const int latency) { m_latency = latency; }
+    void setRateLimitEvery(const int rateLimitEvery) { m_rateLimitEvery = rateLimitEvery; }
+    void setErrorEvery(const int errorEvery) { m_errorEvery = errorEvery; }
+
+private slots:
+    void on_newConnection();
+    void on_readyRead();
+    void on_latencyElapsed();
+
+private:
+    QDir m_fixtures;
+
+    /**
+     * @brief Delay before each response, in ms
+     */
+    int m_latency;
+
+    /**
+     * @brief Every n-th API request is rate limited, 0 to disable
+     */
+    int m_rateLimitEvery;
+
+    /**
+     * @brief Every n-th API request fails with a server error, 0 to disable
+     */
+    int m_errorEvery;
+    int m_requestCount;
+    void respond(QTcpSocket *socket, const QByteArray &requestLine);
+    QByteArray fixture(const QString &name, const QString &id, const QString &query);
+    void send(QTcpSocket *socket, const int statusCode, const QByteArray &contentType, const QByteArray &body);
+};
+
+#endif // TMDBMOCKSERVER_H
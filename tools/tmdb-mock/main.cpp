@@ -0,0 +1,70 @@
+/* Copyright (C) 2014 Macaw-Movies
+ * (Olivier CHURLAUD, Sébastien TOUZÉ)
+ *
+ * This file is part of Macaw-Movies.
+ *
+ * Macaw-Movies is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Macaw-Movies is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Macaw-Movies.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QHostAddress>
+
+#include "TmdbMockServer.h"
+
+int main(int argc, char **argv)
+{
+    QCoreApplication l_app(argc, argv);
+    l_app.setApplicationName("tmdb-mock");
+
+    QCommandLineParser l_parser;
+    l_parser.setApplicationDescription("Local stand-in for the TMDb API. "
+                                       "Start Macaw-Movies with --tmdb-url http://127.0.0.1:<port>/3");
+    l_parser.addHelpOption();
+
+    const QCommandLineOption l_port(QStringList() << "port",
+                                    "Port to listen on (default: 8765)", "port", "8765");
+    l_parser.addOption(l_port);
+    const QCommandLineOption l_fixtures(QStringList() << "fixtures",
+                                        "Folder of the recorded responses", "path", TMDB_MOCK_FIXTURES);
+    l_parser.addOption(l_fixtures);
+    const QCommandLineOption l_latency(QStringList() << "latency",
+                                       "Delay before each response, in ms", "ms", "0");
+    l_parser.addOption(l_latency);
+    const QCommandLineOption l_rateLimit(QStringList() << "rate-limit-every",
+                                         "Rate limit every n-th request (status_code 25)", "n", "0");
+    l_parser.addOption(l_rateLimit);
+    const QCommandLineOption l_error(QStringList() << "error-every",
+                                     "Fail every n-th request with a server error", "n", "0");
+    l_parser.addOption(l_error);
+
+    l_parser.process(l_app);
+
+    TmdbMockServer l_server(l_parser.value(l_fixtures));
+    l_server.setLatency(l_parser.value(l_latency).toInt());
+    l_server.setRateLimitEvery(l_parser.value(l_rateLimit).toInt());
+    l_server.setErrorEvery(l_parser.value(l_error).toInt());
+
+    if (!l_server.listen(QHostAddress::LocalHost, l_parser.value(l_port).toUShort())) {
+        qCritical("Cannot listen on port %s: %s",
+                  qPrintable(l_parser.value(l_port)),
+                  qPrintable(l_server.errorString()));
+
+        return 1;
+    }
+    qDebug("Listening on http://127.0.0.1:%d/3", l_server.serverPort());
+
+    return l_app.exec();
+}